@@ -0,0 +1,269 @@
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <random>
+#include <vector>
+
+#include "app/collision_detector.h"
+#include "app/player/players.h"
+#include "app/use_cases/game_tick_use_case.h"
+#include "app/use_cases/get_memory_report_use_case.h"
+#include "bench_world.h"
+#include "loots/loot_generator.h"
+
+namespace {
+
+using namespace std::literals;
+
+constexpr int CITY_BLOCKS = 32;
+constexpr auto TICK_PERIOD = 50ms;
+
+std::vector<app::Player::Pointer> FindPlayers(const bench::World& world) {
+    std::vector<app::Player::Pointer> players;
+    players.reserve(world.tokens.size());
+    for (const auto& token : world.tokens) {
+        players.push_back(world.players->Find(token));
+    }
+    return players;
+}
+
+// One tick of movement for range(0) dogs. Directions rotate every
+// iteration, so dogs keep moving instead of resting at road ends.
+void BM_PlayerMove(benchmark::State& state) {
+    static constexpr std::array DIRECTIONS = {
+        model::Direction::NORTH, model::Direction::EAST,
+        model::Direction::SOUTH, model::Direction::WEST};
+
+    const auto world =
+        bench::MakeWorld(CITY_BLOCKS, static_cast<size_t>(state.range(0)));
+    const auto players = FindPlayers(world);
+    auto buffer = std::make_unique<std::byte[]>(64 * 1024);
+
+    size_t turn = 0;
+    for (auto _ : state) {
+        std::pmr::monotonic_buffer_resource arena(buffer.get(), 64 * 1024);
+        for (size_t i = 0; i < players.size(); ++i) {
+            players[i]->SetDirection(
+                DIRECTIONS[(i + turn) % DIRECTIONS.size()]);
+            auto movement = players[i]->Move(TICK_PERIOD, &arena);
+            benchmark::DoNotOptimize(movement);
+        }
+        ++turn;
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// range(0) gatherers moving one tick along the roads against range(1)
+// items lying on them
+void BM_FindGatherEvents(benchmark::State& state) {
+    const auto map = bench::MakeGridMap(CITY_BLOCKS);
+    const auto gatherers_count = static_cast<size_t>(state.range(0));
+    const auto items_count = static_cast<size_t>(state.range(1));
+    const auto points =
+        bench::MakeRoadPoints(*map, gatherers_count + items_count);
+
+    ItemGatherer::Gatherers gatherers;
+    for (size_t i = 0; i < gatherers_count; ++i) {
+        const auto start = points[i];
+        const double step = bench::DOG_SPEED * 0.05;
+        gatherers.push_back({.start_pos = start,
+                             .end_pos = i % 2 == 0
+                                            ? model::Coordinate{start.x + step,
+                                                                start.y}
+                                            : model::Coordinate{start.x,
+                                                                start.y + step},
+                             .width = app::Player::WIDTH / 2});
+    }
+    ItemGatherer::Items items;
+    for (size_t i = 0; i < items_count; ++i) {
+        items.push_back(
+            {.position = points[gatherers_count + i], .width = 0.0});
+    }
+    const ItemGatherer provider{items, gatherers};
+
+    size_t events = 0;
+    for (auto _ : state) {
+        auto result = collision_detector::FindGatherEvents(provider);
+        events = result.size();
+        benchmark::DoNotOptimize(result.data());
+    }
+    state.SetItemsProcessed(state.iterations() * gatherers_count *
+                            items_count);
+    state.counters["events"] = static_cast<double>(events);
+}
+
+// Dogs of a world, to add to new Players containers
+struct Dogs {
+    bench::World world;
+    std::vector<model::Dog::Pointer> dogs;
+
+    explicit Dogs(size_t count) : world(bench::MakeWorld(CITY_BLOCKS, 0)) {
+        const auto points = bench::MakeRoadPoints(*world.session->GetMap(),
+                                                  count);
+        for (const auto& point : points) {
+            dogs.push_back(
+                world.session->AddDog(point, "dog", bench::DOG_SPEED));
+        }
+    }
+
+    std::unique_ptr<app::Players> MakePlayers() const {
+        auto players = std::make_unique<app::Players>();
+        players->Reseed(bench::SEED);
+        for (auto dog : dogs) {
+            players->Add(world.session, dog);
+        }
+        return players;
+    }
+};
+
+// Containers are created and destroyed outside the timed region, token
+// generation is part of Add
+void BM_PlayersAdd(benchmark::State& state) {
+    const Dogs dogs(static_cast<size_t>(state.range(0)));
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto players = std::make_unique<app::Players>();
+        players->Reseed(bench::SEED);
+        state.ResumeTiming();
+
+        for (auto dog : dogs.dogs) {
+            benchmark::DoNotOptimize(players->Add(dogs.world.session, dog));
+        }
+
+        state.PauseTiming();
+        players.reset();
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void BM_PlayersFindByToken(benchmark::State& state) {
+    const auto world =
+        bench::MakeWorld(CITY_BLOCKS, static_cast<size_t>(state.range(0)));
+    std::vector<app::Token> tokens = world.tokens;
+    std::shuffle(tokens.begin(), tokens.end(), std::mt19937_64{bench::SEED});
+
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(
+            world.players->Find(tokens[i++ % tokens.size()]));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+void BM_PlayersFindBySession(benchmark::State& state) {
+    const auto world =
+        bench::MakeWorld(CITY_BLOCKS, static_cast<size_t>(state.range(0)));
+    std::vector<app::PlayerSession> sessions;
+    for (const auto& dog : world.session->GetDogs()) {
+        sessions.push_back({dog.GetId(), world.session->GetMapHandle()});
+    }
+    std::shuffle(sessions.begin(), sessions.end(),
+                 std::mt19937_64{bench::SEED});
+
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(
+            world.players->Find(sessions[i++ % sessions.size()]));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+// Every player of a full container is removed in random order
+void BM_PlayersRemove(benchmark::State& state) {
+    const Dogs dogs(static_cast<size_t>(state.range(0)));
+    std::vector<app::Player::Id> ids;
+    for (auto dog : dogs.dogs) {
+        ids.push_back(dog->GetId());
+    }
+    std::shuffle(ids.begin(), ids.end(), std::mt19937_64{bench::SEED});
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto players = dogs.MakePlayers();
+        state.ResumeTiming();
+
+        for (auto id : ids) {
+            players->Remove(id);
+        }
+
+        state.PauseTiming();
+        players.reset();
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// The configured generator, with a random source behind a std::function
+void BM_LootGeneratorGenerate(benchmark::State& state) {
+    std::mt19937_64 engine{bench::SEED};
+    std::uniform_real_distribution<double> distribution(0.0, 1.0);
+    loot_gen::LootGenerator generator(
+        5s, 0.5, 0ms, [&] { return distribution(engine); });
+    const auto looters = static_cast<unsigned>(state.range(0));
+
+    unsigned loot = 0;
+    for (auto _ : state) {
+        loot += generator.Generate(TICK_PERIOD, loot, looters);
+        if (loot >= looters) {
+            loot = 0;
+        }
+        benchmark::DoNotOptimize(loot);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+// The generator a game session ticks, with the engine called inline
+void BM_SessionLootGeneratorGenerate(benchmark::State& state) {
+    loot_gen::SessionLootGenerator generator(
+        5s, 0.5, 0ms, loot_gen::EngineRandom{bench::SEED, 0.0, 1.0});
+    const auto looters = static_cast<unsigned>(state.range(0));
+
+    unsigned loot = 0;
+    for (auto _ : state) {
+        loot += generator.Generate(TICK_PERIOD, loot, looters);
+        if (loot >= looters) {
+            loot = 0;
+        }
+        benchmark::DoNotOptimize(loot);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+// Not a speed measure: walks the memory report of a world of players with
+// full bags and reports what one player holds as the bytes_per_player
+// counter
+void BM_MemoryPerPlayer(benchmark::State& state) {
+    const auto world = bench::MakeWorld(
+        CITY_BLOCKS, static_cast<size_t>(state.range(0)), /*bag_size=*/3);
+    const GetMemoryReportUseCase use_case(world.game, world.players);
+
+    MemoryReport report;
+    for (auto _ : state) {
+        report = use_case.GetReport();
+        benchmark::DoNotOptimize(report.total_bytes);
+    }
+    state.counters["bytes_per_player"] =
+        static_cast<double>(report.bytes_per_player);
+    state.counters["total_bytes"] = static_cast<double>(report.total_bytes);
+}
+
+}  // namespace
+
+BENCHMARK(BM_PlayerMove)->Arg(100)->Arg(1000)->Arg(10000);
+BENCHMARK(BM_FindGatherEvents)
+    ->Args({10, 10})
+    ->Args({100, 100})
+    ->Args({1000, 1000});
+BENCHMARK(BM_PlayersAdd)->Arg(1000)->Arg(10000)->Arg(100000);
+BENCHMARK(BM_PlayersFindByToken)->Arg(1000)->Arg(10000)->Arg(100000);
+BENCHMARK(BM_PlayersFindBySession)->Arg(1000)->Arg(10000)->Arg(100000);
+BENCHMARK(BM_PlayersRemove)->Arg(1000)->Arg(10000);
+BENCHMARK(BM_LootGeneratorGenerate)->Arg(10)->Arg(1000);
+BENCHMARK(BM_SessionLootGeneratorGenerate)->Arg(10)->Arg(1000);
+BENCHMARK(BM_MemoryPerPlayer)->Arg(1000)->Arg(100000);
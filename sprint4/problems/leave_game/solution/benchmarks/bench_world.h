@@ -0,0 +1,180 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <boost/json.hpp>
+
+#include "app/application.h"
+#include "app/game/game.h"
+#include "app/game/game_session_handler.h"
+#include "app/player/players.h"
+#include "app/use_cases/get_game_state_use_case.h"
+#include "loots/loot_generator.h"
+#include "loots/loot_handler.h"
+#include "loots/loot_number_map_handler.h"
+#include "model/map.h"
+
+// Synthetic worlds for the benchmarks. Everything is built from a seed, so
+// two runs, also of different commits, measure the same work.
+namespace bench {
+
+inline constexpr int BLOCK_SIZE = 40;
+inline constexpr int LOOT_TYPES = 3;
+inline constexpr double DOG_SPEED = 3.0;
+inline constexpr std::uint64_t SEED = 42;
+
+// A square city of blocks x blocks blocks with a road along every block
+// edge and an office at every other crossroad in both directions
+inline model::Map::Pointer MakeGridMap(int blocks,
+                                       std::string id = "bench_map") {
+    const int size = blocks * BLOCK_SIZE;
+    model::Map::Roads roads;
+    model::Map::Offices offices;
+    for (int i = 0; i <= blocks; ++i) {
+        const int line = i * BLOCK_SIZE;
+        roads.push_back(std::make_shared<model::Road>(
+            model::Road::HORIZONTAL, model::Point{0, line}, size));
+        roads.push_back(std::make_shared<model::Road>(
+            model::Road::VERTICAL, model::Point{line, 0}, size));
+    }
+    for (int i = 0; i <= blocks; i += 2) {
+        for (int j = 0; j <= blocks; j += 2) {
+            offices.emplace_back(
+                model::Office::Id{"o" + std::to_string(i) + "_" +
+                                  std::to_string(j)},
+                model::Point{i * BLOCK_SIZE, j * BLOCK_SIZE},
+                model::Offset{1, 1});
+        }
+    }
+    // The config loader stores the highest loot type, not their number
+    return std::make_shared<model::Map>(model::Map::Id{std::move(id)},
+                                        "Bench map", std::move(roads),
+                                        model::Map::Buildings{},
+                                        std::move(offices), DOG_SPEED,
+                                        LOOT_TYPES - 1);
+}
+
+// Uniformly spread points on the roads of map
+inline std::vector<model::Coordinate> MakeRoadPoints(const model::Map& map,
+                                                     size_t count) {
+    std::mt19937_64 engine{SEED};
+    std::uniform_int_distribution<std::uint64_t> index(
+        0, map.GetRoadPointsCount() - 1);
+    std::uniform_real_distribution<double> shift(-0.4, 0.4);
+    std::vector<model::Coordinate> points;
+    points.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        const auto point = map.GetRoadPoint(index(engine));
+        points.push_back({point.x + shift(engine), point.y + shift(engine)});
+    }
+    return points;
+}
+
+// One session of one grid map with dogs players spread over its roads,
+// each with bag_size items in the bag
+struct World {
+    app::Game::Pointer game;
+    app::GameSession::Pointer session;
+    app::Players::Pointer players;
+    std::vector<app::Token> tokens;
+};
+
+inline World MakeWorld(int blocks, size_t dogs, size_t bag_size = 0) {
+    World world;
+    auto map = MakeGridMap(blocks);
+    world.game = std::make_shared<app::Game>(
+        app::Game::Maps{map}, DOG_SPEED,
+        std::make_shared<app::GameSessionHandler>());
+    world.session = world.game->CreateGameSession(map->GetId());
+    world.players = std::make_shared<app::Players>();
+    world.players->Reseed(SEED);
+    world.tokens.reserve(dogs);
+
+    std::uint32_t item_id = 0;
+    for (const auto& point : MakeRoadPoints(*map, dogs)) {
+        auto dog = world.session->AddDog(
+            point, "dog_" + std::to_string(world.tokens.size()), DOG_SPEED);
+        for (size_t i = 0; i < bag_size; ++i) {
+            dog->AddItem({.id = model::Item::Id{item_id++},
+                          .type = static_cast<int>(i % LOOT_TYPES),
+                          .position = point,
+                          .value = 10});
+        }
+        world.tokens.push_back(world.players->Add(world.session, dog).second);
+    }
+    return world;
+}
+
+// A whole application over a grid map, dogs joined through JoinGame
+inline app::Application::Pointer MakeApplication(int blocks, size_t dogs) {
+    using namespace std::literals;
+
+    auto map = MakeGridMap(blocks);
+    const auto map_id = map->GetId();
+    auto game = std::make_shared<app::Game>(
+        app::Game::Maps{map}, DOG_SPEED,
+        std::make_shared<app::GameSessionHandler>());
+    auto loot_handler = std::make_shared<LootHandler>(
+        LootHandler::LootTypeByMap{
+            {map_id, boost::json::array{"key", "wallet", "phone"}}},
+        LootHandler::LootTypeScoreByMap{{map_id, {10, 20, 30}}});
+    auto loot_number_map_handler = std::make_shared<LootNumberMapHandler>(
+        LootNumberMapHandler::LootNumberByMap{}, static_cast<int>(dogs));
+
+    auto application = std::make_shared<app::Application>(
+        std::make_shared<app::Players>(), game,
+        std::make_shared<loot_gen::LootGenerator>(5s, 0.5, 0ms),
+        loot_handler, loot_number_map_handler, true, nullptr);
+    for (size_t i = 0; i < dogs; ++i) {
+        application->JoinGame(map_id, "dog_" + std::to_string(i));
+    }
+    // Loot on the map and in bags, so the snapshot holds every kind of
+    // state
+    for (int tick = 0; tick < 20; ++tick) {
+        application->Tick(100ms);
+    }
+    return application;
+}
+
+// A game state as GetGameState returns it, players carry bag_size items
+inline GameState MakeGameState(size_t players, size_t lost_objects,
+                               size_t bag_size = 3) {
+    std::mt19937_64 engine{SEED};
+    std::uniform_real_distribution<double> coord(0.0, 1000.0);
+    const auto random_point = [&] {
+        return model::Coordinate{coord(engine), coord(engine)};
+    };
+
+    GameState state;
+    state.player_coord_infos.reserve(players);
+    for (size_t i = 0; i < players; ++i) {
+        std::vector<model::Item> items;
+        for (size_t j = 0; j < bag_size; ++j) {
+            items.push_back({.id = model::Item::Id{static_cast<std::uint32_t>(
+                                 i * bag_size + j)},
+                             .type = static_cast<int>(j % LOOT_TYPES)});
+        }
+        state.player_coord_infos.push_back(
+            {.id = app::Player::Id{static_cast<std::uint32_t>(i)},
+             .position = random_point(),
+             .velocity = {DOG_SPEED, 0.0},
+             .direction = model::Direction::EAST,
+             .items = std::move(items),
+             .score = static_cast<int>(i)});
+    }
+    state.lost_objects.reserve(lost_objects);
+    for (size_t i = 0; i < lost_objects; ++i) {
+        state.lost_objects.push_back(
+            {.id = model::Item::Id{static_cast<std::uint32_t>(i)},
+             .type = static_cast<int>(i % LOOT_TYPES),
+             .position = random_point()});
+    }
+    return state;
+}
+
+}  // namespace bench
@@ -0,0 +1,11 @@
+#include <benchmark/benchmark.h>
+
+// Microbenchmarks of the model, the game and the serialization code, at
+// several scales each. Results for comparing commits are written with
+//
+//   game_server_benchmarks --benchmark_out=results.json
+//                          --benchmark_out_format=json
+//
+// and two such files are diffed by tools/compare.py of Google Benchmark.
+// --benchmark_filter=<regex> runs a part of the suite.
+BENCHMARK_MAIN();
@@ -0,0 +1,35 @@
+#include <benchmark/benchmark.h>
+
+#include <array>
+#include <cstddef>
+#include <memory_resource>
+
+#include "bench_world.h"
+#include "model/roads_handler.h"
+
+namespace {
+
+constexpr size_t POINTS_COUNT = 4096;
+
+// range(0) is the number of blocks along a side of the city
+void BM_FindRoads(benchmark::State& state) {
+    const auto map = bench::MakeGridMap(static_cast<int>(state.range(0)));
+    const model::RoadsHandler roads_handler{map->GetRoads()};
+    const auto points = bench::MakeRoadPoints(*map, POINTS_COUNT);
+    std::array<std::byte, 1024> buffer;
+
+    size_t i = 0;
+    for (auto _ : state) {
+        std::pmr::monotonic_buffer_resource arena(buffer.data(),
+                                                  buffer.size());
+        auto roads =
+            roads_handler.FindRoads(points[i++ % POINTS_COUNT], &arena);
+        benchmark::DoNotOptimize(roads.data());
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.counters["roads"] = static_cast<double>(map->GetRoads().size());
+}
+
+}  // namespace
+
+BENCHMARK(BM_FindRoads)->Arg(4)->Arg(32)->Arg(256);
@@ -0,0 +1,106 @@
+#include <benchmark/benchmark.h>
+
+#include <sstream>
+#include <string>
+
+#include <boost/archive/text_iarchive.hpp>
+#include <boost/archive/text_oarchive.hpp>
+#include <boost/json.hpp>
+
+#include "bench_world.h"
+#include "json_converter.h"
+#include "serialization/application_serialization.h"
+#include "utils/cbor_writer.h"
+#include "utils/json_writer.h"
+
+namespace {
+
+constexpr int CITY_BLOCKS = 32;
+
+// range(0) players with a bag of 3 items each and range(1) lost objects
+GameState MakeState(const benchmark::State& state) {
+    return bench::MakeGameState(static_cast<size_t>(state.range(0)),
+                                static_cast<size_t>(state.range(1)));
+}
+
+// The DOM path, as the state was answered before responses were streamed
+void BM_GameStateToJson(benchmark::State& state) {
+    const auto game_state = MakeState(state);
+    size_t bytes = 0;
+    for (auto _ : state) {
+        auto body =
+            boost::json::serialize(json_converter::GameStateToJson(game_state));
+        bytes = body.size();
+        benchmark::DoNotOptimize(body.data());
+    }
+    state.SetBytesProcessed(state.iterations() * bytes);
+    state.counters["body_bytes"] = static_cast<double>(bytes);
+}
+
+template <typename Writer>
+void BM_WriteGameState(benchmark::State& state) {
+    const auto game_state = MakeState(state);
+    size_t bytes = 0;
+    for (auto _ : state) {
+        auto body = json_converter::Serialize<Writer>(
+            json_converter::WriteGameState, game_state);
+        bytes = body.size();
+        benchmark::DoNotOptimize(body.data());
+    }
+    state.SetBytesProcessed(state.iterations() * bytes);
+    state.counters["body_bytes"] = static_cast<double>(bytes);
+}
+
+std::string SaveSnapshot(const app::Application& application) {
+    std::stringstream stream;
+    serialization::ApplicationRepr repr(application);
+    boost::archive::text_oarchive archive{stream};
+    archive << repr;
+    return stream.str();
+}
+
+// Snapshots go to memory, the numbers leave out the disk
+void BM_SnapshotSave(benchmark::State& state) {
+    const auto application =
+        bench::MakeApplication(CITY_BLOCKS, static_cast<size_t>(state.range(0)));
+    size_t bytes = 0;
+    for (auto _ : state) {
+        auto snapshot = SaveSnapshot(*application);
+        bytes = snapshot.size();
+        benchmark::DoNotOptimize(snapshot.data());
+    }
+    state.SetBytesProcessed(state.iterations() * bytes);
+    state.counters["snapshot_bytes"] = static_cast<double>(bytes);
+}
+
+// Reads the archive and rebuilds the application from it
+void BM_SnapshotLoad(benchmark::State& state) {
+    const auto snapshot = SaveSnapshot(
+        *bench::MakeApplication(CITY_BLOCKS,
+                                static_cast<size_t>(state.range(0))));
+    for (auto _ : state) {
+        std::istringstream stream{snapshot};
+        boost::archive::text_iarchive archive{stream};
+        serialization::ApplicationRepr repr;
+        archive >> repr;
+        auto application = repr.Restore();
+        benchmark::DoNotOptimize(application.get());
+    }
+    state.SetBytesProcessed(state.iterations() * snapshot.size());
+    state.counters["snapshot_bytes"] = static_cast<double>(snapshot.size());
+}
+
+}  // namespace
+
+BENCHMARK(BM_GameStateToJson)->Args({10, 10})->Args({100, 100})->Args(
+    {1000, 1000});
+BENCHMARK_TEMPLATE(BM_WriteGameState, utils::JsonWriter)
+    ->Args({10, 10})
+    ->Args({100, 100})
+    ->Args({1000, 1000});
+BENCHMARK_TEMPLATE(BM_WriteGameState, utils::CborWriter)
+    ->Args({10, 10})
+    ->Args({100, 100})
+    ->Args({1000, 1000});
+BENCHMARK(BM_SnapshotSave)->Arg(100)->Arg(1000)->Arg(10000);
+BENCHMARK(BM_SnapshotLoad)->Arg(100)->Arg(1000)->Arg(10000);
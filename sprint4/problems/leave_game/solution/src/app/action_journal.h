@@ -0,0 +1,45 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "app/token.h"
+#include "model/map.h"
+#include "model/model.h"
+
+namespace app {
+
+// Random state that the application snapshot does not keep. Restoring it
+// on top of the snapshot makes the journaled actions replay exactly.
+struct JournalCheckpoint {
+    // Generation of the snapshot the journal continues, a journal of
+    // another generation must not be replayed on it
+    std::uint64_t generation = 0;
+    std::uint64_t seed = 0;
+    // Time without loot of every game session, in session order
+    std::vector<std::chrono::milliseconds> loot_timers;
+};
+
+// Receives every state-changing action after the application applied it.
+// Calls come from the API strand.
+class ActionJournal {
+   public:
+    using Pointer = std::shared_ptr<ActionJournal>;
+
+    virtual ~ActionJournal() = default;
+
+    virtual void Checkpoint(const JournalCheckpoint& checkpoint) = 0;
+
+    virtual void Join(const model::Map::Id& map_id, const std::string& name,
+                      const Token& token) = 0;
+
+    virtual void Move(const Token& token, model::Direction direction) = 0;
+
+    virtual void Tick(std::chrono::milliseconds delta,
+                      std::uint32_t retired_players) = 0;
+};
+
+}  // namespace app
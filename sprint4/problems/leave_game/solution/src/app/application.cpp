@@ -1,5 +1,10 @@
 #include "application.h"
 
+#include <random>
+#include <utility>
+
+#include "utils/profiler.h"
+
 namespace app {
 Application::Application(Players::Pointer players, Game::Pointer game,
                          loot_gen::LootGenerator::Pointer loot_generator,
@@ -18,10 +23,13 @@ Application::Application(Players::Pointer players, Game::Pointer game,
       get_map_use_case_(game_, loot_handler_),
       list_player_use_case_(players_),
       get_game_state_use_case_(players_),
-      move_player_use_case_(players_),
+      move_player_use_case_(players_, players_->GetTokenIndex()),
       game_tick_use_case_(game_, players_, loot_generator_, loot_handler_,
                           loot_number_map_handler_, factory),
-      get_game_records_use_case_(factory) {}
+      get_game_records_use_case_(factory),
+      reload_config_use_case_(game_, loot_handler_,
+                              loot_number_map_handler_),
+      get_memory_report_use_case_(game_, players_) {}
 
 Game::Maps Application::ListMaps() const {
     return list_map_use_case_.GetMaps();
@@ -33,27 +41,95 @@ GetMapResult Application::GetMap(const model::Map::Id& map_id) const {
 
 JoinGameResult Application::JoinGame(model::Map::Id map_id,
                                      const std::string& user_name) {
-    return join_game_use_case_.Join(map_id, user_name);
+    auto result = join_game_use_case_.Join(map_id, user_name);
+    if (journal_) {
+        journal_->Join(map_id, user_name, result.token);
+    }
+    return result;
 }
 
 ListPlayerResult Application::ListPlayers(const app::Token token) const {
     return list_player_use_case_.GetPlayers(token);
 }
 
-GameState Application::GetGameState(const app::Token token) const {
-    return get_game_state_use_case_.GetGameState(token);
+GameState Application::GetGameState(const app::Token token,
+                                    const GameStateFilter& filter) const {
+    return get_game_state_use_case_.GetGameState(token, filter);
 }
 
 void Application::MovePlayer(const app::Token token,
                              const model::Direction direction) {
-    return move_player_use_case_.MovePlayer(token, direction);
+    if (queue_moves_) {
+        // Journaled once applied
+        return move_player_use_case_.QueueMove(token, direction);
+    }
+    move_player_use_case_.MovePlayer(token, direction);
+    if (journal_) {
+        journal_->Move(token, direction);
+    }
 }
 
 void Application::Tick(std::chrono::milliseconds delta_time) {
+    PROFILE_SCOPE("Application::Tick");
+    move_player_use_case_.ApplyQueuedMoves(
+        game_->GetGameSessions(),
+        [this](TokenKey token, model::Direction direction) {
+            if (journal_) {
+                journal_->Move(token::ToToken(token), direction);
+            }
+        });
     game_tick_use_case_.Tick(delta_time);
+    if (journal_) {
+        journal_->Tick(delta_time, GetLastTickRetiredCount());
+    }
+    PROFILE_SCOPE("Application::TickSignal");
     tick_signal_(delta_time);
 }
 
+void Application::SetJournal(ActionJournal::Pointer journal) {
+    journal_ = std::move(journal);
+}
+
+JournalCheckpoint Application::MakeCheckpoint(std::uint64_t seed) {
+    JournalCheckpoint checkpoint{.generation = snapshot_generation_,
+                                 .seed = seed,
+                                 .loot_timers =
+                                     game_tick_use_case_.GetLootTimers()};
+    Reseed(checkpoint.seed, checkpoint.loot_timers);
+    return checkpoint;
+}
+
+void Application::RestoreCheckpoint(const JournalCheckpoint& checkpoint) {
+    Reseed(checkpoint.seed, checkpoint.loot_timers);
+}
+
+void Application::Reseed(
+    std::uint64_t seed,
+    const std::vector<std::chrono::milliseconds>& loot_timers) {
+    // Every generator gets its own stream derived from the one seed
+    std::mt19937_64 seeds{seed};
+    players_->Reseed(seeds());
+    join_game_use_case_.Reseed(seeds());
+    game_tick_use_case_.ResetRandomState(seeds(), loot_timers);
+}
+
+void Application::SetWriteRetiredPlayers(bool write_retired) {
+    game_tick_use_case_.SetWriteRetired(write_retired);
+}
+
+std::uint32_t Application::GetLastTickRetiredCount() const {
+    return static_cast<std::uint32_t>(
+        game_tick_use_case_.GetLastTickStats().retired_players);
+}
+
+MapsReloadResult Application::ReloadConfig(
+    Game::Maps maps, const LootHandler& loot_handler,
+    const LootNumberMapHandler& loot_number_map_handler) {
+    PROFILE_SCOPE("Application::ReloadConfig");
+    return reload_config_use_case_.Reload(std::move(maps), loot_handler,
+                                          loot_number_map_handler);
+}
+
 boost::signals2::connection Application::DoOnTick(
     const TickSignal::slot_type& handler) {
     return tick_signal_.connect(handler);
@@ -62,4 +138,13 @@ boost::signals2::connection Application::DoOnTick(
 std::vector<GameRecord> Application::GetGameRecords(int start, int max_items) {
     return get_game_records_use_case_.GetGameRecords(start, max_items);
 }
+
+GameRecordsPage Application::GetGameRecordsPage(std::string_view cursor,
+                                                int max_items) {
+    return get_game_records_use_case_.GetGameRecordsPage(cursor, max_items);
+}
+
+MemoryReport Application::GetMemoryReport() const {
+    return get_memory_report_use_case_.GetReport();
+}
 }  // namespace app
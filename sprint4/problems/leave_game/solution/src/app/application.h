@@ -1,21 +1,25 @@
 #pragma once
 
 #include <chrono>
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <vector>
 
 #include <boost/signals2.hpp>
 
+#include "app/action_journal.h"
 #include "app/game/game.h"
 #include "app/use_cases/game_tick_use_case.h"
 #include "app/use_cases/get_game_records_use_case.h"
 #include "app/use_cases/get_game_state_use_case.h"
 #include "app/use_cases/get_map_use_case.h"
+#include "app/use_cases/get_memory_report_use_case.h"
 #include "app/use_cases/join_game_use_case.h"
 #include "app/use_cases/list_map_use_case.h"
 #include "app/use_cases/list_player_use_case.h"
 #include "app/use_cases/move_player.h"
+#include "app/use_cases/reload_config_use_case.h"
 #include "loots/loot_generator.h"
 #include "loots/loot_handler.h"
 #include "loots/loot_number_map_handler.h"
@@ -50,16 +54,54 @@ class Application {
 
     ListPlayerResult ListPlayers(const app::Token token) const;
 
-    GameState GetGameState(const app::Token token) const;
+    GameState GetGameState(const app::Token token,
+                           const GameStateFilter& filter = {}) const;
 
+    // With queued moves this only checks the token and may be called from
+    // any thread, the move is applied at the start of the next tick
     void MovePlayer(const app::Token token, const model::Direction direction);
 
+    // Must be set before requests are served
+    void SetQueueMoves(bool queue_moves) { queue_moves_ = queue_moves; }
+    bool AreMovesQueued() const noexcept { return queue_moves_; }
+
     void Tick(std::chrono::milliseconds delta_time);
 
+    // Joins, moves and ticks are reported to journal once applied
+    void SetJournal(ActionJournal::Pointer journal);
+
+    // Reseeds every random source from seed. The returned checkpoint
+    // together with a snapshot taken now reproduces the following actions.
+    JournalCheckpoint MakeCheckpoint(std::uint64_t seed);
+
+    void RestoreCheckpoint(const JournalCheckpoint& checkpoint);
+
+    // Every snapshot gets a new generation, saved with it and written to
+    // the checkpoint that starts the journal after it
+    std::uint64_t GetSnapshotGeneration() const noexcept {
+        return snapshot_generation_;
+    }
+    void AdvanceSnapshotGeneration() noexcept { ++snapshot_generation_; }
+
+    // Retired players are not written to the database while this is off
+    void SetWriteRetiredPlayers(bool write_retired);
+
+    std::uint32_t GetLastTickRetiredCount() const;
+
+    // Must be called on the API strand
+    MapsReloadResult ReloadConfig(
+        Game::Maps maps, const LootHandler& loot_handler,
+        const LootNumberMapHandler& loot_number_map_handler);
+
     [[nodiscard]] boost::signals2::connection DoOnTick(
         const TickSignal::slot_type& handler);
 
     std::vector<GameRecord> GetGameRecords(int start, int max_items);
+    GameRecordsPage GetGameRecordsPage(std::string_view cursor,
+                                       int max_items);
+
+    // Walks every session and player, must be called on the API strand
+    MemoryReport GetMemoryReport() const;
 
    private:
     Players::Pointer players_;
@@ -68,6 +110,8 @@ class Application {
     LootHandler::Pointer loot_handler_;
     LootNumberMapHandler::Pointer loot_number_map_handler_;
     bool is_random_spawn_point_;
+    bool queue_moves_ = false;
+    std::uint64_t snapshot_generation_ = 0;
 
     JoinGameUseCase join_game_use_case_;
     ListMapUseCase list_map_use_case_;
@@ -77,8 +121,14 @@ class Application {
     MovePlayerUseCase move_player_use_case_;
     GameTickUseCase game_tick_use_case_;
     GetGameRecordsUseCase get_game_records_use_case_;
+    ReloadConfigUseCase reload_config_use_case_;
+    GetMemoryReportUseCase get_memory_report_use_case_;
 
     TickSignal tick_signal_;
+    ActionJournal::Pointer journal_;
+
+    void Reseed(std::uint64_t seed,
+                const std::vector<std::chrono::milliseconds>& loot_timers);
 };
 
 }  // namespace app
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <tuple>
+#include <vector>
+
+#include "app/token.h"
+#include "model/dog.h"
+#include "model/model.h"
+#include "utils/mpsc_queue.h"
+
+namespace app {
+
+// A move request that passed validation and waits for the next tick
+struct PendingAction {
+    model::Dog::Id player;
+    TokenKey token;
+    model::Direction direction;
+    std::uint64_t seq;
+};
+
+// Move requests of one game session. Any thread may push, the tick drains
+// the inbox on the API strand before moving the dogs.
+class ActionInbox {
+   public:
+    using Pointer = std::shared_ptr<ActionInbox>;
+
+    // Lock-free apart from the node allocation, see utils::MpscQueue
+    void Push(model::Dog::Id player, TokenKey token,
+              model::Direction direction) {
+        queue_.Push(PendingAction{
+            player, token, direction,
+            next_seq_.fetch_add(1, std::memory_order_relaxed)});
+    }
+
+    // Calls apply with the newest action of every player that pushed one
+    // since the last drain, in the order those actions were pushed. Must
+    // not be called concurrently with itself.
+    template <typename Fn>
+    void Drain(Fn&& apply) {
+        batch_.clear();
+        while (auto action = queue_.Pop()) {
+            batch_.push_back(*action);
+        }
+        // Last writer wins: keep the highest seq of each player. Producers
+        // take seq before pushing, so the queue order may differ from it.
+        std::sort(batch_.begin(), batch_.end(),
+                  [](const PendingAction& lhs, const PendingAction& rhs) {
+                      return std::tie(*lhs.player, lhs.seq) <
+                             std::tie(*rhs.player, rhs.seq);
+                  });
+        auto newest = std::unique(
+            batch_.rbegin(), batch_.rend(),
+            [](const PendingAction& lhs, const PendingAction& rhs) {
+                return lhs.player == rhs.player;
+            });
+        batch_.erase(batch_.begin(), newest.base());
+        std::sort(batch_.begin(), batch_.end(),
+                  [](const PendingAction& lhs, const PendingAction& rhs) {
+                      return lhs.seq < rhs.seq;
+                  });
+        for (const auto& action : batch_) {
+            apply(action);
+        }
+    }
+
+   private:
+    utils::MpscQueue<PendingAction> queue_;
+    std::atomic<std::uint64_t> next_seq_{0};
+    // Reused between drains
+    std::vector<PendingAction> batch_;
+};
+
+}  // namespace app
@@ -9,17 +9,57 @@ Game::Game(Maps maps, double default_dog_speed,
            GameSessionHandler::Pointer handler,
            std::chrono::milliseconds dog_retirement_time)
     : maps_(std::move(maps)),
+      map_index_(IndexMaps(maps_)),
       game_session_handler_(handler),
       default_dog_speed_(default_dog_speed),
-      dog_retirement_time_(dog_retirement_time) {
-    for (size_t i = 0; i < maps_.size(); ++i) {
-        map_id_to_index_[maps_[i]->GetId()] = i;
+      dog_retirement_time_(dog_retirement_time) {}
+
+Game::MapIndexByHandle Game::IndexMaps(const Maps& maps) {
+    MapIndexByHandle map_index(model::Map::GetHandles().GetSize(), NO_MAP);
+    for (size_t i = 0; i < maps.size(); ++i) {
+        map_index[*maps[i]->GetHandle()] = i;
+    }
+    return map_index;
+}
+
+MapsReloadResult Game::ReplaceMaps(Maps maps) {
+    MapsReloadResult result;
+    for (auto& map : maps) {
+        const auto old_map = FindMap(map->GetHandle());
+        if (!old_map) {
+            ++result.added;
+        } else if (old_map->HasSameLayout(*map)) {
+            map = old_map;
+        } else {
+            ++result.changed;
+        }
     }
+    result.removed = maps_.size() + result.added - maps.size();
+
+    auto map_index = IndexMaps(maps);
+    for (const auto& session : game_session_handler_->GetGameSessions()) {
+        const auto index = map_index[*session->GetMapHandle()];
+        if (index != NO_MAP && maps[index] != session->GetMap()) {
+            session->MoveToMap(maps[index]);
+            ++result.migrated_sessions;
+        }
+    }
+
+    maps_ = std::move(maps);
+    map_index_ = std::move(map_index);
+    return result;
 }
 
 const model::Map::Pointer Game::FindMap(const Map::Id& id) const noexcept {
-    if (auto it = map_id_to_index_.find(id); it != map_id_to_index_.end()) {
-        return maps_.at(it->second);
+    if (auto handle = Map::FindHandle(id)) {
+        return FindMap(*handle);
+    }
+    return nullptr;
+}
+
+const model::Map::Pointer Game::FindMap(Map::Handle map) const noexcept {
+    if (*map < map_index_.size() && map_index_[*map] != NO_MAP) {
+        return maps_[map_index_[*map]];
     }
     return nullptr;
 }
@@ -28,6 +68,10 @@ GameSession::Pointer Game::FindGameSession(const Map::Id& map_id) {
     return game_session_handler_->FindGameSession(map_id);
 }
 
+GameSession::Pointer Game::FindGameSession(Map::Handle map) {
+    return game_session_handler_->FindGameSession(map);
+}
+
 GameSession::Pointer Game::CreateGameSession(const Map::Id& map_id) {
     auto map = FindMap(map_id);
     if (!map) {
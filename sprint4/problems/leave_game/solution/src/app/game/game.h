@@ -1,10 +1,11 @@
 #pragma once
 
 #include <chrono>
+#include <cstdint>
 #include <deque>
 #include <memory>
 #include <ratio>
-#include <unordered_map>
+#include <vector>
 
 #include "app/game/game_session_handler.h"
 
@@ -23,6 +24,13 @@ static constexpr std::chrono::milliseconds DEFAULT_DOG_RETIREMENT_TIME =
     60000ms;
 }  // namespace detail
 
+struct MapsReloadResult {
+    size_t added = 0;
+    size_t changed = 0;
+    size_t removed = 0;
+    size_t migrated_sessions = 0;
+};
+
 class Game {
    public:
     friend class serialization::GameRepr;
@@ -42,22 +50,39 @@ class Game {
 
     virtual const Map::Pointer FindMap(const Map::Id& id) const noexcept;
 
+    const Map::Pointer FindMap(Map::Handle map) const noexcept;
+
     GameSessionPointer CreateGameSession(const Map::Id& map_id);
 
     virtual GameSessionPointer FindGameSession(const Map::Id& map_id);
 
+    virtual GameSessionPointer FindGameSession(Map::Handle map);
+
+    virtual const std::vector<GameSessionPointer>& GetGameSessions()
+        const noexcept {
+        return game_session_handler_->GetGameSessions();
+    }
+
     double GetDefaultDogSpeed() const noexcept { return default_dog_speed_; }
 
     std::chrono::milliseconds GetDogRetirementTime() const noexcept {
         return dog_retirement_time_;
     }
 
+    // Swaps in maps from a reloaded config. Unchanged maps keep their old
+    // instances, sessions of changed maps move to the new geometry. Sessions
+    // of removed maps keep running on the old map, but nobody can join them.
+    MapsReloadResult ReplaceMaps(Maps maps);
+
    private:
-    using MapIdHasher = util::TaggedHasher<Map::Id>;
-    using MapIdToIndex = std::unordered_map<Map::Id, size_t, MapIdHasher>;
+    // Index in maps_ by map handle, NO_MAP for maps not in the config
+    using MapIndexByHandle = std::vector<size_t>;
+    static constexpr size_t NO_MAP = SIZE_MAX;
+
+    static MapIndexByHandle IndexMaps(const Maps& maps);
 
     Maps maps_;
-    MapIdToIndex map_id_to_index_;
+    MapIndexByHandle map_index_;
     GameSessionHandler::Pointer game_session_handler_;
     double default_dog_speed_;
     std::chrono::milliseconds dog_retirement_time_;
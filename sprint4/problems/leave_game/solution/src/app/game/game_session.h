@@ -1,15 +1,20 @@
 #pragma once
 
+#include <algorithm>
 #include <deque>
+#include <iterator>
 #include <memory>
 #include <stdexcept>
 #include <string>
 #include <utility>
 #include <vector>
 
+#include "app/game/action_inbox.h"
+#include "app/game/spatial_grid.h"
 #include "model/dog.h"
 #include "model/item.h"
 #include "model/map.h"
+#include "utils/memory_usage.h"
 
 namespace serialization {
 class GameSessionRepr;
@@ -30,19 +35,29 @@ class GameSession {
 
     model::Dog::Pointer AddDog(model::Coordinate spawn_point, std::string name,
                                double max_speed) {
-        return &dogs_.emplace_back(dogs_.size(), name, max_speed, spawn_point);
+        InvalidateSpatialIndex();
+        return &dogs_.emplace_back(next_dog_id_++, name, max_speed,
+                                   spawn_point);
     }
 
-    std::optional<model::Dog> RemoveDog(model::Dog::Id id) {
-        if (auto dog_it = std::find_if(
-                dogs_.begin(), dogs_.end(),
-                [id](model::Dog& dog) { return dog.GetId() == id; });
-            dog_it != dogs_.end()) {
-            model::Dog dog = std::move(*dog_it);
-            dogs_.erase(dog_it);
-            return dog;
+    // The last dog takes the place of the removed one, so pointers to the
+    // other dogs stay valid. Returns the dog that moved, if any, pointers
+    // to its old place are not.
+    model::Dog::Pointer RemoveDog(model::Dog::Id id) {
+        auto dog_it = std::find_if(
+            dogs_.begin(), dogs_.end(),
+            [id](const model::Dog& dog) { return dog.GetId() == id; });
+        if (dog_it == dogs_.end()) {
+            return nullptr;
         }
-        return std::nullopt;
+        InvalidateSpatialIndex();
+        if (auto last = std::prev(dogs_.end()); dog_it != last) {
+            *dog_it = std::move(*last);
+            dogs_.pop_back();
+            return &*dog_it;
+        }
+        dogs_.pop_back();
+        return nullptr;
     }
 
     void AddLoot(int type, model::Coordinate pos, int score) {
@@ -54,6 +69,11 @@ class GameSession {
         }
         loot_positions_.emplace_back(model::Item::Id{item_last_id_++}, type,
                                      pos, score);
+        InvalidateSpatialIndex();
+    }
+
+    void ReserveLoot(size_t count) {
+        loot_positions_.reserve(loot_positions_.size() + count);
     }
 
     std::optional<model::Item> RemoveLoot(model::Item::Id id) {
@@ -61,13 +81,10 @@ class GameSession {
                 loot_positions_.begin(), loot_positions_.end(),
                 [id](const model::Item& item) { return item.id == id; });
             item_it != loot_positions_.end()) {
-            model::Item copy_item{
-                .id = item_it->id,
-                .type = item_it->type,
-                .position = item_it->position,
-            };
+            model::Item item = *item_it;
             loot_positions_.erase(item_it);
-            return copy_item;
+            InvalidateSpatialIndex();
+            return item;
         }
         return std::nullopt;
     }
@@ -76,18 +93,102 @@ class GameSession {
         return loot_positions_;
     }
 
+    // Puts the session on a new version of its map. Dogs and loot that are
+    // off the new roads move to the nearest road, loot of types the map no
+    // longer has is dropped.
+    void MoveToMap(model::Map::Pointer map) {
+        map_ = std::move(map);
+        for (auto& dog : dogs_) {
+            dog.SetPosition(map_->ClampToNearestRoad(dog.GetPosition()));
+        }
+        std::erase_if(loot_positions_, [this](const model::Item& item) {
+            return item.type > map_->GetNumberOfLootTypes();
+        });
+        for (auto& item : loot_positions_) {
+            item.position = map_->ClampToNearestRoad(item.position);
+        }
+        InvalidateSpatialIndex();
+    }
+
+    // Dogs and loot inside area, in session order. The index behind it is
+    // built on the first query after a change, so at most once per tick.
+    std::vector<const model::Dog*> FindDogsIn(const AreaOfInterest& area) {
+        UpdateSpatialIndex();
+        std::vector<const model::Dog*> result;
+        for (auto index : dogs_grid_.Query(area)) {
+            result.push_back(&dogs_[index]);
+        }
+        return result;
+    }
+
+    std::vector<const model::Item*> FindLootIn(const AreaOfInterest& area) {
+        UpdateSpatialIndex();
+        std::vector<const model::Item*> result;
+        for (auto index : loot_grid_.Query(area)) {
+            result.push_back(&loot_positions_[index]);
+        }
+        return result;
+    }
+
+    // Dogs move without the session knowing, the tick calls this after
+    void InvalidateSpatialIndex() noexcept { is_spatial_index_valid_ = false; }
+
     int GetLootNumber() const noexcept { return loot_positions_.size(); }
     const model::Map::Pointer GetMap() const { return map_; }
     const model::Map::Id GetMapId() const { return map_->GetId(); }
+    model::Map::Handle GetMapHandle() const noexcept {
+        return map_->GetHandle();
+    }
     const std::deque<model::Dog>& GetDogs() const { return dogs_; }
     std::uint32_t GetLastItemId() const { return item_last_id_; }
+    const ActionInbox::Pointer& GetActionInbox() const { return inbox_; }
+
+    // Dogs with their bags
+    utils::MemoryUsage GetDogsMemory() const noexcept {
+        utils::MemoryUsage usage{.count = dogs_.size(),
+                                 .bytes = utils::memory::HeapBytes(dogs_)};
+        for (const auto& dog : dogs_) {
+            usage.bytes += dog.GetHeapBytes();
+        }
+        return usage;
+    }
+
+    utils::MemoryUsage GetLootMemory() const noexcept {
+        return {.count = loot_positions_.size(),
+                .bytes = utils::memory::HeapBytes(loot_positions_)};
+    }
+
+    // The session itself and its spatial indexes
+    size_t GetOwnMemoryBytes() const noexcept {
+        return sizeof(*this) + dogs_grid_.GetHeapBytes() +
+               loot_grid_.GetHeapBytes();
+    }
 
    private:
     std::uint32_t item_last_id_ = 0;
+    // Ids of removed dogs are not handed out again
+    std::uint32_t next_dog_id_ = 0;
 
-    const model::Map::Pointer map_;
+    model::Map::Pointer map_;
     std::deque<model::Dog> dogs_;
     LootPositionsVector loot_positions_;
+    ActionInbox::Pointer inbox_ = std::make_shared<ActionInbox>();
+
+    void UpdateSpatialIndex() {
+        if (is_spatial_index_valid_) {
+            return;
+        }
+        dogs_grid_.Build(dogs_, [](const model::Dog& dog) {
+            return dog.GetPosition();
+        });
+        loot_grid_.Build(loot_positions_,
+                         [](const model::Item& item) { return item.position; });
+        is_spatial_index_valid_ = true;
+    }
+
+    SpatialGrid dogs_grid_;
+    SpatialGrid loot_grid_;
+    bool is_spatial_index_valid_ = false;
 };
 
 }  // namespace app
@@ -1,24 +1,40 @@
 #include "game_session_handler.h"
 
+#include <utility>
+
 namespace app {
 
 const GameSession::Pointer GameSessionHandler::FindGameSession(
     const model::Map::Id& map_id) const {
-    if (auto it = map_id_to_game_session_.find(map_id);
-        it != map_id_to_game_session_.end()) {
+    if (auto handle = model::Map::FindHandle(map_id)) {
+        return FindGameSession(*handle);
+    }
+    return nullptr;
+}
+
+const GameSession::Pointer GameSessionHandler::FindGameSession(
+    model::Map::Handle map) const {
+    if (*map < map_sessions_.size() && !map_sessions_[*map].empty()) {
         // TODO: find the game session with the least amount of players
-        return it->second[0];
+        return map_sessions_[*map][0];
     }
     return nullptr;
 }
 
 const GameSession::Pointer GameSessionHandler::CreateGameSession(
     const model::Map::Pointer map) {
-    GameSession new_session(map);
-    auto game_session_ptr =
-        game_sessions_.emplace_back(std::make_shared<app::GameSession>(map));
-    map_id_to_game_session_[map->GetId()].push_back(game_session_ptr);
+    auto game_session_ptr = std::make_shared<app::GameSession>(map);
+    AddGameSession(game_session_ptr);
     return game_session_ptr;
 }
 
+void GameSessionHandler::AddGameSession(GameSession::Pointer session) {
+    const auto map = *session->GetMapHandle();
+    if (map >= map_sessions_.size()) {
+        map_sessions_.resize(map + 1);
+    }
+    map_sessions_[map].push_back(session);
+    game_sessions_.push_back(std::move(session));
+}
+
 }  // namespace app
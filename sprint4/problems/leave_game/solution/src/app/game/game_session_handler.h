@@ -1,7 +1,6 @@
 #pragma once
 
 #include <memory>
-#include <unordered_map>
 #include <vector>
 
 #include "app/game/game_session.h"
@@ -26,15 +25,20 @@ class GameSessionHandler {
     const GameSession::Pointer FindGameSession(
         const model::Map::Id& map_id) const;
 
+    const GameSession::Pointer FindGameSession(model::Map::Handle map) const;
+
     const GameSession::Pointer CreateGameSession(const model::Map::Pointer map);
 
-   private:
-    using MapIdToGameSession =
-        std::unordered_map<model::Map::Id, std::vector<GameSession::Pointer>,
-                           util::TaggedHasher<model::Map::Id>>;
+    const std::vector<GameSession::Pointer>& GetGameSessions() const noexcept {
+        return game_sessions_;
+    }
 
+   private:
     std::vector<GameSession::Pointer> game_sessions_;
-    MapIdToGameSession map_id_to_game_session_;
+    // Sessions of each map, indexed by map handle
+    std::vector<std::vector<GameSession::Pointer>> map_sessions_;
+
+    void AddGameSession(GameSession::Pointer session);
 };
 
 }  // namespace app
@@ -0,0 +1,173 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "model/model.h"
+#include "utils/memory_usage.h"
+
+namespace app {
+
+// Part of the map a client looks at: a rectangle, or a circle when radius
+// is set, min and max bound it then
+struct AreaOfInterest {
+    model::Coordinate min;
+    model::Coordinate max;
+    std::optional<double> radius;
+
+    static AreaOfInterest Around(model::Coordinate center, double radius) {
+        return {{center.x - radius, center.y - radius},
+                {center.x + radius, center.y + radius},
+                radius};
+    }
+
+    static AreaOfInterest Viewport(model::Coordinate a, model::Coordinate b) {
+        return {{std::min(a.x, b.x), std::min(a.y, b.y)},
+                {std::max(a.x, b.x), std::max(a.y, b.y)},
+                std::nullopt};
+    }
+
+    bool Contains(model::Coordinate point) const {
+        if (point.x < min.x || point.x > max.x || point.y < min.y ||
+            point.y > max.y) {
+            return false;
+        }
+        if (!radius) {
+            return true;
+        }
+        const double dx = point.x - (min.x + max.x) / 2;
+        const double dy = point.y - (min.y + max.y) / 2;
+        return dx * dx + dy * dy <= *radius * *radius;
+    }
+};
+
+// Uniform grid over a snapshot of positions. Points are counting-sorted by
+// cell into one array, so a query reads the cells under its area and
+// touches only the points in them. Storage is kept between builds.
+class SpatialGrid {
+   public:
+    using Index = std::uint32_t;
+
+    static constexpr double DEFAULT_CELL_SIZE = 10.0;
+    // Cells grow past the configured size rather than exceed this
+    static constexpr size_t MAX_CELLS = 1 << 16;
+
+    explicit SpatialGrid(double cell_size = DEFAULT_CELL_SIZE)
+        : base_cell_size_(cell_size) {}
+
+    // position(entity) gives the point of each entity, query results are
+    // their indexes in entities
+    template <typename Range, typename Position>
+    void Build(const Range& entities, Position&& position) {
+        positions_.clear();
+        for (const auto& entity : entities) {
+            positions_.push_back(position(entity));
+        }
+        if (positions_.empty()) {
+            cell_start_.assign(1, 0);
+            cols_ = rows_ = 0;
+            return;
+        }
+
+        origin_ = max_ = positions_.front();
+        for (const auto& point : positions_) {
+            origin_.x = std::min(origin_.x, point.x);
+            origin_.y = std::min(origin_.y, point.y);
+            max_.x = std::max(max_.x, point.x);
+            max_.y = std::max(max_.y, point.y);
+        }
+        cell_size_ = base_cell_size_;
+        while (true) {
+            cols_ = CellSpan(max_.x - origin_.x);
+            rows_ = CellSpan(max_.y - origin_.y);
+            if (cols_ * rows_ <= MAX_CELLS) {
+                break;
+            }
+            cell_size_ *= 2;
+        }
+
+        cell_start_.assign(cols_ * rows_ + 1, 0);
+        for (const auto& point : positions_) {
+            ++cell_start_[CellOf(point) + 1];
+        }
+        for (size_t i = 1; i < cell_start_.size(); ++i) {
+            cell_start_[i] += cell_start_[i - 1];
+        }
+        cursor_.assign(cell_start_.begin(), cell_start_.end() - 1);
+        indexes_.resize(positions_.size());
+        for (Index i = 0; i < positions_.size(); ++i) {
+            indexes_[cursor_[CellOf(positions_[i])]++] = i;
+        }
+    }
+
+    // Indexes of the points inside area, ascending
+    std::vector<Index> Query(const AreaOfInterest& area) const {
+        std::vector<Index> result;
+        if (positions_.empty() || area.max.x < origin_.x ||
+            area.max.y < origin_.y || area.min.x > max_.x ||
+            area.min.y > max_.y) {
+            return result;
+        }
+
+        const size_t col_begin = ClampedCell(area.min.x - origin_.x, cols_);
+        const size_t col_end = ClampedCell(area.max.x - origin_.x, cols_);
+        const size_t row_begin = ClampedCell(area.min.y - origin_.y, rows_);
+        const size_t row_end = ClampedCell(area.max.y - origin_.y, rows_);
+        for (size_t row = row_begin; row <= row_end; ++row) {
+            // Cells of a row are adjacent, so the row span is one range
+            const size_t first = cell_start_[row * cols_ + col_begin];
+            const size_t last = cell_start_[row * cols_ + col_end + 1];
+            for (size_t i = first; i < last; ++i) {
+                if (area.Contains(positions_[indexes_[i]])) {
+                    result.push_back(indexes_[i]);
+                }
+            }
+        }
+        std::sort(result.begin(), result.end());
+        return result;
+    }
+
+    size_t GetSize() const noexcept { return positions_.size(); }
+
+    size_t GetHeapBytes() const noexcept {
+        return utils::memory::HeapBytes(positions_) +
+               utils::memory::HeapBytes(cell_start_) +
+               utils::memory::HeapBytes(cursor_) +
+               utils::memory::HeapBytes(indexes_);
+    }
+
+   private:
+    size_t CellSpan(double extent) const {
+        return static_cast<size_t>(extent / cell_size_) + 1;
+    }
+
+    size_t ClampedCell(double offset, size_t count) const {
+        if (offset <= 0) {
+            return 0;
+        }
+        return std::min(static_cast<size_t>(offset / cell_size_), count - 1);
+    }
+
+    size_t CellOf(model::Coordinate point) const {
+        return ClampedCell(point.y - origin_.y, rows_) * cols_ +
+               ClampedCell(point.x - origin_.x, cols_);
+    }
+
+    double base_cell_size_;
+    double cell_size_ = DEFAULT_CELL_SIZE;
+    model::Coordinate origin_{0.0, 0.0};
+    model::Coordinate max_{0.0, 0.0};
+    size_t cols_ = 0;
+    size_t rows_ = 0;
+    std::vector<model::Coordinate> positions_;
+    // Points of cell c are indexes_[cell_start_[c]..cell_start_[c + 1])
+    std::vector<size_t> cell_start_;
+    std::vector<size_t> cursor_;
+    std::vector<Index> indexes_;
+};
+
+}  // namespace app
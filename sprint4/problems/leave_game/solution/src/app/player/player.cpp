@@ -6,7 +6,8 @@
 
 namespace app {
 
-MovementInfo Player::Move(std::chrono::milliseconds delta_time) {
+MovementInfo Player::Move(std::chrono::milliseconds delta_time,
+                          std::pmr::memory_resource* resource) {
     using namespace std::chrono_literals;
     dog_->SetTimeInGame(dog_->GetTimeInGame() + delta_time);
 
@@ -19,9 +20,9 @@ MovementInfo Player::Move(std::chrono::milliseconds delta_time) {
     auto velocity = dog_->GetVelocity();
     auto position = dog_->GetPosition();
 
-    auto delta = delta_time.count() / 1000;
+    auto delta = std::chrono::duration<double>(delta_time).count();
     auto new_position = position + velocity * delta;
-    auto roads = session_->GetMap()->FindRoads(position);
+    auto roads = session_->GetMap()->FindRoads(position, resource);
 
     if (roads.empty()) {
         return MovementInfo{.start_position = dog_->GetPosition(),
@@ -36,16 +37,17 @@ MovementInfo Player::Move(std::chrono::milliseconds delta_time) {
                         }
                         return false;
                     })) {
-        return MovementInfo{.start_position = dog_->GetPosition(),
+        return MovementInfo{.start_position = position,
                             .end_position = new_position};
     }
-    return MoveToBorder(new_position, roads);
+    return MoveToBorder(new_position, roads, resource);
 }
 
 MovementInfo Player::MoveToBorder(
     const model::Coordinate& new_position,
-    const std::vector<model::Road::Pointer>& roads) {
-    std::vector<model::Coordinate> candidates;
+    const std::pmr::vector<model::Road::Pointer>& roads,
+    std::pmr::memory_resource* resource) {
+    std::pmr::vector<model::Coordinate> candidates(resource);
     candidates.reserve(roads.size());
 
     for (const auto& road : roads) {
@@ -91,8 +93,9 @@ MovementInfo Player::MoveToBorder(
             break;
     }
 
+    auto start_position = dog_->GetPosition();
     dog_->SetPosition(final_pos);
-    return MovementInfo{.start_position = dog_->GetPosition(),
+    return MovementInfo{.start_position = start_position,
                         .end_position = final_pos};
 }
 
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <chrono>
+#include <memory_resource>
 #include <vector>
 
 #include "app/game/game_session.h"
@@ -24,7 +25,9 @@ class Player {
 
     using Pointer = Player*;
     using ConstPointer = const Player*;
-    using GameSessionPointer = GameSession::Pointer;
+    // Not owning, a game keeps every session it creates until it is
+    // destroyed
+    using GameSessionPointer = GameSession*;
 
     static constexpr double WIDTH = 0.6;
 
@@ -34,16 +37,21 @@ class Player {
     GameSessionPointer GetSession() const { return session_; }
     Id GetId() const { return dog_->GetId(); }
     model::Dog::ConstPointer GetDog() const { return dog_; }
+    // The session moved the dog, see GameSession::RemoveDog
+    void SetDog(model::Dog::Pointer dog) noexcept { dog_ = dog; }
 
     void SetDirection(model::Direction direction) {
         dog_->SetDirection(direction);
     }
 
-    MovementInfo Move(std::chrono::milliseconds delta_time);
+    // Temporaries of the move are allocated from resource
+    MovementInfo Move(std::chrono::milliseconds delta_time,
+                      std::pmr::memory_resource* resource =
+                          std::pmr::get_default_resource());
 
     void AddItem(model::Item item) { dog_->AddItem(item); }
 
-    std::vector<model::Item> DropAllItems() { return dog_->DropAllItems(); }
+    void DropAllItems() { dog_->DropAllItems(); }
 
     size_t GetItemCount() const { return dog_->GetItemCount(); }
 
@@ -59,8 +67,10 @@ class Player {
     GameSessionPointer session_;
     model::Dog::Pointer dog_;
 
-    MovementInfo MoveToBorder(const model::Coordinate& new_position,
-                              const std::vector<model::Road::Pointer>& roads);
+    MovementInfo MoveToBorder(
+        const model::Coordinate& new_position,
+        const std::pmr::vector<model::Road::Pointer>& roads,
+        std::pmr::memory_resource* resource);
 };
 
 }  // namespace app
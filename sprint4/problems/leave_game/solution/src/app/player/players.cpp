@@ -1,8 +1,6 @@
 #include "players.h"
 
-#include <algorithm>
-#include <iomanip>
-#include <sstream>
+#include <iterator>
 #include <utility>
 
 #include "app/token.h"
@@ -11,34 +9,55 @@ namespace app {
 
 Players::Players(Players&& players)
     : players_(std::move(players.players_)),
-      tokens_(std::move(players.tokens_)),
+      id_to_player_(std::move(players.id_to_player_)),
       session_to_player_(std::move(players.session_to_player_)),
       token_to_player_(std::move(players.token_to_player_)),
-      player_to_token_(std::move(players.player_to_token_)) {}
+      player_to_token_(std::move(players.player_to_token_)),
+      token_index_(std::move(players.token_index_)),
+      new_players_(std::move(players.new_players_)) {}
 
 std::pair<Player::Id, Token> Players::Add(GameSessionPointer session,
                                           model::Dog::Pointer dog) {
-    auto& player = players_.emplace_back(session, dog);
-    session_to_player_.emplace(
-        PlayerSession{dog->GetId(), session->GetMap()->GetId()}, &player);
-
-    auto& token = tokens_.emplace_back(GenerateToken());
-    token_to_player_.emplace(*token, &player);
-    player_to_token_.emplace(player.GetId(), &token);
-    return {player.GetId(), token};
+    players_.emplace_back(session.get(), dog);
+    const auto token = GenerateToken();
+    Index(std::prev(players_.end()), token);
+    return {dog->GetId(), token::ToToken(token)};
+}
+
+void Players::Index(std::list<Player>::iterator player, TokenKey token) {
+    const auto id = player->GetId();
+    const auto session = player->GetSession();
+    id_to_player_.emplace(id, player);
+    session_to_player_.emplace(PlayerSession{id, session->GetMapHandle()},
+                               &*player);
+    token_to_player_.emplace(token, &*player);
+    player_to_token_.emplace(id, token);
+    token_index_->Insert(token, {id, token, session->GetActionInbox()});
+    new_players_.push_back(token);
 }
 
 void Players::Remove(Player::Id player_id) {
-    if (auto player_it = std::find_if(
-            players_.begin(), players_.end(),
-            [&player_id](auto& player) { return player.GetId() == player_id; });
-        player_it != players_.end()) {
-        app::Player& player = *player_it;
-        session_to_player_.erase(
-            PlayerSession{player_id, player.GetSession()->GetMap()->GetId()});
-        token_to_player_.erase(**player_to_token_.at(player_id));
+    if (auto it = id_to_player_.find(player_id); it != id_to_player_.end()) {
+        const auto player_it = it->second;
+        auto* session = player_it->GetSession();
+        const auto map = session->GetMapHandle();
+        session_to_player_.erase(PlayerSession{player_id, map});
+        const TokenKey token = player_to_token_.at(player_id);
+        token_index_->Erase(token);
+        token_to_player_.erase(token);
         player_to_token_.erase(player_id);
+        id_to_player_.erase(it);
         players_.erase(player_it);
+
+        // The dog goes with its player, the one that takes its place in
+        // the session is pointed to again
+        if (auto* moved = session->RemoveDog(player_id)) {
+            if (auto moved_it =
+                    session_to_player_.find(PlayerSession{moved->GetId(), map});
+                moved_it != session_to_player_.end()) {
+                moved_it->second->SetDog(moved);
+            }
+        }
     }
 }
 
@@ -51,35 +70,48 @@ Player::ConstPointer Players::Find(PlayerSession session) const {
 }
 
 Player::Pointer Players::Find(Token token) const {
-    if (auto it = token_to_player_.find(*token); it != token_to_player_.end()) {
+    if (auto key = token::ParseKey(*token)) {
+        return Find(*key);
+    }
+    return nullptr;
+}
+
+Player::Pointer Players::Find(TokenKey token) const {
+    if (auto it = token_to_player_.find(token); it != token_to_player_.end()) {
         return it->second;
     }
     return nullptr;
 }
 
-const token::Pointer Players::FindToken(const Player::Id player_id) const {
+std::optional<TokenKey> Players::FindToken(const Player::Id player_id) const {
     if (auto it = player_to_token_.find(player_id);
         it != player_to_token_.end()) {
         return it->second;
     }
-    return nullptr;
+    return std::nullopt;
+}
+
+utils::MemoryUsage Players::GetPlayersMemory() const {
+    return {.count = players_.size(),
+            .bytes = utils::memory::HeapBytes(players_) +
+                     utils::memory::HeapBytes(id_to_player_) +
+                     utils::memory::HeapBytes(session_to_player_) +
+                     utils::memory::HeapBytes(player_to_token_)};
+}
+
+utils::MemoryUsage Players::GetTokensMemory() const {
+    return {.count = token_to_player_.size(),
+            .bytes = utils::memory::HeapBytes(token_to_player_) +
+                     utils::memory::HeapBytes(new_players_) +
+                     token_index_->GetMemoryBytes()};
 }
 
-std::string Players::GenerateToken() {
-    std::string token_str;
+TokenKey Players::GenerateToken() {
+    TokenKey token;
     do {
-        std::stringstream ss;
-        ss << std::hex << std::setw(token::SIZE / 2) << std::setfill('0')
-           << generator1_() << std::setw(token::SIZE / 2) << std::setfill('0')
-           << generator2_();
-
-        token_str = ss.str();
-    } while (std::find_if(tokens_.begin(), tokens_.end(),
-                          [&token_str](const auto& token) {
-                              return (*token) == token_str;
-                          }) != tokens_.end() &&
-             token_str.length() != token::SIZE);
-    return token_str;
+        token = {generator1_(), generator2_()};
+    } while (token_to_player_.contains(token));
+    return token;
 }
 
 }  // namespace app
@@ -1,15 +1,20 @@
 #pragma once
 
-#include <deque>
+#include <list>
 #include <memory>
+#include <optional>
 #include <random>
+#include <ranges>
 #include <string>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include "app/player/player.h"
+#include "app/player/token_index.h"
 #include "app/token.h"
 #include "model/tagged.h"
+#include "utils/memory_usage.h"
 
 namespace serialization {
 class PlayersRepr;
@@ -19,15 +24,19 @@ namespace app {
 
 struct PlayerSession {
     model::Dog::Id dog_id;
-    model::Map::Id map_id;
+    model::Map::Handle map;
 
     bool operator==(const PlayerSession& other) const {
-        return dog_id == other.dog_id && map_id == other.map_id;
+        return dog_id == other.dog_id && map == other.map;
     }
 };
 
 class PlayersCollection {
    public:
+    // The players in the order they joined. They can be changed in place,
+    // the collection itself only through Add and Remove.
+    using PlayersView = std::ranges::subrange<std::list<Player>::iterator>;
+
     virtual ~PlayersCollection() = default;
     virtual std::pair<Player::Id, Token> Add(GameSession::Pointer session,
                                              model::Dog::Pointer dog) {
@@ -46,14 +55,33 @@ class PlayersCollection {
         throw std::runtime_error(
             "PlayersCollection class not implement method Find(Token)");
     }
-    virtual const token::Pointer FindToken(const Player::Id player) const {
+    virtual Player::Pointer Find(TokenKey token) const {
+        throw std::runtime_error(
+            "PlayersCollection class not implement method Find(TokenKey)");
+    }
+    virtual std::optional<TokenKey> FindToken(const Player::Id player) const {
         throw std::runtime_error(
             "PlayersCollection class not implement method FindToken");
     }
-    virtual std::deque<Player> GetPlayers() {
+    virtual PlayersView GetPlayers() {
         throw std::runtime_error(
             "PlayersCollection class not implement method GetPlayers");
     }
+    // Tokens of the players added since the previous call
+    virtual std::vector<TokenKey> TakeNewPlayers() {
+        throw std::runtime_error(
+            "PlayersCollection class not implement method TakeNewPlayers");
+    }
+    // Players with the indexes by session and by id
+    virtual utils::MemoryUsage GetPlayersMemory() const {
+        throw std::runtime_error(
+            "PlayersCollection class not implement method GetPlayersMemory");
+    }
+    // Tokens with the indexes by token
+    virtual utils::MemoryUsage GetTokensMemory() const {
+        throw std::runtime_error(
+            "PlayersCollection class not implement method GetTokensMemory");
+    }
 };
 
 class Players : public PlayersCollection {
@@ -76,26 +104,60 @@ class Players : public PlayersCollection {
 
     Player::Pointer Find(Token token) const override;
 
-    const token::Pointer FindToken(const Player::Id player) const override;
+    Player::Pointer Find(TokenKey token) const override;
+
+    std::optional<TokenKey> FindToken(const Player::Id player) const override;
 
-    std::deque<Player> GetPlayers() override { return players_; }
+    PlayersView GetPlayers() override { return players_; }
+
+    std::vector<TokenKey> TakeNewPlayers() override {
+        return std::exchange(new_players_, {});
+    }
+
+    utils::MemoryUsage GetPlayersMemory() const override;
+
+    utils::MemoryUsage GetTokensMemory() const override;
+
+    // Safe to read from any thread while the players change
+    std::shared_ptr<const TokenIndex> GetTokenIndex() const {
+        return token_index_;
+    }
+
+    // Tokens handed out after this call depend only on seed and the tokens
+    // already issued
+    void Reseed(std::uint64_t seed) {
+        generator1_.seed(seed);
+        generator2_.seed(~seed);
+    }
 
    private:
     struct PlayerSessionComparator {
         std::size_t operator()(const PlayerSession& session) const {
-            return std::hash<std::uint32_t>{}(*session.dog_id) +
-                   std::hash<std::string>{}(*session.map_id);
+            return std::hash<std::uint64_t>{}(
+                (std::uint64_t{*session.map} << 32) | *session.dog_id);
         }
     };
 
-    std::deque<Player> players_;
-    std::deque<Token> tokens_;
+    // The indexes below point into players_, removing a player must leave
+    // the others where they are
+    std::list<Player> players_;
+    // Removal is a lookup, not a scan, AFK retirement removes players one
+    // by one
+    std::unordered_map<Player::Id, std::list<Player>::iterator,
+                       util::TaggedHasher<Player::Id>>
+        id_to_player_;
     std::unordered_map<PlayerSession, Player::Pointer, PlayerSessionComparator>
         session_to_player_;
-    std::unordered_map<std::string_view, Player::Pointer> token_to_player_;
-    std::unordered_map<model::Dog::Id, token::Pointer,
+    std::unordered_map<TokenKey, Player::Pointer, TokenKeyHasher>
+        token_to_player_;
+    // Tokens are kept by value here and wherever else they wait, in the
+    // action inboxes and the AFK wheel, so a removed player's token goes
+    // with it
+    std::unordered_map<model::Dog::Id, TokenKey,
                        util::TaggedHasher<model::Dog::Id>>
         player_to_token_;
+    std::shared_ptr<TokenIndex> token_index_ = std::make_shared<TokenIndex>();
+    std::vector<TokenKey> new_players_;
 
     std::random_device random_device_;
     std::mt19937_64 generator1_{[this] {
@@ -107,7 +169,10 @@ class Players : public PlayersCollection {
         return dist(random_device_);
     }()};
 
-    std::string GenerateToken();
+    TokenKey GenerateToken();
+
+    // Adds player, already in players_, and its token to the indexes
+    void Index(std::list<Player>::iterator player, TokenKey token);
 };
 
 }  // namespace app
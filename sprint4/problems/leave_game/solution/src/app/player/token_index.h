@@ -0,0 +1,81 @@
+#pragma once
+
+#include <array>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+
+#include "app/game/action_inbox.h"
+#include "app/token.h"
+#include "model/dog.h"
+#include "utils/memory_usage.h"
+
+namespace app {
+
+// Token lookup for threads other than the API strand. Players keeps it in
+// step with its own maps, lookups take a shared lock of one shard only.
+class TokenIndex {
+   public:
+    struct Entry {
+        model::Dog::Id player;
+        TokenKey token;
+        ActionInbox::Pointer inbox;
+    };
+
+    static constexpr size_t SHARDS = 16;
+
+    void Insert(TokenKey token, Entry entry) {
+        auto& shard = GetShard(token);
+        std::unique_lock lock{shard.mutex};
+        shard.entries.insert_or_assign(token, std::move(entry));
+    }
+
+    void Erase(TokenKey token) {
+        auto& shard = GetShard(token);
+        std::unique_lock lock{shard.mutex};
+        shard.entries.erase(token);
+    }
+
+    std::optional<Entry> Find(std::string_view token) const {
+        const auto key = token::ParseKey(token);
+        if (!key) {
+            return std::nullopt;
+        }
+        const auto& shard = GetShard(*key);
+        std::shared_lock lock{shard.mutex};
+        if (auto it = shard.entries.find(*key); it != shard.entries.end()) {
+            return it->second;
+        }
+        return std::nullopt;
+    }
+
+    size_t GetMemoryBytes() const {
+        size_t bytes = sizeof(*this);
+        for (const auto& shard : shards_) {
+            std::shared_lock lock{shard.mutex};
+            bytes += utils::memory::HeapBytes(shard.entries);
+        }
+        return bytes;
+    }
+
+   private:
+    struct Shard {
+        mutable std::shared_mutex mutex;
+        std::unordered_map<TokenKey, Entry, TokenKeyHasher> entries;
+    };
+
+    Shard& GetShard(TokenKey token) {
+        return shards_[TokenKeyHasher{}(token) % SHARDS];
+    }
+
+    const Shard& GetShard(TokenKey token) const {
+        return shards_[TokenKeyHasher{}(token) % SHARDS];
+    }
+
+    std::array<Shard, SHARDS> shards_;
+};
+
+}  // namespace app
@@ -0,0 +1,138 @@
+#include "records_cursor.h"
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstdint>
+
+namespace app {
+
+namespace {
+
+constexpr std::string_view ALPHABET =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+constexpr char SEPARATOR = ':';
+constexpr size_t UUID_SIZE = 36;
+
+std::string EncodeBase64(std::string_view data) {
+    std::string result;
+    result.reserve((data.size() * 4 + 2) / 3);
+    std::uint32_t buffer = 0;
+    int bits = 0;
+    for (unsigned char c : data) {
+        buffer = (buffer << 8) | c;
+        bits += 8;
+        while (bits >= 6) {
+            bits -= 6;
+            result.push_back(ALPHABET[(buffer >> bits) & 0x3F]);
+        }
+    }
+    if (bits > 0) {
+        result.push_back(ALPHABET[(buffer << (6 - bits)) & 0x3F]);
+    }
+    return result;
+}
+
+std::optional<std::string> DecodeBase64(std::string_view text) {
+    static const auto values = [] {
+        std::array<int, 256> values;
+        values.fill(-1);
+        for (size_t i = 0; i < ALPHABET.size(); ++i) {
+            values[static_cast<unsigned char>(ALPHABET[i])] =
+                static_cast<int>(i);
+        }
+        return values;
+    }();
+
+    std::string result;
+    result.reserve(text.size() * 3 / 4);
+    std::uint32_t buffer = 0;
+    int bits = 0;
+    for (unsigned char c : text) {
+        const int value = values[c];
+        if (value < 0) {
+            return std::nullopt;
+        }
+        buffer = (buffer << 6) | static_cast<std::uint32_t>(value);
+        bits += 6;
+        if (bits >= 8) {
+            bits -= 8;
+            result.push_back(static_cast<char>((buffer >> bits) & 0xFF));
+        }
+    }
+    // Leftover bits come only from padding the last character
+    if (bits >= 6 || (buffer & ((1u << bits) - 1)) != 0) {
+        return std::nullopt;
+    }
+    return result;
+}
+
+bool IsNumber(std::string_view text) {
+    double value;
+    auto [end, ec] =
+        std::from_chars(text.data(), text.data() + text.size(), value);
+    return ec == std::errc{} && end == text.data() + text.size();
+}
+
+bool IsUuid(std::string_view text) {
+    if (text.size() != UUID_SIZE) {
+        return false;
+    }
+    for (size_t i = 0; i < text.size(); ++i) {
+        const bool is_dash_position = i == 8 || i == 13 || i == 18 || i == 23;
+        const char c = text[i];
+        const bool is_hex = (c >= '0' && c <= '9') || (c >= 'a' && c <= 'f') ||
+                            (c >= 'A' && c <= 'F');
+        if (is_dash_position ? c != '-' : !is_hex) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace
+
+// The name goes last, so it may contain the separator
+std::string EncodeRecordsCursor(const postgres::RecordKey& key) {
+    std::string data = std::to_string(key.score);
+    data += SEPARATOR;
+    data += key.time_in_game;
+    data += SEPARATOR;
+    data += key.id;
+    data += SEPARATOR;
+    data += key.name;
+    return EncodeBase64(data);
+}
+
+std::optional<postgres::RecordKey> DecodeRecordsCursor(
+    std::string_view cursor) {
+    auto data = DecodeBase64(cursor);
+    if (!data) {
+        return std::nullopt;
+    }
+
+    std::string_view rest = *data;
+    std::array<std::string_view, 3> fields;
+    for (auto& field : fields) {
+        auto pos = rest.find(SEPARATOR);
+        if (pos == rest.npos) {
+            return std::nullopt;
+        }
+        field = rest.substr(0, pos);
+        rest.remove_prefix(pos + 1);
+    }
+
+    postgres::RecordKey key;
+    auto [end, ec] = std::from_chars(
+        fields[0].data(), fields[0].data() + fields[0].size(), key.score);
+    if (ec != std::errc{} || end != fields[0].data() + fields[0].size() ||
+        !IsNumber(fields[1]) || !IsUuid(fields[2])) {
+        return std::nullopt;
+    }
+    key.time_in_game = fields[1];
+    key.id = fields[2];
+    key.name = rest;
+    return key;
+}
+
+}  // namespace app
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "postgres/repository.h"
+
+namespace app {
+
+// Records cursors are opaque to clients: the key of the last returned row
+// encoded as URL-safe base64 without padding, so it needs no escaping in a
+// query string.
+std::string EncodeRecordsCursor(const postgres::RecordKey& key);
+
+// Returns nullopt for anything EncodeRecordsCursor could not have produced
+std::optional<postgres::RecordKey> DecodeRecordsCursor(std::string_view cursor);
+
+}  // namespace app
@@ -1,7 +1,9 @@
 #pragma once
 
 #include <algorithm>
+#include <cstdint>
 #include <random>
+#include <vector>
 
 #include "model/map.h"
 #include "model/model.h"
@@ -11,32 +13,46 @@ class SpawnPointGenerator {
     explicit SpawnPointGenerator(bool is_random_spawn_point = true)
         : is_random_spawn_point_(is_random_spawn_point) {}
 
-    model::Coordinate Generate(const model::Map::Pointer map) {
-        auto roads = map->GetRoads();
+    SpawnPointGenerator(bool is_random_spawn_point, std::uint64_t seed)
+        : is_random_spawn_point_(is_random_spawn_point), generator_{seed} {}
 
-        if (!is_random_spawn_point_)
-            return model::Coordinate{
-                .x = static_cast<double>(roads[0]->GetStart().x),
-                .y = static_cast<double>(roads[0]->GetStart().y)};
+    void Reseed(std::uint64_t seed) { generator_.seed(seed); }
 
-        std::uniform_int_distribution<std::uint32_t> distribution_roads(
-            0, roads.size() - 1);
-        auto road = roads[distribution_roads(generator1_)];
+    model::Coordinate Generate(const model::Map::Pointer& map) {
+        return Generate(*map);
+    }
 
-        std::uniform_int_distribution<std::int32_t> distributionX(
-            std::min(road->GetStart().x, road->GetEnd().x),
-            std::max(road->GetStart().x, road->GetEnd().x));
-        std::uniform_int_distribution<std::int32_t> distributionY(
-            std::min(road->GetStart().y, road->GetEnd().y),
-            std::max(road->GetStart().y, road->GetEnd().y));
+    // Random points are spread uniformly over the total road length
+    model::Coordinate Generate(const model::Map& map) {
+        if (!is_random_spawn_point_) {
+            auto start = map.GetRoads().front()->GetStart();
+            return model::Coordinate{.x = static_cast<double>(start.x),
+                                     .y = static_cast<double>(start.y)};
+        }
+
+        std::uniform_int_distribution<std::uint64_t> distribution(
+            0, map.GetRoadPointsCount() - 1);
+        return map.GetRoadPoint(distribution(generator_));
+    }
 
-        return {static_cast<double>(distributionX(generator1_)),
-                static_cast<double>(distributionY(generator1_))};
+    // Appends count points to out
+    void Generate(const model::Map& map, size_t count,
+                  std::vector<model::Coordinate>& out) {
+        out.reserve(out.size() + count);
+        if (!is_random_spawn_point_) {
+            out.insert(out.end(), count, Generate(map));
+            return;
+        }
+
+        std::uniform_int_distribution<std::uint64_t> distribution(
+            0, map.GetRoadPointsCount() - 1);
+        for (size_t i = 0; i < count; ++i) {
+            out.push_back(map.GetRoadPoint(distribution(generator_)));
+        }
     }
 
    private:
     bool is_random_spawn_point_;
 
-    std::random_device random_device_;
-    std::mt19937_64 generator1_{random_device_()};
+    std::mt19937_64 generator_{std::random_device{}()};
 };
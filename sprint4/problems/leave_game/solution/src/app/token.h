@@ -1,7 +1,10 @@
 #pragma once
 
+#include <cstdint>
 #include <memory>
+#include <optional>
 #include <string>
+#include <string_view>
 
 #include "model/tagged.h"
 
@@ -13,9 +16,56 @@ struct TokenTag {};
 
 using Token = util::Tagged<std::string, detail::TokenTag>;
 
+// The 128 bits a token is printed from. Players are indexed by it, the
+// 32 characters are spelled out only where a token leaves the server.
+struct TokenKey {
+    std::uint64_t high = 0;
+    std::uint64_t low = 0;
+
+    bool operator==(const TokenKey& other) const = default;
+};
+
+struct TokenKeyHasher {
+    // Tokens are random, so are their bits
+    size_t operator()(const TokenKey& key) const noexcept {
+        return static_cast<size_t>(key.high ^ key.low);
+    }
+};
+
 namespace token {
 static constexpr size_t SIZE = 32;
-using Pointer = Token*;
+
+// Accepts tokens only as ToToken prints them, 32 lowercase hex digits
+inline std::optional<TokenKey> ParseKey(std::string_view token) {
+    if (token.size() != SIZE) {
+        return std::nullopt;
+    }
+    std::uint64_t halves[2] = {0, 0};
+    for (size_t i = 0; i < SIZE; ++i) {
+        const char c = token[i];
+        std::uint64_t digit;
+        if (c >= '0' && c <= '9') {
+            digit = c - '0';
+        } else if (c >= 'a' && c <= 'f') {
+            digit = c - 'a' + 10;
+        } else {
+            return std::nullopt;
+        }
+        auto& half = halves[i / (SIZE / 2)];
+        half = (half << 4) | digit;
+    }
+    return TokenKey{halves[0], halves[1]};
+}
+
+inline Token ToToken(TokenKey key) {
+    static constexpr char DIGITS[] = "0123456789abcdef";
+    std::string token(SIZE, '0');
+    for (size_t i = 0; i < SIZE / 2; ++i) {
+        token[SIZE / 2 - 1 - i] = DIGITS[(key.high >> (4 * i)) & 0xf];
+        token[SIZE - 1 - i] = DIGITS[(key.low >> (4 * i)) & 0xf];
+    }
+    return Token{std::move(token)};
+}
 }  // namespace token
 
 }  // namespace app
@@ -1,11 +1,14 @@
 #pragma once
 
 #include <chrono>
+#include <cstddef>
+#include <cstdint>
 #include <memory>
+#include <memory_resource>
+#include <optional>
+#include <random>
 #include <string>
-#include <unordered_map>
 #include <utility>
-#include <variant>
 #include <vector>
 
 #include <boost/log/trivial.hpp>
@@ -22,6 +25,7 @@
 #include "model/tagged.h"
 #include "tick_use_case/check_afk_provider.h"
 #include "utils/logger.h"
+#include "utils/profiler.h"
 
 enum class GameTickErrorReason { InvalidDeltaTime };
 
@@ -34,8 +38,8 @@ struct GameTickError : public UseCaseError {
 
 class ItemGatherer : public collision_detector::ItemGathererProvider {
    public:
-    using Items = std::vector<collision_detector::Item>;
-    using Gatherers = std::vector<collision_detector::Gatherer>;
+    using Items = std::pmr::vector<collision_detector::Item>;
+    using Gatherers = std::pmr::vector<collision_detector::Gatherer>;
 
     ItemGatherer(const Items& items, const Gatherers& gatherers)
         : items_(items), gatherers_(gatherers) {}
@@ -54,8 +58,21 @@ class ItemGatherer : public collision_detector::ItemGathererProvider {
     const Gatherers& gatherers_;
 };
 
+struct GameTickStats {
+    std::chrono::nanoseconds move_players{0};
+    std::chrono::nanoseconds generate_loot{0};
+    std::chrono::nanoseconds check_afk{0};
+    size_t gather_events = 0;
+    size_t generated_loot = 0;
+    size_t retired_players = 0;
+};
+
 class GameTickUseCase {
    public:
+    // Initial size of the per-tick arena, larger ticks take extra chunks
+    // from the default resource until the arena is reset
+    static constexpr size_t TICK_ARENA_SIZE = 256 * 1024;
+
     explicit GameTickUseCase(
         app::Game::Pointer game,
         std::shared_ptr<app::PlayersCollection> players,
@@ -63,136 +80,261 @@ class GameTickUseCase {
         LootHandler::Pointer loot_handler,
         LootNumberMapHandler::Pointer loot_number_map_handler,
         std::shared_ptr<postgres::UnitOfWorkFactory> factory,
-        bool is_random_spawn_point = true)
+        bool is_random_spawn_point = true,
+        std::optional<std::uint64_t> seed = std::nullopt,
+        loot_gen::SessionRandomFactory session_random = {})
         : game_(game),
           players_(players),
           loot_generator_(std::move(loot_generator)),
           loot_handler_(loot_handler),
           loot_number_map_handler_(std::move(loot_number_map_handler)),
-          spawn_point_generator_(is_random_spawn_point),
-          afk_provider_(game_, players_, factory) {}
+          generator_(seed.value_or(std::random_device{}())),
+          spawn_point_generator_(is_random_spawn_point, generator_()),
+          session_random_(std::move(session_random)),
+          session_seeds_(generator_()),
+          afk_provider_(game_, players_, factory),
+          tick_buffer_(std::make_unique<std::byte[]>(TICK_ARENA_SIZE)),
+          tick_arena_(tick_buffer_.get(), TICK_ARENA_SIZE) {}
 
     void Tick(std::chrono::milliseconds delta_time) {
         if (delta_time.count() <= 0) {
             throw GameTickError("invalidArgument", "Invalid delta time",
                                 GameTickErrorReason::InvalidDeltaTime);
         }
+        using Clock = std::chrono::steady_clock;
+        last_tick_stats_ = {};
+
+        auto start = Clock::now();
         MovePlayers(delta_time);
+        for (const auto& session : game_->GetGameSessions()) {
+            session->InvalidateSpatialIndex();
+        }
+        auto moved = Clock::now();
         GenerateLoot(delta_time);
-        afk_provider_.CheckAFKPlayers();
+        auto generated = Clock::now();
+        last_tick_stats_.retired_players =
+            afk_provider_.CheckAFKPlayers(delta_time);
+        auto checked = Clock::now();
+
+        last_tick_stats_.move_players = moved - start;
+        last_tick_stats_.generate_loot = generated - moved;
+        last_tick_stats_.check_afk = checked - generated;
+
+        // Temporaries of this tick are gone, the next one starts from the
+        // beginning of tick_buffer_ again
+        tick_arena_.release();
     }
 
-   private:
-    enum CollisionItemType { Item, Office };
+    const GameTickStats& GetLastTickStats() const noexcept {
+        return last_tick_stats_;
+    }
 
+    void SetWriteRetired(bool write_retired) {
+        afk_provider_.SetWriteRetired(write_retired);
+    }
+
+    // Loot timers of the sessions, in session order
+    std::vector<std::chrono::milliseconds> GetLootTimers() const {
+        std::vector<std::chrono::milliseconds> timers;
+        timers.reserve(session_loot_generators_.size());
+        for (const auto& generator : session_loot_generators_) {
+            timers.push_back(generator.GetTimeWithoutLoot());
+        }
+        return timers;
+    }
+
+    // Puts every random source of the tick into a state given by seed and
+    // the loot timers, so the following ticks can be repeated exactly
+    void ResetRandomState(
+        std::uint64_t seed,
+        const std::vector<std::chrono::milliseconds>& timers) {
+        generator_.seed(seed);
+        spawn_point_generator_.Reseed(generator_());
+        session_seeds_.seed(generator_());
+        session_loot_generators_.clear();
+        session_loot_generators_.reserve(timers.size());
+        for (const auto timer : timers) {
+            session_loot_generators_.push_back(MakeSessionLootGenerator(timer));
+        }
+    }
+
+   private:
     app::Game::Pointer game_;
     std::shared_ptr<app::PlayersCollection> players_;
     loot_gen::LootGenerator::Pointer loot_generator_;
     LootHandler::Pointer loot_handler_;
 
     LootNumberMapHandler::Pointer loot_number_map_handler_;
+    std::mt19937_64 generator_;
     SpawnPointGenerator spawn_point_generator_;
+    // Each session draws the seed of its random source from session_seeds_,
+    // so sessions get distinct streams that a checkpoint seed reproduces
+    loot_gen::SessionRandomFactory session_random_;
+    std::mt19937_64 session_seeds_;
 
     CheckAFKProvider afk_provider_;
+    GameTickStats last_tick_stats_;
 
-    std::random_device random_device_;
-    std::mt19937_64 generator_{random_device_()};
+    // Loot generation state is kept per session, so maps sharing the
+    // configured generator do not reset each other's timers
+    std::vector<loot_gen::SessionLootGenerator> session_loot_generators_;
+    std::vector<model::Coordinate> spawn_points_;
+
+    std::unique_ptr<std::byte[]> tick_buffer_;
+    std::pmr::monotonic_buffer_resource tick_arena_;
 
     void MovePlayers(std::chrono::milliseconds delta_time) {
-        std::unordered_map<model::Map::Id, ItemGatherer::Gatherers,
-                           util::TaggedHasher<model::Map::Id>>
-            map_gatherers;
+        PROFILE_SCOPE("GameTickUseCase::MovePlayers");
+        // Per-map vectors are indexed by map handle
+        const size_t maps_count = model::Map::GetHandles().GetSize();
+        std::pmr::vector<ItemGatherer::Gatherers> map_gatherers(maps_count,
+                                                                &tick_arena_);
+        std::pmr::vector<std::pmr::vector<app::Player::Pointer>> map_players(
+            maps_count, &tick_arena_);
 
-        std::unordered_map<model::Map::Id, ItemGatherer::Items,
-                           util::TaggedHasher<model::Map::Id>>
-            map_items;
+        // Sessions know how many dogs they hold, so the per-map vectors
+        // never grow inside the arena
+        const auto& sessions = game_->GetGameSessions();
+        std::pmr::vector<size_t> map_dogs(maps_count, 0, &tick_arena_);
+        for (const auto& session : sessions) {
+            map_dogs[*session->GetMapHandle()] += session->GetDogs().size();
+        }
+        for (size_t map = 0; map < maps_count; ++map) {
+            map_gatherers[map].reserve(map_dogs[map]);
+            map_players[map].reserve(map_dogs[map]);
+        }
 
-        std::unordered_map<size_t, app::Player::Pointer> gatherer_id_player;
+        // Gatherer and item ids reported by the collision detector are
+        // indices into the per-map vectors, the players are not added or
+        // removed until the events are processed.
         for (auto& player : players_->GetPlayers()) {
-            auto [start_pos, end_pos] = player.Move(delta_time);
-            auto map_id = player.GetSession()->GetMapId();
-            map_gatherers[map_id].push_back(
+            auto [start_pos, end_pos] = player.Move(delta_time, &tick_arena_);
+            const auto map = *player.GetSession()->GetMapHandle();
+            map_gatherers[map].push_back(
                 collision_detector::Gatherer{.start_pos = start_pos,
                                              .end_pos = end_pos,
                                              .width = app::Player::WIDTH / 2});
-            gatherer_id_player.emplace(map_gatherers[map_id].size(), &player);
+            map_players[map].push_back(&player);
         }
 
-        std::unordered_map<size_t,
-                           std::variant<model::Item::Id, const model::Office*>>
-            item_id_item;
+        for (size_t map = 0; map < maps_count; ++map) {
+            const auto& gatherers = map_gatherers[map];
+            if (gatherers.empty()) {
+                continue;
+            }
+            const model::Map::Handle handle{
+                static_cast<model::Map::Handle::ValueType>(map)};
+            auto game_session = game_->FindGameSession(handle);
 
-        for (const auto& [map, _] : map_gatherers) {
-            auto game_session = game_->FindGameSession(map);
+            const auto& loot = game_session->GetLootPositionsInfo();
 
-            for (const auto& item : game_session->GetLootPositionsInfo()) {
-                map_items[map].push_back(collision_detector::Item{
+            // Growing a vector in the arena would leave the old blocks
+            // behind, so both are sized up front
+            ItemGatherer::Items items(&tick_arena_);
+            std::pmr::vector<model::Item::Id> loot_ids(&tick_arena_);
+            items.reserve(loot.size());
+            loot_ids.reserve(loot.size());
+            for (const auto& item : loot) {
+                items.push_back(collision_detector::Item{
                     .position = item.position, .width = model::ItemWidth / 2});
-                item_id_item.emplace(map_items[map].size(), item.id);
+                loot_ids.push_back(item.id);
             }
 
-            for (const auto& office : game_session->GetMap()->GetOffices()) {
-                map_items[map].push_back(collision_detector::Item{
-                    .position =
-                        model::Coordinate{
-                            .x = static_cast<double>(office.GetPosition().x),
-                            .y = static_cast<double>(office.GetPosition().y)},
-                    .width = model::Office::WIDTH / 2});
-                item_id_item.emplace(map_items[map].size(), &office);
-            }
-        }
-
-        for (const auto& [map, gatherers] : map_gatherers) {
-            const auto& items = map_items[map];
             ItemGatherer provider(items, gatherers);
-            std::vector<collision_detector::GatheringEvent> events =
-                collision_detector::FindGatherEvents(provider);
-            ProcessEvents(gatherer_id_player, item_id_item, events);
+            PROFILE_SCOPE("GameTickUseCase::FindGatherEvents");
+            auto loot_events =
+                collision_detector::FindGatherEvents(provider, &tick_arena_);
+            // Offices are static, the map keeps them in their own index
+            auto office_events = collision_detector::FindOfficeEvents(
+                provider, game_session->GetMap()->GetOfficeIndex(),
+                model::Office::WIDTH / 2, &tick_arena_);
+            last_tick_stats_.gather_events +=
+                loot_events.size() + office_events.size();
+            ProcessEvents(map_players[map], loot_ids, loot_events,
+                          office_events,
+                          loot_number_map_handler_->GetMaxLootNumber(handle));
         }
     }
 
+    // Both event lists are sorted by time and are handled in that order,
+    // loot first when a pickup and a drop happen at the same moment
     void ProcessEvents(
-        const std::unordered_map<size_t, app::Player::Pointer>&
-            gatherer_id_gatherer,
-        const std::unordered_map<
-            size_t, std::variant<model::Item::Id, const model::Office*>>&
-            item_id_item,
-        const std::vector<collision_detector::GatheringEvent>& events) {
-        for (const auto& event : events) {
+        const std::pmr::vector<app::Player::Pointer>& gatherer_id_gatherer,
+        const std::pmr::vector<model::Item::Id>& item_id_loot,
+        const std::pmr::vector<collision_detector::GatheringEvent>&
+            loot_events,
+        const std::pmr::vector<collision_detector::GatheringEvent>&
+            office_events,
+        size_t bag_capacity) {
+        auto loot_it = loot_events.begin();
+        auto office_it = office_events.begin();
+        while (loot_it != loot_events.end() ||
+               office_it != office_events.end()) {
+            if (office_it != office_events.end() &&
+                (loot_it == loot_events.end() ||
+                 office_it->time < loot_it->time)) {
+                gatherer_id_gatherer.at(office_it->gatherer_id)
+                    ->DropAllItems();
+                ++office_it;
+                continue;
+            }
+
+            const auto& event = *loot_it++;
             auto player = gatherer_id_gatherer.at(event.gatherer_id);
-            auto item = item_id_item.at(event.item_id);
-            if (auto item_ptr = std::get_if<const model::Office*>(&item)) {
-                player->DropAllItems();
-            } else if (auto item_ptr = std::get_if<model::Item::Id>(&item)) {
-                if (auto removed_item =
-                        player->GetSession()->RemoveLoot(*item_ptr);
-                    removed_item.has_value()) {
-                    player->AddItem(*removed_item);
-                }
+            if (player->GetItemCount() >= bag_capacity) {
+                continue;
+            }
+            if (auto removed_item = player->GetSession()->RemoveLoot(
+                    item_id_loot.at(event.item_id));
+                removed_item.has_value()) {
+                player->AddItem(*removed_item);
             }
         }
     }
 
-    int GenerateType(int max_type) {
-        std::uniform_int_distribution<std::int32_t> distribution(1, max_type);
-        return distribution(generator_);
+    // The configured generator gives the interval and probability, the
+    // random source is made by session_random_, or is the constant 1 of
+    // EngineRandom when none is set
+    loot_gen::SessionLootGenerator MakeSessionLootGenerator(
+        std::chrono::milliseconds time_without_loot) {
+        const auto seed = session_seeds_();
+        return {loot_generator_->GetBaseInterval(),
+                loot_generator_->GetProbability(), time_without_loot,
+                session_random_ ? session_random_(seed)
+                                : loot_gen::EngineRandom{seed}};
     }
 
     void GenerateLoot(std::chrono::milliseconds delta_time) {
-        for (const auto& map : game_->GetMaps()) {
-            auto session = game_->FindGameSession(map->GetId());
-            if (!session) {
+        PROFILE_SCOPE("GameTickUseCase::GenerateLoot");
+        const auto& sessions = game_->GetGameSessions();
+        session_loot_generators_.reserve(sessions.size());
+        while (session_loot_generators_.size() < sessions.size()) {
+            session_loot_generators_.push_back(MakeSessionLootGenerator(
+                loot_generator_->GetTimeWithoutLoot()));
+        }
+
+        for (size_t i = 0; i < sessions.size(); ++i) {
+            const auto& session = sessions[i];
+            unsigned count_items = session_loot_generators_[i].Generate(
+                delta_time, session->GetLootNumber(),
+                session->GetDogs().size());
+            if (count_items == 0) {
                 continue;
             }
-            int count_items =
-                loot_generator_->Generate(delta_time, session->GetLootNumber(),
-                                          session->GetDogs().size());
-            for (size_t i = 0; i < count_items; i++) {
-                auto spawn_point = spawn_point_generator_.Generate(map);
-                int type = GenerateType(map->GetNumberOfLootTypes());
+            last_tick_stats_.generated_loot += count_items;
+
+            const auto& map = *session->GetMap();
+            spawn_points_.clear();
+            spawn_point_generator_.Generate(map, count_items, spawn_points_);
+
+            std::uniform_int_distribution<int> type_distribution(
+                1, map.GetNumberOfLootTypes());
+            session->ReserveLoot(count_items);
+            for (const auto& spawn_point : spawn_points_) {
+                int type = type_distribution(generator_);
                 session->AddLoot(
                     type, spawn_point,
-                    loot_handler_->FindValueByLootType(map->GetId(), type));
+                    loot_handler_->FindValueByLootType(map.GetHandle(), type));
             }
         }
     }
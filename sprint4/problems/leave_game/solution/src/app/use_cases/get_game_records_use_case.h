@@ -1,16 +1,19 @@
 #pragma once
 
 #include <memory>
+#include <optional>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include <boost/json/object.hpp>
 
+#include "app/records_cursor.h"
 #include "app/use_cases/base.h"
 #include "postgres/unit_of_work.h"
 #include "utils/logger.h"
 
-enum class GetGameRecordsErrorReason { UnknownToken };
+enum class GetGameRecordsErrorReason { UnknownToken, InvalidCursor };
 
 struct GetGameRecordsError : public UseCaseError {
     GetGameRecordsError(std::string code, std::string message,
@@ -26,6 +29,12 @@ struct GameRecord {
     double time_in_game;
 };
 
+struct GameRecordsPage {
+    std::vector<GameRecord> records;
+    // Empty on the last page
+    std::string next_cursor;
+};
+
 class GetGameRecordsUseCase {
    public:
     explicit GetGameRecordsUseCase(
@@ -34,7 +43,37 @@ class GetGameRecordsUseCase {
 
     std::vector<GameRecord> GetGameRecords(int start, int max_items) {
         auto unit_of_work = factory_->CreateUnitOfWork();
-        auto players = unit_of_work->GetPlayers().Read(start, max_items);
+        return ToGameRecords(
+            unit_of_work->GetPlayers().Read(start, max_items));
+    }
+
+    // An empty cursor starts from the first record
+    GameRecordsPage GetGameRecordsPage(std::string_view cursor,
+                                       int max_items) {
+        std::optional<postgres::RecordKey> after;
+        if (!cursor.empty()) {
+            after = app::DecodeRecordsCursor(cursor);
+            if (!after) {
+                throw GetGameRecordsError(
+                    "invalidArgument", "Invalid cursor",
+                    GetGameRecordsErrorReason::InvalidCursor);
+            }
+        }
+
+        auto unit_of_work = factory_->CreateUnitOfWork();
+        auto page = unit_of_work->GetPlayers().ReadAfter(after, max_items);
+        GameRecordsPage result{.records = ToGameRecords(page.players)};
+        if (page.next) {
+            result.next_cursor = app::EncodeRecordsCursor(*page.next);
+        }
+        return result;
+    }
+
+   private:
+    std::shared_ptr<postgres::UnitOfWorkFactory> factory_;
+
+    static std::vector<GameRecord> ToGameRecords(
+        const std::vector<postgres::PlayerInfo>& players) {
         std::vector<GameRecord> result;
 
         result.reserve(players.size());
@@ -47,7 +86,4 @@ class GetGameRecordsUseCase {
         }
         return result;
     }
-
-   private:
-    std::shared_ptr<postgres::UnitOfWorkFactory> factory_;
 };
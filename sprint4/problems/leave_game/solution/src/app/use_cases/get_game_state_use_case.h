@@ -1,11 +1,13 @@
 #pragma once
 
 #include <memory>
+#include <optional>
 #include <string>
 #include <vector>
 
 #include <boost/json/object.hpp>
 
+#include "app/game/spatial_grid.h"
 #include "app/player/players.h"
 #include "app/token.h"
 #include "app/use_cases/base.h"
@@ -31,9 +33,26 @@ struct PlayerGameState {
     int score;
 };
 
+// What a filtered state leaves out, only counted
+struct OutOfViewSummary {
+    size_t players = 0;
+    size_t lost_objects = 0;
+};
+
 struct GameState {
     std::vector<PlayerGameState> player_coord_infos;
     std::vector<model::Item> lost_objects;
+    // Set when the state is limited to an area
+    std::optional<OutOfViewSummary> out_of_view;
+};
+
+// Limits the state to a part of the map. Without either field the whole
+// session is returned.
+struct GameStateFilter {
+    // Around the dog of the requesting player
+    std::optional<double> radius;
+    // Used when radius is not set
+    std::optional<app::AreaOfInterest> viewport;
 };
 
 class GetGameStateUseCase {
@@ -42,7 +61,8 @@ class GetGameStateUseCase {
         std::shared_ptr<app::PlayersCollection> players)
         : players_(players) {}
 
-    GameState GetGameState(const app::Token& token) const {
+    GameState GetGameState(const app::Token& token,
+                           const GameStateFilter& filter = {}) const {
         auto player = players_->Find(token);
         if (!player) {
             throw GetGameStateError{"unknownToken",
@@ -50,14 +70,22 @@ class GetGameStateUseCase {
                                     GetGameStateErrorReason::UnknownToken};
         }
 
-        GameState result;
         auto session_ptr = player->GetSession();
+        if (filter.radius) {
+            return GetAreaState(*session_ptr,
+                                app::AreaOfInterest::Around(
+                                    player->GetDog()->GetPosition(),
+                                    *filter.radius));
+        }
+        if (filter.viewport) {
+            return GetAreaState(*session_ptr, *filter.viewport);
+        }
+
+        GameState result;
         const auto& dogs = session_ptr->GetDogs();
         result.player_coord_infos.reserve(dogs.size());
         for (const auto& dog : dogs) {
-            result.player_coord_infos.push_back(
-                {dog.GetId(), dog.GetPosition(), dog.GetVelocity(),
-                 dog.GetDirection(), dog.GetItems(), dog.GetScore()});
+            result.player_coord_infos.push_back(MakePlayerGameState(dog));
         }
 
         const auto& lost_objects = session_ptr->GetLootPositionsInfo();
@@ -71,5 +99,29 @@ class GetGameStateUseCase {
     }
 
    private:
+    static PlayerGameState MakePlayerGameState(const model::Dog& dog) {
+        return {dog.GetId(), dog.GetPosition(), dog.GetVelocity(),
+                dog.GetDirection(), dog.GetItems().ToItems(), dog.GetScore()};
+    }
+
+    // Copies only what the session index finds in area, the rest is
+    // counted from the session sizes
+    static GameState GetAreaState(app::GameSession& session,
+                                  const app::AreaOfInterest& area) {
+        GameState result;
+        for (const auto* dog : session.FindDogsIn(area)) {
+            result.player_coord_infos.push_back(MakePlayerGameState(*dog));
+        }
+        for (const auto* object : session.FindLootIn(area)) {
+            result.lost_objects.emplace_back(object->id, object->type,
+                                             object->position);
+        }
+        result.out_of_view = OutOfViewSummary{
+            session.GetDogs().size() - result.player_coord_infos.size(),
+            session.GetLootPositionsInfo().size() -
+                result.lost_objects.size()};
+        return result;
+    }
+
     const std::shared_ptr<app::PlayersCollection> players_;
 };
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "app/game/game.h"
+#include "app/player/players.h"
+#include "model/dog.h"
+#include "model/map.h"
+#include "utils/memory_usage.h"
+
+struct MapMemory {
+    model::Map::Id id;
+    size_t bytes = 0;
+};
+
+struct SessionMemory {
+    model::Map::Id map_id;
+    utils::MemoryUsage dogs;
+    utils::MemoryUsage loot;
+    // Dogs, loot, the session itself and its spatial indexes
+    size_t bytes = 0;
+};
+
+// Estimates, see utils/memory_usage.h for what they leave out
+struct MemoryReport {
+    std::vector<MapMemory> maps;
+    std::vector<SessionMemory> sessions;
+
+    // Totals by entity type. Dogs of retired players stay in their
+    // sessions, so there may be more dogs than players.
+    utils::MemoryUsage dogs;
+    utils::MemoryUsage loot;
+    utils::MemoryUsage players;
+    utils::MemoryUsage tokens;
+    // Interned dog names
+    utils::MemoryUsage names;
+
+    size_t total_bytes = 0;
+    // Dogs, players and tokens over the number of players
+    size_t bytes_per_player = 0;
+};
+
+class GetMemoryReportUseCase {
+   public:
+    explicit GetMemoryReportUseCase(
+        app::Game::Pointer game,
+        std::shared_ptr<app::PlayersCollection> players)
+        : game_(std::move(game)), players_(std::move(players)) {}
+
+    MemoryReport GetReport() const {
+        MemoryReport report;
+        for (const auto& map : game_->GetMaps()) {
+            report.maps.push_back({map->GetId(), map->GetMemoryBytes()});
+            report.total_bytes += report.maps.back().bytes;
+        }
+
+        for (const auto& session : game_->GetGameSessions()) {
+            SessionMemory memory{.map_id = session->GetMapId(),
+                                 .dogs = session->GetDogsMemory(),
+                                 .loot = session->GetLootMemory()};
+            memory.bytes = memory.dogs.bytes + memory.loot.bytes +
+                           session->GetOwnMemoryBytes();
+            report.dogs += memory.dogs;
+            report.loot += memory.loot;
+            report.total_bytes += memory.bytes;
+            report.sessions.push_back(std::move(memory));
+        }
+
+        const auto& names = model::Dog::GetNames();
+        report.players = players_->GetPlayersMemory();
+        report.tokens = players_->GetTokensMemory();
+        report.names = {.count = names.GetSize(),
+                        .bytes = names.GetMemoryBytes()};
+        report.total_bytes += report.players.bytes + report.tokens.bytes +
+                              report.names.bytes;
+        if (report.players.count > 0) {
+            report.bytes_per_player = (report.dogs.bytes +
+                                       report.players.bytes +
+                                       report.tokens.bytes) /
+                                      report.players.count;
+        }
+        return report;
+    }
+
+   private:
+    app::Game::Pointer game_;
+    std::shared_ptr<app::PlayersCollection> players_;
+};
@@ -34,6 +34,8 @@ class JoinGameUseCase {
           players_(players),
           spawn_point_generator_(is_random_spawn_point) {}
 
+    void Reseed(std::uint64_t seed) { spawn_point_generator_.Reseed(seed); }
+
     JoinGameResult Join(const model::Map::Id& map_id,
                         const std::string& user_name) {
         if (user_name.length() == 0) {
@@ -41,7 +43,11 @@ class JoinGameUseCase {
                                 JoinGameErrorReason::InvalidName);
         }
 
-        auto session = game_->FindGameSession(map_id);
+        // Sessions of maps removed by a config reload live on, but are
+        // closed for new players
+        auto session = game_->FindMap(map_id)
+                           ? game_->FindGameSession(map_id)
+                           : nullptr;
         if (!session) {
             session = game_->CreateGameSession(map_id);
         }
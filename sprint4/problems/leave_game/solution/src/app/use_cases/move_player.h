@@ -1,8 +1,12 @@
 #pragma once
 #include <memory>
 #include <string>
+#include <utility>
+#include <vector>
 
+#include "app/game/game_session.h"
 #include "app/player/players.h"
+#include "app/player/token_index.h"
 #include "app/token.h"
 #include "base.h"
 #include "model/model.h"
@@ -22,21 +26,57 @@ class MovePlayerError : public UseCaseError {
 
 class MovePlayerUseCase {
    public:
-    explicit MovePlayerUseCase(std::shared_ptr<app::PlayersCollection> players)
-        : players_(players) {}
+    // Moves can only be queued with token_index
+    explicit MovePlayerUseCase(
+        std::shared_ptr<app::PlayersCollection> players,
+        std::shared_ptr<const app::TokenIndex> token_index = nullptr)
+        : players_(players), token_index_(std::move(token_index)) {}
 
     void MovePlayer(const app::Token token, const model::Direction direction) {
         auto player = players_->Find(token);
 
         if (!player) {
-            throw MovePlayerError("unknownToken",
-                                  "Player token has not been found",
-                                  MovePlayerErrorReason::PlayerNotFound);
+            ThrowPlayerNotFound();
         }
 
         player->SetDirection(direction);
     }
 
+    // Checks the token and leaves the move in the inbox of the player's
+    // session. Safe to call from any thread.
+    void QueueMove(const app::Token& token,
+                   const model::Direction direction) const {
+        auto entry =
+            token_index_ ? token_index_->Find(*token) : std::nullopt;
+        if (!entry) {
+            ThrowPlayerNotFound();
+        }
+        entry->inbox->Push(entry->player, entry->token, direction);
+    }
+
+    // Applies the newest queued move of every player and reports it to
+    // on_move. Players that left since are skipped.
+    template <typename Fn>
+    void ApplyQueuedMoves(
+        const std::vector<app::GameSession::Pointer>& sessions,
+        Fn&& on_move) {
+        for (const auto& session : sessions) {
+            session->GetActionInbox()->Drain(
+                [this, &on_move](const app::PendingAction& action) {
+                    if (auto player = players_->Find(action.token)) {
+                        player->SetDirection(action.direction);
+                        on_move(action.token, action.direction);
+                    }
+                });
+        }
+    }
+
    private:
     std::shared_ptr<app::PlayersCollection> players_;
+    std::shared_ptr<const app::TokenIndex> token_index_;
+
+    [[noreturn]] static void ThrowPlayerNotFound() {
+        throw MovePlayerError("unknownToken", "Player token has not been found",
+                              MovePlayerErrorReason::PlayerNotFound);
+    }
 };
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <utility>
+
+#include "app/game/game.h"
+#include "loots/loot_handler.h"
+#include "loots/loot_number_map_handler.h"
+
+namespace app {
+
+// Applies maps, loot types and bag capacities of a reloaded config. Must
+// run on the strand that serves the API and ticks: readers share the loot
+// handlers with this use case, so replacing their contents there is seen
+// by everyone at once, between two ticks.
+class ReloadConfigUseCase {
+   public:
+    ReloadConfigUseCase(Game::Pointer game, LootHandler::Pointer loot_handler,
+                        LootNumberMapHandler::Pointer loot_number_map_handler)
+        : game_(std::move(game)),
+          loot_handler_(std::move(loot_handler)),
+          loot_number_map_handler_(std::move(loot_number_map_handler)) {}
+
+    MapsReloadResult Reload(
+        Game::Maps maps, const LootHandler& loot_handler,
+        const LootNumberMapHandler& loot_number_map_handler) {
+        auto result = game_->ReplaceMaps(std::move(maps));
+        *loot_handler_ = loot_handler;
+        *loot_number_map_handler_ = loot_number_map_handler;
+        return result;
+    }
+
+   private:
+    Game::Pointer game_;
+    LootHandler::Pointer loot_handler_;
+    LootNumberMapHandler::Pointer loot_number_map_handler_;
+};
+
+}  // namespace app
@@ -1,13 +1,27 @@
 #pragma once
 
+#include <chrono>
+#include <exception>
 #include <memory>
+#include <string>
+#include <utility>
+#include <vector>
 
+#include <boost/json/value.hpp>
 #include <boost/log/trivial.hpp>
 
 #include "app/game/game.h"
 #include "app/player/players.h"
 #include "postgres/unit_of_work.h"
+#include "utils/logger.h"
+#include "utils/profiler.h"
+#include "utils/timer_wheel.h"
 
+// Players wait in a timer wheel keyed by the earliest game time they could
+// retire at, which is when they would if they stood still from now on.
+// Moving only pushes that time back, so an entry that fires early is
+// checked and put back, and a tick touches only the players it retires or
+// reschedules instead of all of them.
 class CheckAFKProvider {
    public:
     CheckAFKProvider(app::Game::Pointer game,
@@ -15,37 +29,93 @@ class CheckAFKProvider {
                      std::shared_ptr<postgres::UnitOfWorkFactory> factory)
         : game_(game), players_(players), factory_(factory) {}
 
-    void CheckAFKPlayers() {
-        for (const auto& player : players_->GetPlayers()) {
-            if (player.IsAFK(game_->GetDogRetirementTime())) {
-                RemovePlayer(player);
+    // Replaying the action journal retires players that are already in the
+    // database, writes are turned off for it
+    void SetWriteRetired(bool write_retired) { write_retired_ = write_retired; }
+
+    // Called after the players have moved by delta_time. Returns the number
+    // of retired players.
+    size_t CheckAFKPlayers(std::chrono::milliseconds delta_time) {
+        PROFILE_SCOPE("CheckAFKProvider::CheckAFKPlayers");
+        const auto now = wheel_.GetTime() + delta_time.count();
+        for (auto token : players_->TakeNewPlayers()) {
+            if (auto player = players_->Find(token)) {
+                Schedule(token, *player, now);
             }
         }
+
+        std::vector<postgres::PlayerInfo> retired;
+        wheel_.Advance(now, [this, &retired, now](app::TokenKey token) {
+            auto player = players_->Find(token);
+            if (!player) {
+                return;
+            }
+            if (player->IsAFK(game_->GetDogRetirementTime())) {
+                retired.push_back(MakePlayerInfo(*player->GetDog()));
+                players_->Remove(player->GetId());
+            } else {
+                Schedule(token, *player, now);
+            }
+        });
+        const auto retired_count = retired.size();
+        if (write_retired_) {
+            WritePlayerInfos(std::move(retired));
+        }
+        return retired_count;
     }
 
    private:
     app::Game::Pointer game_;
     std::shared_ptr<app::PlayersCollection> players_;
     std::shared_ptr<postgres::UnitOfWorkFactory> factory_;
+    bool write_retired_ = true;
+    // Game time in ms
+    utils::TimerWheel<app::TokenKey> wheel_;
 
-    void RemovePlayer(const app::Player& player) {
-        auto player_id = player.GetId();
-        auto dog = player.GetDog();
-        players_->Remove(player_id);
+    void Schedule(app::TokenKey token, const app::Player& player,
+                  utils::TimerWheel<app::TokenKey>::Time now) {
+        const auto idle = player.GetDog()->GetLastMoveTime().count();
+        const auto retirement = game_->GetDogRetirementTime().count();
+        wheel_.Schedule(idle < retirement ? now + (retirement - idle) : now,
+                        token);
+    }
 
-        WritePlayerInfo(*dog);
+    static postgres::PlayerInfo MakePlayerInfo(const model::Dog& dog) {
+        return {.name = std::string(dog.GetName()),
+                .score = dog.GetScore(),
+                .time_in_game =
+                    std::chrono::duration_cast<std::chrono::duration<double>>(
+                        dog.GetTimeInGame())
+                        .count()};
     }
 
-    void WritePlayerInfo(const model::Dog& dog) {
-        postgres::PlayerInfo info{
-            .name = std::string(dog.GetName()),
-            .score = dog.GetScore(),
-            .time_in_game =
-                std::chrono::duration_cast<std::chrono::duration<double>>(
-                    dog.GetTimeInGame())
-                    .count()};
-        auto unit_of_work = factory_->CreateUnitOfWork();
-        unit_of_work->GetPlayers().Write(info);
-        unit_of_work->Commit();
+    // All players retired during a tick are written in one unit of work.
+    // The tick only hands them over, waiting for a connection and writing
+    // happen where the factory does its database work, so a slow or
+    // exhausted pool can't hold up the simulation.
+    void WritePlayerInfos(std::vector<postgres::PlayerInfo> infos) {
+        if (infos.empty()) {
+            return;
+        }
+        PROFILE_SCOPE("CheckAFKProvider::WritePlayerInfos");
+        factory_->AsyncCreateUnitOfWork(
+            [infos = std::move(infos)](
+                std::exception_ptr error,
+                std::unique_ptr<postgres::UnitOfWork> unit_of_work) {
+                try {
+                    if (error) {
+                        std::rethrow_exception(error);
+                    }
+                    unit_of_work->GetPlayers().WriteAll(infos);
+                    unit_of_work->Commit();
+                } catch (const std::exception& ex) {
+                    BOOST_LOG_TRIVIAL(error)
+                        << boost::log::add_value(
+                               additional_data,
+                               boost::json::value{{"exception", ex.what()},
+                                                  {"players", infos.size()}})
+                        << "retired players not written";
+                }
+            });
     }
 };
@@ -106,17 +106,25 @@ class Session : public SessionBase,
     }
 };
 
+// SO_REUSEPORT lets several acceptors bind the same port, the kernel then
+// spreads incoming connections between them
+using ReusePort =
+    net::detail::socket_option::boolean<SOL_SOCKET, SO_REUSEPORT>;
+
 template <typename RequestHandler>
 class Listener : public std::enable_shared_from_this<Listener<RequestHandler>> {
    public:
     template <typename Handler>
     Listener(net::io_context& ioc, const tcp::endpoint& endpoint,
-             Handler&& request_handler)
+             Handler&& request_handler, bool reuse_port = false)
         : ioc_(ioc),
           acceptor_(net::make_strand(ioc)),
           request_handler_(std::forward<Handler>(request_handler)) {
         acceptor_.open(endpoint.protocol());
         acceptor_.set_option(net::socket_base::reuse_address(true));
+        if (reuse_port) {
+            acceptor_.set_option(ReusePort(true));
+        }
         acceptor_.bind(endpoint);
         acceptor_.listen(net::socket_base::max_listen_connections);
     }
@@ -155,11 +163,11 @@ class Listener : public std::enable_shared_from_this<Listener<RequestHandler>> {
 
 template <typename RequestHandler>
 inline void ServeHttp(net::io_context& ioc, const tcp::endpoint& endpoint,
-                      RequestHandler&& handler) {
+                      RequestHandler&& handler, bool reuse_port = false) {
     using MyListener = Listener<std::decay_t<RequestHandler>>;
 
-    std::make_shared<MyListener>(ioc, endpoint,
-                                 std::forward<RequestHandler>(handler))
+    std::make_shared<MyListener>(
+        ioc, endpoint, std::forward<RequestHandler>(handler), reuse_port)
         ->Run();
 }
 
@@ -5,6 +5,14 @@
 
 #include <boost/utility/string_view.hpp>
 
+namespace {
+
+std::string_view ToStd(boost::string_view str) {
+    return {str.data(), str.size()};
+}
+
+}  // namespace
+
 struct MapFields {
     MapFields() = delete;
     constexpr static boost::string_view ID = "id";
@@ -50,6 +58,7 @@ struct GameStateFields {
     GameStateFields() = delete;
     constexpr static boost::string_view PLAYERS = "players";
     constexpr static boost::string_view LOST_OBJECTS = "lostObjects";
+    constexpr static boost::string_view OUT_OF_VIEW = "outOfView";
 };
 
 struct PlayerGameStateFields {
@@ -69,12 +78,36 @@ struct GameRecordFields {
     constexpr static boost::string_view PLAY_TIME = "playTime";
 };
 
+struct GameRecordsPageFields {
+    GameRecordsPageFields() = delete;
+    constexpr static boost::string_view RECORDS = "records";
+    constexpr static boost::string_view NEXT_CURSOR = "nextCursor";
+};
+
 struct ItemFields {
     constexpr static boost::string_view ID = "id";
     constexpr static boost::string_view TYPE = "type";
     constexpr static boost::string_view POS = "pos";
 };
 
+struct MemoryReportFields {
+    MemoryReportFields() = delete;
+    constexpr static boost::string_view TOTAL_BYTES = "totalBytes";
+    constexpr static boost::string_view BYTES_PER_PLAYER = "bytesPerPlayer";
+    constexpr static boost::string_view ENTITIES = "entities";
+    constexpr static boost::string_view DOGS = "dogs";
+    constexpr static boost::string_view LOOT = "loot";
+    constexpr static boost::string_view PLAYERS = "players";
+    constexpr static boost::string_view TOKENS = "tokens";
+    constexpr static boost::string_view NAMES = "names";
+    constexpr static boost::string_view MAPS = "maps";
+    constexpr static boost::string_view SESSIONS = "sessions";
+    constexpr static boost::string_view ID = "id";
+    constexpr static boost::string_view MAP_ID = "mapId";
+    constexpr static boost::string_view COUNT = "count";
+    constexpr static boost::string_view BYTES = "bytes";
+};
+
 boost::json::object json_converter::MapToJson(const model::Map& map) {
     boost::json::object main;
 
@@ -190,6 +223,12 @@ boost::json::object json_converter::GameStateToJson(
 
     main[GameStateFields::PLAYERS] = players;
     main[GameStateFields::LOST_OBJECTS] = lost_object;
+    if (game_state.out_of_view) {
+        main[GameStateFields::OUT_OF_VIEW] = boost::json::object{
+            {GameStateFields::PLAYERS, game_state.out_of_view->players},
+            {GameStateFields::LOST_OBJECTS,
+             game_state.out_of_view->lost_objects}};
+    }
 
     return main;
 }
@@ -221,11 +260,205 @@ boost::json::object json_converter::GameRecordToJson(
         {GameRecordFields::PLAY_TIME, game_record.time_in_game}};
 }
 
-model::Map::Pointer json_converter::JsonToMap(const json::object map_json) {
+boost::json::object json_converter::GameRecordsPageToJson(
+    const GameRecordsPage& page) {
+    boost::json::array records;
+    records.reserve(page.records.size());
+    for (const auto& record : page.records) {
+        records.push_back(GameRecordToJson(record));
+    }
+
+    boost::json::object result{{GameRecordsPageFields::RECORDS, records}};
+    if (!page.next_cursor.empty()) {
+        result[GameRecordsPageFields::NEXT_CURSOR] = page.next_cursor;
+    }
+    return result;
+}
+
+boost::json::object json_converter::MemoryUsageToJson(
+    const utils::MemoryUsage& usage) {
+    return boost::json::object{{MemoryReportFields::COUNT, usage.count},
+                               {MemoryReportFields::BYTES, usage.bytes}};
+}
+
+boost::json::object json_converter::MemoryReportToJson(
+    const MemoryReport& report) {
+    boost::json::array maps;
+    for (const auto& map : report.maps) {
+        maps.push_back(boost::json::object{{MemoryReportFields::ID, *map.id},
+                                           {MemoryReportFields::BYTES,
+                                            map.bytes}});
+    }
+    boost::json::array sessions;
+    for (const auto& session : report.sessions) {
+        sessions.push_back(boost::json::object{
+            {MemoryReportFields::MAP_ID, *session.map_id},
+            {MemoryReportFields::BYTES, session.bytes},
+            {MemoryReportFields::DOGS, MemoryUsageToJson(session.dogs)},
+            {MemoryReportFields::LOOT, MemoryUsageToJson(session.loot)}});
+    }
+
+    return boost::json::object{
+        {MemoryReportFields::TOTAL_BYTES, report.total_bytes},
+        {MemoryReportFields::BYTES_PER_PLAYER, report.bytes_per_player},
+        {MemoryReportFields::ENTITIES,
+         boost::json::object{
+             {MemoryReportFields::DOGS, MemoryUsageToJson(report.dogs)},
+             {MemoryReportFields::LOOT, MemoryUsageToJson(report.loot)},
+             {MemoryReportFields::PLAYERS, MemoryUsageToJson(report.players)},
+             {MemoryReportFields::TOKENS, MemoryUsageToJson(report.tokens)},
+             {MemoryReportFields::NAMES, MemoryUsageToJson(report.names)}}},
+        {MemoryReportFields::MAPS, maps},
+        {MemoryReportFields::SESSIONS, sessions}};
+}
+
+template <typename Writer>
+void json_converter::WritePlayerInfos(
+    Writer& writer, const std::vector<PlayerInfo>& player_infos) {
+    writer.BeginArray();
+    for (const auto& player_info : player_infos) {
+        // PlayerInfoToJson builds {NAME, name} as a two element array, the
+        // API has always answered that way
+        writer.BeginObject()
+            .Key(std::to_string(*player_info.id))
+            .BeginArray()
+            .String(ToStd(PlayerInfoFields::NAME))
+            .String(player_info.name)
+            .EndArray()
+            .EndObject();
+    }
+    writer.EndArray();
+}
+
+namespace {
+
+template <typename Writer>
+void WriteCoordinate(Writer& writer, model::Coordinate coord) {
+    writer.BeginArray().Number(coord.x).Number(coord.y).EndArray();
+}
+
+template <typename Writer>
+void WritePlayerGameState(Writer& writer,
+                          const PlayerGameState& player_game_state) {
+    writer.BeginObject().Key(ToStd(PlayerGameStateFields::POSITION));
+    WriteCoordinate(writer, player_game_state.position);
+    writer.Key(ToStd(PlayerGameStateFields::VELOCITY));
+    WriteCoordinate(writer, player_game_state.velocity);
+    writer.Key(ToStd(PlayerGameStateFields::DIRECTION))
+        .String(
+            model::direction_converter::ToString(player_game_state.direction))
+        .Key(ToStd(PlayerGameStateFields::BAG))
+        .BeginArray();
+    for (const auto& item : player_game_state.items) {
+        writer.BeginObject()
+            .Key(ToStd(ItemFields::ID))
+            .Number(*item.id)
+            .Key(ToStd(ItemFields::TYPE))
+            .Number(item.type)
+            .EndObject();
+    }
+    writer.EndArray()
+        .Key(ToStd(PlayerGameStateFields::SCORE))
+        .Number(player_game_state.score)
+        .EndObject();
+}
+
+}  // namespace
+
+template <typename Writer>
+void json_converter::WriteGameState(Writer& writer,
+                                    const GameState& game_state) {
+    writer.BeginObject().Key(ToStd(GameStateFields::PLAYERS)).BeginObject();
+    for (const auto& player : game_state.player_coord_infos) {
+        writer.Key(std::to_string(*player.id));
+        WritePlayerGameState(writer, player);
+    }
+    writer.EndObject().Key(ToStd(GameStateFields::LOST_OBJECTS)).BeginObject();
+    for (size_t i = 0; i < game_state.lost_objects.size(); i++) {
+        const auto& item = game_state.lost_objects[i];
+        writer.Key(std::to_string(i))
+            .BeginObject()
+            .Key(ToStd(ItemFields::TYPE))
+            .Number(item.type)
+            .Key(ToStd(ItemFields::POS));
+        WriteCoordinate(writer, item.position);
+        writer.EndObject();
+    }
+    writer.EndObject();
+    if (game_state.out_of_view) {
+        writer.Key(ToStd(GameStateFields::OUT_OF_VIEW))
+            .BeginObject()
+            .Key(ToStd(GameStateFields::PLAYERS))
+            .Number(game_state.out_of_view->players)
+            .Key(ToStd(GameStateFields::LOST_OBJECTS))
+            .Number(game_state.out_of_view->lost_objects)
+            .EndObject();
+    }
+    writer.EndObject();
+}
+
+template <typename Writer>
+void json_converter::WriteGameRecord(Writer& writer,
+                                     const GameRecord& game_record) {
+    writer.BeginObject()
+        .Key(ToStd(GameRecordFields::NAME))
+        .String(game_record.name)
+        .Key(ToStd(GameRecordFields::SCORE))
+        .Number(game_record.score)
+        .Key(ToStd(GameRecordFields::PLAY_TIME))
+        .Number(game_record.time_in_game)
+        .EndObject();
+}
+
+template <typename Writer>
+void json_converter::WriteGameRecords(
+    Writer& writer, const std::vector<GameRecord>& game_records) {
+    writer.BeginArray();
+    for (const auto& record : game_records) {
+        WriteGameRecord(writer, record);
+    }
+    writer.EndArray();
+}
+
+template <typename Writer>
+void json_converter::WriteGameRecordsPage(Writer& writer,
+                                          const GameRecordsPage& page) {
+    writer.BeginObject().Key(ToStd(GameRecordsPageFields::RECORDS));
+    WriteGameRecords(writer, page.records);
+    if (!page.next_cursor.empty()) {
+        writer.Key(ToStd(GameRecordsPageFields::NEXT_CURSOR))
+            .String(page.next_cursor);
+    }
+    writer.EndObject();
+}
+
+template void json_converter::WritePlayerInfos(
+    utils::JsonWriter& writer, const std::vector<PlayerInfo>& player_infos);
+template void json_converter::WriteGameState(utils::JsonWriter& writer,
+                                             const GameState& game_state);
+template void json_converter::WriteGameRecord(utils::JsonWriter& writer,
+                                              const GameRecord& game_record);
+template void json_converter::WriteGameRecords(
+    utils::JsonWriter& writer, const std::vector<GameRecord>& game_records);
+template void json_converter::WriteGameRecordsPage(
+    utils::JsonWriter& writer, const GameRecordsPage& page);
+
+template void json_converter::WritePlayerInfos(
+    utils::CborWriter& writer, const std::vector<PlayerInfo>& player_infos);
+template void json_converter::WriteGameState(utils::CborWriter& writer,
+                                             const GameState& game_state);
+template void json_converter::WriteGameRecord(utils::CborWriter& writer,
+                                              const GameRecord& game_record);
+template void json_converter::WriteGameRecords(
+    utils::CborWriter& writer, const std::vector<GameRecord>& game_records);
+template void json_converter::WriteGameRecordsPage(
+    utils::CborWriter& writer, const GameRecordsPage& page);
+
+model::Map::Pointer json_converter::JsonToMap(const json::object& map_json) {
     std::optional<double> dog_speed = std::nullopt;
     if (auto dog_speed_it = map_json.find(MapFields::DOG_SPEED);
         dog_speed_it != map_json.end()) {
-        dog_speed = dog_speed_it->value().as_double();
+        dog_speed = dog_speed_it->value().to_number<double>();
     }
     auto roads = JsonToRoads(map_json.at(MapFields::ROADS).as_array());
 
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <string>
 #include <vector>
 
 #include <boost/json.hpp>
@@ -7,9 +8,12 @@
 
 #include "app/use_cases/get_game_records_use_case.h"
 #include "app/use_cases/get_game_state_use_case.h"
+#include "app/use_cases/get_memory_report_use_case.h"
 #include "app/use_cases/list_player_use_case.h"
 #include "model/item.h"
 #include "model/model.h"
+#include "utils/cbor_writer.h"
+#include "utils/json_writer.h"
 
 namespace json_converter {
 namespace json = boost::json;
@@ -40,8 +44,45 @@ boost::json::object PlayerGameStateToJson(
     const PlayerGameState& player_game_state);
 
 boost::json::object GameRecordToJson(const GameRecord& game_record);
-
-model::Map::Pointer JsonToMap(const json::object map_json);
+boost::json::object GameRecordsPageToJson(const GameRecordsPage& page);
+
+boost::json::object MemoryUsageToJson(const utils::MemoryUsage& usage);
+boost::json::object MemoryReportToJson(const MemoryReport& report);
+
+// Streaming counterparts of the functions above for API responses. Each
+// is the one description of its document for every encoding: with
+// utils::JsonWriter it produces the same bytes as serializing the DOM,
+// with utils::CborWriter the same document in CBOR. Instantiated for both
+// writers in json_converter.cpp.
+template <typename Writer>
+void WritePlayerInfos(Writer& writer,
+                      const std::vector<PlayerInfo>& player_infos);
+
+template <typename Writer>
+void WriteGameState(Writer& writer, const GameState& game_state);
+
+template <typename Writer>
+void WriteGameRecord(Writer& writer, const GameRecord& game_record);
+
+template <typename Writer>
+void WriteGameRecords(Writer& writer,
+                      const std::vector<GameRecord>& game_records);
+
+template <typename Writer>
+void WriteGameRecordsPage(Writer& writer, const GameRecordsPage& page);
+
+// Runs write on a writer over a new string and returns the string. The
+// writer is JSON unless given explicitly.
+template <typename Writer = utils::JsonWriter, typename... Args>
+std::string Serialize(void (*write)(Writer&, const Args&...),
+                      const Args&... args) {
+    std::string result;
+    Writer writer{result};
+    write(writer, args...);
+    return result;
+}
+
+model::Map::Pointer JsonToMap(const json::object& map_json);
 
 model::Map::Roads JsonToRoads(const json::array roads_json);
 
@@ -1,13 +1,18 @@
 #include "json_loader.h"
 
+#include <algorithm>
 #include <chrono>
+#include <cstdint>
 #include <deque>
 #include <fstream>
+#include <limits>
 #include <memory>
+#include <optional>
 #include <ratio>
-#include <sstream>
 #include <stdexcept>
 #include <string>
+#include <string_view>
+#include <unordered_set>
 #include <utility>
 
 #include <boost/json.hpp>
@@ -20,50 +25,272 @@
 
 namespace json_loader {
 
-boost::json::object ParseJson(const std::filesystem::path& json_path) {
-    std::ifstream json_input_stream(json_path);
+namespace {
+
+namespace json = boost::json;
+using namespace std::literals;
+
+std::string TextPosition(std::string_view text, size_t offset) {
+    offset = std::min(offset, text.size());
+    const auto before = text.substr(0, offset);
+    const auto line = std::count(before.begin(), before.end(), '\n') + 1;
+    const auto line_start = before.rfind('\n');
+    const auto column = line_start == std::string_view::npos
+                            ? offset + 1
+                            : offset - line_start;
+    return std::to_string(line) + ":" + std::to_string(column);
+}
+
+json::value ParseJson(std::string_view text) {
+    json::stream_parser parser;
     boost::system::error_code ec;
-    if (!json_input_stream.is_open()) {
-        throw std::runtime_error("Incorrect input file");
+    const auto consumed = parser.write_some(text.data(), text.size(), ec);
+    if (ec) {
+        throw ConfigError(TextPosition(text, consumed), ec.message());
+    }
+    if (const auto extra = text.find_first_not_of(" \t\r\n", consumed);
+        extra != std::string_view::npos) {
+        throw ConfigError(TextPosition(text, extra),
+                          "unexpected characters after the document"s);
+    }
+    parser.finish(ec);
+    if (ec) {
+        throw ConfigError(TextPosition(text, text.size()), ec.message());
     }
+    return parser.release();
+}
 
-    std::stringstream buffer;
-    buffer << json_input_stream.rdbuf();
-    std::string jsonString = buffer.str();
+// Checks the config against the schema the loader relies on, so building
+// the objects afterwards can not fail halfway
+class ConfigValidator {
+   public:
+    void Validate(const json::value& config) {
+        const auto& root = RequireObject(config, "$"s);
+        OptionalNumber(root, "defaultDogSpeed", "$"s, 0.0);
+        OptionalNumber(root, "dogRetirementTime", "$"s, 0.0);
+        OptionalInt(root, "defaultBagCapacity", "$"s, 0);
 
-    auto value = boost::json::parse(jsonString, ec);
+        const auto& loot_config = RequireObject(
+            Require(root, "lootGeneratorConfig", "$"s),
+            "$.lootGeneratorConfig"s);
+        RequireNumber(loot_config, "period", "$.lootGeneratorConfig"s, 0.0);
+        RequireNumber(loot_config, "probability", "$.lootGeneratorConfig"s,
+                      0.0, 1.0);
 
-    if (ec) {
-        throw std::runtime_error("Incorrect input file");
+        if (const auto* limits = root.if_contains("rateLimits")) {
+            ValidateRateLimits(*limits, "$.rateLimits"s);
+        }
+
+        const auto& maps =
+            RequireArray(Require(root, "maps", "$"s), "$.maps"s);
+        for (size_t i = 0; i < maps.size(); ++i) {
+            ValidateMap(maps[i], Element("$.maps"s, i));
+        }
     }
 
-    return value.as_object();
-}
+   private:
+    std::unordered_set<std::string> map_ids_;
 
-app::Game::Pointer LoadGame(const std::filesystem::path& json_path) {
-    auto json_object = ParseJson(json_path);
+    void ValidateRateLimits(const json::value& value,
+                            const std::string& path) {
+        const auto& limits = RequireObject(value, path);
+        for (const std::string_view key : {"perToken"sv, "perIp"sv}) {
+            const auto* bucket =
+                limits.if_contains(json::string_view(key.data(), key.size()));
+            if (!bucket) {
+                continue;
+            }
+            const auto bucket_path = Member(path, key);
+            const auto& bucket_object = RequireObject(*bucket, bucket_path);
+            RequireNumber(bucket_object, "rate", bucket_path, 0.01);
+            RequireNumber(bucket_object, "burst", bucket_path, 1.0,
+                          utils::RateLimiter::MAX_BURST);
+        }
+        OptionalInt(limits, "maxApiQueue", path, 1);
+    }
+
+    void ValidateMap(const json::value& value, const std::string& path) {
+        const auto& map = RequireObject(value, path);
+        const auto id = RequireString(map, "id", path);
+        if (!map_ids_.insert(id).second) {
+            throw ConfigError(Member(path, "id"),
+                              "duplicate map id \""s + id + "\"");
+        }
+        RequireString(map, "name", path);
+        OptionalNumber(map, "dogSpeed", path, 0.0);
+        OptionalInt(map, "bagCapacity", path, 0);
+
+        const auto roads_path = Member(path, "roads");
+        const auto& roads =
+            RequireArray(Require(map, "roads", path), roads_path);
+        if (roads.empty()) {
+            throw ConfigError(roads_path, "a map needs at least one road"s);
+        }
+        for (size_t i = 0; i < roads.size(); ++i) {
+            ValidateRoad(roads[i], Element(roads_path, i));
+        }
+
+        const auto buildings_path = Member(path, "buildings");
+        const auto& buildings =
+            RequireArray(Require(map, "buildings", path), buildings_path);
+        for (size_t i = 0; i < buildings.size(); ++i) {
+            const auto building_path = Element(buildings_path, i);
+            const auto& building = RequireObject(buildings[i], building_path);
+            for (auto key : {"x", "y", "w", "h"}) {
+                RequireInt(building, key, building_path);
+            }
+        }
+
+        const auto offices_path = Member(path, "offices");
+        const auto& offices =
+            RequireArray(Require(map, "offices", path), offices_path);
+        for (size_t i = 0; i < offices.size(); ++i) {
+            const auto office_path = Element(offices_path, i);
+            const auto& office = RequireObject(offices[i], office_path);
+            RequireString(office, "id", office_path);
+            for (auto key : {"x", "y", "offsetX", "offsetY"}) {
+                RequireInt(office, key, office_path);
+            }
+        }
+
+        const auto loot_types_path = Member(path, "lootTypes");
+        const auto& loot_types =
+            RequireArray(Require(map, "lootTypes", path), loot_types_path);
+        if (loot_types.empty()) {
+            throw ConfigError(loot_types_path,
+                              "a map needs at least one loot type"s);
+        }
+        for (size_t i = 0; i < loot_types.size(); ++i) {
+            const auto loot_type_path = Element(loot_types_path, i);
+            RequireInt(RequireObject(loot_types[i], loot_type_path), "value",
+                       loot_type_path);
+        }
+    }
+
+    void ValidateRoad(const json::value& value, const std::string& path) {
+        const auto& road = RequireObject(value, path);
+        RequireInt(road, "x0", path);
+        RequireInt(road, "y0", path);
+        const bool has_x1 = road.contains("x1");
+        const bool has_y1 = road.contains("y1");
+        if (has_x1 == has_y1) {
+            throw ConfigError(path,
+                              "a road needs exactly one of \"x1\" or \"y1\""s);
+        }
+        RequireInt(road, has_x1 ? "x1" : "y1", path);
+    }
+
+    static std::string Member(const std::string& path, std::string_view key) {
+        return path + "." + std::string(key);
+    }
+
+    static std::string Element(const std::string& path, size_t index) {
+        return path + "[" + std::to_string(index) + "]";
+    }
+
+    static const json::value& Require(const json::object& object,
+                                      std::string_view key,
+                                      const std::string& path) {
+        if (const auto* value = object.if_contains(
+                json::string_view(key.data(), key.size()))) {
+            return *value;
+        }
+        throw ConfigError(path,
+                          "missing required field \""s + std::string(key) +
+                              "\"");
+    }
+
+    static const json::object& RequireObject(const json::value& value,
+                                             const std::string& path) {
+        if (const auto* object = value.if_object()) {
+            return *object;
+        }
+        throw ConfigError(path, "expected an object"s);
+    }
+
+    static const json::array& RequireArray(const json::value& value,
+                                           const std::string& path) {
+        if (const auto* array = value.if_array()) {
+            return *array;
+        }
+        throw ConfigError(path, "expected an array"s);
+    }
+
+    static std::string RequireString(const json::object& object,
+                                     std::string_view key,
+                                     const std::string& path) {
+        const auto& value = Require(object, key, path);
+        if (const auto* str = value.if_string()) {
+            return std::string(str->data(), str->size());
+        }
+        throw ConfigError(Member(path, key), "expected a string"s);
+    }
+
+    static void CheckInt(const json::value& value, const std::string& path,
+                         std::int64_t min) {
+        if (!value.is_int64()) {
+            throw ConfigError(path, "expected an integer"s);
+        }
+        const auto number = value.as_int64();
+        if (number < min || number > std::numeric_limits<int>::max()) {
+            throw ConfigError(path, "integer out of range"s);
+        }
+    }
+
+    static void RequireInt(
+        const json::object& object, std::string_view key,
+        const std::string& path,
+        std::int64_t min = std::numeric_limits<int>::min()) {
+        CheckInt(Require(object, key, path), Member(path, key), min);
+    }
+
+    static void OptionalInt(const json::object& object, std::string_view key,
+                            const std::string& path, std::int64_t min) {
+        if (object.contains(json::string_view(key.data(), key.size()))) {
+            RequireInt(object, key, path, min);
+        }
+    }
+
+    static void CheckNumber(const json::value& value, const std::string& path,
+                            double min, double max) {
+        if (!value.is_int64() && !value.is_uint64() && !value.is_double()) {
+            throw ConfigError(path, "expected a number"s);
+        }
+        const auto number = value.to_number<double>();
+        if (number < min || number > max) {
+            throw ConfigError(path, "number out of range"s);
+        }
+    }
+
+    static void RequireNumber(
+        const json::object& object, std::string_view key,
+        const std::string& path, double min,
+        double max = std::numeric_limits<double>::max()) {
+        CheckNumber(Require(object, key, path), Member(path, key), min, max);
+    }
+
+    static void OptionalNumber(const json::object& object,
+                               std::string_view key, const std::string& path,
+                               double min) {
+        if (object.contains(json::string_view(key.data(), key.size()))) {
+            RequireNumber(object, key, path, min);
+        }
+    }
+};
+
+app::Game::Pointer BuildGame(const json::object& config,
+                             const app::Game::Maps& maps) {
     double default_dog_speed = 1.0;
-    if (auto default_dog_speed_it = json_object.find("defaultDogSpeed");
-        default_dog_speed_it != json_object.end()) {
-        default_dog_speed = default_dog_speed_it->value().as_double();
+    if (const auto* value = config.if_contains("defaultDogSpeed")) {
+        default_dog_speed = value->to_number<double>();
     }
 
     std::chrono::milliseconds dog_retirement_time =
         app::detail::DEFAULT_DOG_RETIREMENT_TIME;
-    if (auto dog_retirement_time_it = json_object.find("dogRetirementTime");
-        dog_retirement_time_it != json_object.end()) {
+    if (const auto* value = config.if_contains("dogRetirementTime")) {
         dog_retirement_time =
             std::chrono::duration_cast<std::chrono::milliseconds>(
-                std::chrono::duration<double>(
-                    dog_retirement_time_it->value().as_double()));
-    }
-
-    auto maps_json = json_object["maps"].as_array();
-    std::deque<model::Map::Pointer> maps;
-    for (const auto& map_json : maps_json) {
-        const auto map_json_object = map_json.as_object();
-        model::Map::Pointer map = json_converter::JsonToMap(map_json_object);
-        maps.push_back(map);
+                std::chrono::duration<double>(value->to_number<double>()));
     }
 
     return std::make_shared<app::Game>(
@@ -71,37 +298,61 @@ app::Game::Pointer LoadGame(const std::filesystem::path& json_path) {
         dog_retirement_time);
 }
 
-loot_gen::LootGenerator::Pointer LoadLootGenerator(
-    const std::filesystem::path& json_path) {
-    auto json_object = ParseJson(json_path);
-    auto lootGeneratorConfigObject =
-        json_object["lootGeneratorConfig"].as_object();
-    double period = lootGeneratorConfigObject["period"].as_double();
+loot_gen::LootGenerator::Pointer BuildLootGenerator(
+    const json::object& config) {
+    const auto& loot_config = config.at("lootGeneratorConfig").as_object();
+    double period = loot_config.at("period").to_number<double>();
     auto time_interval =
         loot_gen::LootGenerator::TimeInterval(static_cast<int>(period));
 
     return std::make_shared<loot_gen::LootGenerator>(
-        time_interval, lootGeneratorConfigObject["probability"].as_double(),
+        time_interval, loot_config.at("probability").to_number<double>(),
         loot_gen::LootGenerator::TimeInterval(0));
 }
 
-LootHandler::Pointer LoadLootHandler(const std::filesystem::path& json_path) {
-    auto json_object = ParseJson(json_path);
+utils::RateLimitConfig BuildRateLimits(const json::object& config) {
+    utils::RateLimitConfig rate_limits;
+    const auto* limits_json = config.if_contains("rateLimits");
+    if (!limits_json) {
+        return rate_limits;
+    }
 
-    auto maps_json = json_object["maps"].as_array();
+    const auto& limits = limits_json->as_object();
+    auto read_bucket = [&limits](std::string_view key)
+        -> std::optional<utils::TokenBucketLimit> {
+        const auto* bucket =
+            limits.if_contains(json::string_view(key.data(), key.size()));
+        if (!bucket) {
+            return std::nullopt;
+        }
+        const auto& bucket_object = bucket->as_object();
+        return utils::TokenBucketLimit{
+            .rate = bucket_object.at("rate").to_number<double>(),
+            .burst = bucket_object.at("burst").to_number<double>()};
+    };
+    rate_limits.per_token = read_bucket("perToken");
+    rate_limits.per_ip = read_bucket("perIp");
+    if (const auto* value = limits.if_contains("maxApiQueue")) {
+        rate_limits.max_api_queue = static_cast<size_t>(value->as_int64());
+    }
+    return rate_limits;
+}
+
+LootHandler::Pointer BuildLootHandler(const json::array& maps_json,
+                                      const app::Game::Maps& maps) {
     LootHandler::LootTypeByMap loot_types_by_map;
     LootHandler::LootTypeScoreByMap loot_type_score_by_map;
-    for (const auto& map_json : maps_json) {
-        auto map_json_object = map_json.as_object();
-        model::Map::Id map_id =
-            json_converter::JsonToMap(map_json_object)->GetId();
-        auto loot_types_array = map_json_object["lootTypes"].as_array();
+    for (size_t i = 0; i < maps.size(); ++i) {
+        const auto& map_id = maps[i]->GetId();
+        const auto& loot_types_array =
+            maps_json[i].as_object().at("lootTypes").as_array();
         loot_types_by_map.emplace(map_id, loot_types_array);
 
+        auto& scores = loot_type_score_by_map[map_id];
+        scores.reserve(loot_types_array.size());
         for (const auto& loot_type_el : loot_types_array) {
-            auto el_obj = loot_type_el.as_object();
-            loot_type_score_by_map[map_id].push_back(
-                el_obj["value"].as_int64());
+            scores.push_back(static_cast<int>(
+                loot_type_el.as_object().at("value").as_int64()));
         }
     }
 
@@ -109,26 +360,20 @@ LootHandler::Pointer LoadLootHandler(const std::filesystem::path& json_path) {
                                          std::move(loot_type_score_by_map));
 }
 
-LootNumberMapHandler::Pointer LoadNumberMapHandler(
-    const std::filesystem::path& json_path) {
-    auto json_object = ParseJson(json_path);
-
+LootNumberMapHandler::Pointer BuildNumberMapHandler(
+    const json::object& config, const json::array& maps_json,
+    const app::Game::Maps& maps) {
     int base_loot_max_number = 3;
-    if (auto it = json_object.find("defaultBagCapacity");
-        it != json_object.end()) {
-        base_loot_max_number = json_object["defaultBagCapacity"].as_int64();
+    if (const auto* value = config.if_contains("defaultBagCapacity")) {
+        base_loot_max_number = static_cast<int>(value->as_int64());
     }
 
     LootNumberMapHandler::LootNumberByMap max_loot_number_by_map;
-
-    auto maps_json = json_object["maps"].as_array();
-    for (const auto& map_json : maps_json) {
-        auto map_json_object = map_json.as_object();
-        model::Map::Id map_id =
-            json_converter::JsonToMap(map_json_object)->GetId();
-        if (auto it = map_json_object.find("bagCapacity");
-            it != map_json_object.end()) {
-            max_loot_number_by_map.emplace(map_id, it->value().as_int64());
+    for (size_t i = 0; i < maps.size(); ++i) {
+        if (const auto* value =
+                maps_json[i].as_object().if_contains("bagCapacity")) {
+            max_loot_number_by_map.emplace(maps[i]->GetId(),
+                                           value->as_int64());
         }
     }
 
@@ -136,4 +381,75 @@ LootNumberMapHandler::Pointer LoadNumberMapHandler(
         std::move(max_loot_number_by_map), base_loot_max_number);
 }
 
+}  // namespace
+
+std::string ReadConfigFile(const std::filesystem::path& json_path) {
+    std::ifstream input(json_path, std::ios::binary);
+    if (!input.is_open()) {
+        throw ConfigError(json_path.string(), "can't open the file"s);
+    }
+
+    std::error_code ec;
+    const auto size = std::filesystem::file_size(json_path, ec);
+    if (ec) {
+        throw ConfigError(json_path.string(), ec.message());
+    }
+
+    std::string text(size, '\0');
+    if (!input.read(text.data(), static_cast<std::streamsize>(size))) {
+        throw ConfigError(json_path.string(), "can't read the file"s);
+    }
+    return text;
+}
+
+std::uint64_t HashConfig(std::string_view text) {
+    std::uint64_t hash = 14695981039346656037ull;
+    for (unsigned char c : text) {
+        hash ^= c;
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+Config ParseConfig(std::string_view text) {
+    const auto document = ParseJson(text);
+    ConfigValidator{}.Validate(document);
+
+    const auto& config = document.as_object();
+    const auto& maps_json = config.at("maps").as_array();
+    app::Game::Maps maps;
+    for (const auto& map_json : maps_json) {
+        maps.push_back(json_converter::JsonToMap(map_json.as_object()));
+    }
+
+    return {.game = BuildGame(config, maps),
+            .loot_generator = BuildLootGenerator(config),
+            .loot_handler = BuildLootHandler(maps_json, maps),
+            .loot_number_map_handler =
+                BuildNumberMapHandler(config, maps_json, maps),
+            .rate_limits = BuildRateLimits(config)};
+}
+
+Config LoadConfig(const std::filesystem::path& json_path) {
+    return ParseConfig(ReadConfigFile(json_path));
+}
+
+app::Game::Pointer LoadGame(const std::filesystem::path& json_path) {
+    return LoadConfig(json_path).game;
+}
+
+loot_gen::LootGenerator::Pointer LoadLootGenerator(
+    const std::filesystem::path& json_path) {
+    return LoadConfig(json_path).loot_generator;
+}
+
+LootHandler::Pointer LoadLootHandler(const std::filesystem::path& json_path) {
+    return LoadConfig(json_path).loot_handler;
+}
+
+LootNumberMapHandler::Pointer LoadNumberMapHandler(
+    const std::filesystem::path& json_path) {
+    return LoadConfig(json_path).loot_number_map_handler;
+}
+
 }  // namespace json_loader
@@ -1,14 +1,64 @@
 #pragma once
 
+#include <cstdint>
 #include <filesystem>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
 
 #include "app/game/game.h"
 #include "loots/loot_generator.h"
 #include "loots/loot_handler.h"
 #include "loots/loot_number_map_handler.h"
+#include "utils/rate_limiter.h"
 
 namespace json_loader {
 
+// Thrown for unreadable, malformed or invalid configs. The message starts
+// with the location of the problem: "line:column" for syntax errors and a
+// JSON path like "maps[1].roads[3]" for schema errors.
+class ConfigError : public std::runtime_error {
+   public:
+    ConfigError(std::string location, const std::string& message)
+        : std::runtime_error(location + ": " + message),
+          location_(std::move(location)) {}
+
+    const std::string& GetLocation() const noexcept { return location_; }
+
+   private:
+    std::string location_;
+};
+
+// Everything the application builds from the config file
+struct Config {
+    app::Game::Pointer game;
+    loot_gen::LootGenerator::Pointer loot_generator;
+    LootHandler::Pointer loot_handler;
+    LootNumberMapHandler::Pointer loot_number_map_handler;
+    // Limits not set in the config stay off, the shipped config sets none.
+    // Each one is optional. Rates are requests per second, bursts are
+    // requests:
+    //   "rateLimits": {
+    //     "perToken": {"rate": 100.0, "burst": 200.0},
+    //     "perIp": {"rate": 50000.0, "burst": 50000.0},
+    //     "maxApiQueue": 10000
+    //   }
+    utils::RateLimitConfig rate_limits;
+};
+
+// Reads the whole file with a single read into a pre-sized buffer
+std::string ReadConfigFile(const std::filesystem::path& json_path);
+
+// FNV-1a of the config text, identifies the config a cache was built from
+std::uint64_t HashConfig(std::string_view text);
+
+// Parses and validates the text once and builds every config object from
+// the same document
+Config ParseConfig(std::string_view text);
+
+Config LoadConfig(const std::filesystem::path& json_path);
+
 app::Game::Pointer LoadGame(const std::filesystem::path& json_path);
 
 loot_gen::LootGenerator::Pointer LoadLootGenerator(
@@ -1,17 +1,35 @@
 #pragma once
+#include <algorithm>
 #include <cassert>
 #include <chrono>
+#include <cmath>
+#include <cstdint>
 #include <functional>
 #include <memory>
+#include <random>
+#include <type_traits>
 #include <utility>
 
 namespace loot_gen {
 
-class LootGenerator {
+/*
+ * Источник случайных чисел по умолчанию: всегда возвращает 1, поэтому
+ * количество трофеев зависит только от прошедшего времени
+ */
+struct ConstantRandom {
+    double operator()() const noexcept { return 1.0; }
+};
+
+/*
+ * RandomGenerator - вызываемый объект, возвращающий псевдослучайное число в
+ * диапазоне [0, 1]. Хранится по значению и вызывается без косвенности, если
+ * это не std::function
+ */
+template <typename RandomGenerator>
+class BasicLootGenerator {
    public:
-    using RandomGenerator = std::function<double()>;
     using TimeInterval = std::chrono::milliseconds;
-    using Pointer = std::shared_ptr<LootGenerator>;
+    using Pointer = std::shared_ptr<BasicLootGenerator>;
 
     /*
      * base_interval - базовый отрезок времени > 0
@@ -19,9 +37,9 @@ class LootGenerator {
      * времени random_generator - генератор псевдослучайных чисел в диапазоне от
      * [0 до 1]
      */
-    LootGenerator(TimeInterval base_interval, double probability,
-                  TimeInterval time_without_loot,
-                  RandomGenerator random_gen = DefaultGenerator)
+    BasicLootGenerator(TimeInterval base_interval, double probability,
+                       TimeInterval time_without_loot,
+                       RandomGenerator random_gen = DefaultGenerator())
         : base_interval_{base_interval},
           probability_{probability},
           time_without_loot_(time_without_loot),
@@ -41,18 +59,79 @@ class LootGenerator {
      * looter_count - количество мародёров на карте
      */
     unsigned Generate(TimeInterval time_delta, unsigned loot_count,
-                      unsigned looter_count);
+                      unsigned looter_count) {
+        time_without_loot_ += time_delta;
+        const unsigned loot_shortage =
+            loot_count > looter_count ? 0u : looter_count - loot_count;
+        const double ratio =
+            std::chrono::duration<double>{time_without_loot_} / base_interval_;
+        const double probability = std::clamp(
+            (1.0 - std::pow(1.0 - probability_, ratio)) * random_generator_(),
+            0.0, 1.0);
+        const unsigned generated_loot =
+            static_cast<unsigned>(std::round(loot_shortage * probability));
+        if (generated_loot > 0) {
+            time_without_loot_ = {};
+        }
+        return generated_loot;
+    }
 
     TimeInterval GetBaseInterval() const { return base_interval_; }
     double GetProbability() const { return probability_; }
     TimeInterval GetTimeWithoutLoot() const { return time_without_loot_; }
 
    private:
-    static double DefaultGenerator() noexcept { return 1.0; };
+    static RandomGenerator DefaultGenerator() {
+        if constexpr (std::is_constructible_v<RandomGenerator,
+                                              ConstantRandom>) {
+            return ConstantRandom{};
+        } else {
+            return RandomGenerator{};
+        }
+    }
+
     TimeInterval base_interval_;
     double probability_;
     TimeInterval time_without_loot_{};
     RandomGenerator random_generator_;
 };
 
+/*
+ * Источник случайных чисел игровой сессии: поток mt19937_64, отображённый
+ * на отрезок [low, high]. При low == high возвращает константу, по умолчанию
+ * 1, как ConstantRandom, и движок не вызывается
+ */
+class EngineRandom {
+   public:
+    explicit EngineRandom(std::uint64_t seed = 0, double low = 1.0,
+                          double high = 1.0)
+        : engine_{seed}, low_{low}, high_{high} {
+        assert(0 <= low_ && low_ <= high_ && high_ <= 1);
+    }
+
+    double operator()() {
+        if (low_ == high_) {
+            return low_;
+        }
+        return std::uniform_real_distribution<double>{low_, high_}(engine_);
+    }
+
+   private:
+    std::mt19937_64 engine_;
+    double low_;
+    double high_;
+};
+
+using LootGenerator = BasicLootGenerator<std::function<double()>>;
+using SessionLootGenerator = BasicLootGenerator<EngineRandom>;
+
+/*
+ * Создаёт источник случайных чисел сессии по её зерну. Вызывается один раз
+ * при появлении сессии, а не на каждом тике
+ */
+using SessionRandomFactory = std::function<EngineRandom(std::uint64_t seed)>;
+
+extern template class BasicLootGenerator<std::function<double()>>;
+extern template class BasicLootGenerator<EngineRandom>;
+
 }  // namespace loot_gen
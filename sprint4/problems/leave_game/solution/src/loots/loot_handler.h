@@ -30,7 +30,15 @@ class LootHandler {
     explicit LootHandler(LootTypeByMap map_loot_types,
                          LootTypeScoreByMap loot_type_score)
         : map_loot_types_(std::move(map_loot_types)),
-          map_score_types_(std::move(loot_type_score)) {}
+          map_score_types_(std::move(loot_type_score)) {
+        for (const auto& [map_id, scores] : map_score_types_) {
+            const auto map = model::Map::GetHandles().Intern(*map_id);
+            if (map >= score_types_by_handle_.size()) {
+                score_types_by_handle_.resize(map + 1);
+            }
+            score_types_by_handle_[map] = scores;
+        }
+    }
 
     std::optional<boost::json::array> FindLootType(
         const model::Map::Id& map_id) {
@@ -43,10 +51,17 @@ class LootHandler {
     }
 
     int FindValueByLootType(const model::Map::Id& map_id, int type) {
-        if (auto it = map_score_types_.find(map_id);
-            it != map_score_types_.end()) {
-            if (type <= it->second.size()) {
-                return it->second[type];
+        if (auto map = model::Map::FindHandle(map_id)) {
+            return FindValueByLootType(*map, type);
+        }
+        throw std::runtime_error("Invalid type for item");
+    }
+
+    int FindValueByLootType(model::Map::Handle map, int type) {
+        if (*map < score_types_by_handle_.size()) {
+            const auto& scores = score_types_by_handle_[*map];
+            if (type <= scores.size()) {
+                return scores[type];
             }
         }
         throw std::runtime_error("Invalid type for item");
@@ -54,5 +69,7 @@ class LootHandler {
 
    private:
     LootTypeByMap map_loot_types_;
+    // Kept by id for snapshots
     LootTypeScoreByMap map_score_types_;
+    std::vector<std::vector<int>> score_types_by_handle_;
 };
@@ -2,6 +2,7 @@
 
 #include <memory>
 #include <unordered_map>
+#include <vector>
 
 #include "model/map.h"
 
@@ -21,18 +22,37 @@ class LootNumberMapHandler {
     LootNumberMapHandler(LootNumberByMap max_loot_number_by_map,
                          int base_max_loot_number)
         : max_loot_number_by_map_(max_loot_number_by_map),
-          base_max_loot_number_(base_max_loot_number) {}
+          base_max_loot_number_(base_max_loot_number) {
+        for (const auto& [map_id, max_loot_number] : max_loot_number_by_map_) {
+            const auto map = model::Map::GetHandles().Intern(*map_id);
+            if (map >= max_loot_number_by_handle_.size()) {
+                max_loot_number_by_handle_.resize(map + 1, NOT_SET);
+            }
+            max_loot_number_by_handle_[map] = max_loot_number;
+        }
+    }
 
-    int GetMaxLootNumber(const model::Map::Id& map_id) {
-        if (auto it = max_loot_number_by_map_.find(map_id);
-            it != max_loot_number_by_map_.end()) {
-            return it->second;
+    int GetMaxLootNumber(const model::Map::Id& map_id) const {
+        if (auto map = model::Map::FindHandle(map_id)) {
+            return GetMaxLootNumber(*map);
+        }
+        return base_max_loot_number_;
+    }
+
+    int GetMaxLootNumber(model::Map::Handle map) const {
+        if (*map < max_loot_number_by_handle_.size() &&
+            max_loot_number_by_handle_[*map] != NOT_SET) {
+            return max_loot_number_by_handle_[*map];
         }
 
         return base_max_loot_number_;
     }
 
    private:
+    static constexpr int NOT_SET = -1;
+
+    // Kept by id for snapshots
     LootNumberByMap max_loot_number_by_map_;
     int base_max_loot_number_;
+    std::vector<int> max_loot_number_by_handle_;
 };
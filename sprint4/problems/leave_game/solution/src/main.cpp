@@ -1,17 +1,26 @@
 #include "utils/sdk.h"
 //
+#include <pthread.h>
+#include <sched.h>
+
 #include <algorithm>
+#include <cstdint>
 #include <cstdlib>
 #include <filesystem>
 #include <iostream>
 #include <memory>
+#include <optional>
+#include <random>
+#include <stdexcept>
 #include <string>
 #include <thread>
 #include <utility>
 #include <vector>
 
 #include <boost/archive/archive_exception.hpp>
+#include <boost/asio/executor_work_guard.hpp>
 #include <boost/asio/io_context.hpp>
+#include <boost/asio/post.hpp>
 #include <boost/asio/signal_set.hpp>
 #include <boost/log/sources/record_ostream.hpp>
 #include <boost/log/trivial.hpp>
@@ -22,9 +31,13 @@
 #include "postgres/unit_of_work_impl.h"
 #include "request_handler/logging_request_handler.h"
 #include "request_handler/request_handler.h"
+#include "serialization/action_journal.h"
 #include "serialization/application_state.h"
+#include "serialization/config_cache.h"
+#include "serialization/request_recording.h"
 #include "utils/command_line_parser.h"
 #include "utils/logger.h"
+#include "utils/profiler.h"
 #include "utils/ticker.h"
 
 using namespace std::literals;
@@ -43,25 +56,159 @@ void RunWorkers(unsigned n, const Fn& fn) {
     fn();
 }
 
-app::Application::Pointer CreateApplication(const utils::Args& args) {
+void PinToCore(unsigned core) {
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    CPU_SET(core, &cpus);
+    if (const int error =
+            pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus)) {
+        BOOST_LOG_TRIVIAL(warning)
+            << boost::log::add_value(
+                   additional_data,
+                   boost::json::value{{"code", error}, {"core", core}})
+            << "io thread is not pinned";
+    }
+}
+
+// Runs each io_context on a thread pinned to a core of its own, the first
+// one on the calling thread. Returns once the first one is stopped.
+void RunPinnedWorkers(
+    const std::vector<std::unique_ptr<net::io_context>>& iocs) {
+    std::vector<std::jthread> workers;
+    workers.reserve(iocs.size() - 1);
+    for (unsigned core = 1; core < iocs.size(); ++core) {
+        workers.emplace_back([core, &ioc = *iocs[core]] {
+            PinToCore(core);
+            ioc.run();
+        });
+    }
+    PinToCore(0);
+    iocs.front()->run();
+    for (const auto& ioc : iocs) {
+        ioc->stop();
+    }
+}
+
+// Runs an io_context on a thread of its own until destroyed. The thread
+// asks for real-time scheduling and keeps the default one if it may not.
+class DedicatedThread {
+   public:
+    explicit DedicatedThread(net::io_context& ioc)
+        : ioc_(ioc),
+          work_(net::make_work_guard(ioc)),
+          thread_([&ioc] {
+              RaisePriority();
+              ioc.run();
+          }) {}
+
+    DedicatedThread(const DedicatedThread&) = delete;
+    DedicatedThread& operator=(const DedicatedThread&) = delete;
+
+    ~DedicatedThread() {
+        work_.reset();
+        ioc_.stop();
+    }
+
+   private:
+    static void RaisePriority() {
+        sched_param param{};
+        param.sched_priority = sched_get_priority_min(SCHED_FIFO);
+        if (const int error =
+                pthread_setschedparam(pthread_self(), SCHED_FIFO, &param)) {
+            BOOST_LOG_TRIVIAL(warning)
+                << boost::log::add_value(additional_data,
+                                         boost::json::value{{"code", error}})
+                << "tick thread runs with the default priority";
+        }
+    }
+
+    net::io_context& ioc_;
+    net::executor_work_guard<net::io_context::executor_type> work_;
+    std::jthread thread_;
+};
+
+boost::json::object HistogramToJson(const utils::LatencyHistogram& histogram) {
+    auto ms = [](utils::LatencyHistogram::Duration value) {
+        return std::chrono::duration<double, std::milli>(value).count();
+    };
+    return boost::json::object{{"p50", ms(histogram.ValueAtPercentile(50))},
+                               {"p99", ms(histogram.ValueAtPercentile(99))},
+                               {"max", ms(histogram.Max())}};
+}
+
+void LogTickerStats(const utils::TickerStats& stats) {
+    BOOST_LOG_TRIVIAL(info)
+        << boost::log::add_value(
+               additional_data,
+               boost::json::value{
+                   {"ticks", stats.ticks},
+                   {"overruns", stats.overruns},
+                   {"latePeriods", stats.late_periods},
+                   {"droppedPeriods", stats.dropped_periods},
+                   {"failures", stats.failures},
+                   {"handlerMs", HistogramToJson(stats.handler_duration)},
+                   {"latenessMs", HistogramToJson(stats.lateness)}})
+        << "ticker stopped";
+}
+
+json_loader::Config LoadConfig(const utils::Args& args) {
+    if (!args.config_cache) {
+        return json_loader::LoadConfig(args.config_file);
+    }
+
+    const auto text = json_loader::ReadConfigFile(args.config_file);
+    const auto hash = json_loader::HashConfig(text);
+    if (auto cached =
+            serialization::LoadConfigCache(*args.config_cache, hash)) {
+        return std::move(*cached);
+    }
+    auto config = json_loader::ParseConfig(text);
+    serialization::SaveConfigCache(*args.config_cache, hash, config);
+    return config;
+}
+
+// The game objects of config are only used when there is no saved state
+app::Application::Pointer CreateApplication(const utils::Args& args,
+                                            json_loader::Config config) {
     std::optional<app::Application::Pointer> app_ptr = std::nullopt;
     if (args.state_file) {
         app_ptr = LoadApplicationState(*args.state_file);
     }
     if (!app_ptr) {
         app_ptr = std::make_unique<app::Application>(
-            std::make_shared<app::Players>(),
-            json_loader::LoadGame(args.config_file),
-            json_loader::LoadLootGenerator(args.config_file),
-            json_loader::LoadLootHandler(args.config_file),
-            json_loader::LoadNumberMapHandler(args.config_file),
+            std::make_shared<app::Players>(), std::move(config.game),
+            std::move(config.loot_generator), std::move(config.loot_handler),
+            std::move(config.loot_number_map_handler),
             args.is_random_spawnpoint, postgres::CreateFactory());
     }
     return std::move(*app_ptr);
 }
 
-void TrySaveApplicationState(app::Application::Pointer app_ptr,
-                             std::optional<std::string> state_file) {
+// The token is read from the environment, like the database URL, so it
+// does not show in the process list
+std::optional<std::string> GetAdminToken(const utils::Args& args) {
+    if (!args.is_admin_api) {
+        return std::nullopt;
+    }
+    const auto* token = std::getenv("GAME_ADMIN_TOKEN");
+    if (!token || *token == '\0') {
+        throw std::runtime_error(
+            "--admin-api needs the GAME_ADMIN_TOKEN environment variable");
+    }
+    return token;
+}
+
+std::uint64_t RandomSeed() {
+    std::random_device device;
+    return (std::uint64_t{device()} << 32) | device();
+}
+
+// A snapshot holds everything journaled so far, the journal starts over
+// from a fresh checkpoint of the snapshot's generation. A crash before the
+// truncation leaves a journal of the previous generation, replay skips it.
+void TrySaveApplicationState(
+    app::Application::Pointer app_ptr, std::optional<std::string> state_file,
+    serialization::FileActionJournal::Pointer journal) {
     if (!state_file) {
         return;
     }
@@ -76,10 +223,122 @@ void TrySaveApplicationState(app::Application::Pointer app_ptr,
     std::filesystem::path temp_file = application_state_file;
     temp_file += ".tmp";
 
+    app_ptr->AdvanceSnapshotGeneration();
     SaveApplicationState(app_ptr, temp_file);
     std::filesystem::rename(temp_file, application_state_file);
+
+    if (journal) {
+        journal->Truncate();
+        journal->Checkpoint(app_ptr->MakeCheckpoint(RandomSeed()));
+    }
 }
 
+// Replays the actions a crash left in the journal on top of the loaded
+// snapshot and keeps journaling into the same file
+serialization::FileActionJournal::Pointer StartJournal(
+    const utils::Args& args, app::Application::Pointer app_ptr) {
+    if (!args.journal_file) {
+        return nullptr;
+    }
+
+    const std::filesystem::path journal_file = *args.journal_file;
+    serialization::JournalReplayResult replay;
+    if (std::filesystem::exists(journal_file)) {
+        replay = serialization::ReplayActionJournal(journal_file, *app_ptr);
+        BOOST_LOG_TRIVIAL(info)
+            << boost::log::add_value(
+                   additional_data,
+                   boost::json::value{{"records", replay.records},
+                                      {"torn", replay.is_torn},
+                                      {"stale", replay.is_stale},
+                                      {"diverged", replay.is_diverged}})
+            << "journal replayed";
+        if (replay.is_torn || replay.is_stale || replay.is_diverged) {
+            std::filesystem::resize_file(journal_file, replay.valid_size);
+        }
+    }
+
+    auto journal =
+        std::make_shared<serialization::FileActionJournal>(journal_file);
+    app_ptr->SetJournal(journal);
+    if (args.state_file) {
+        TrySaveApplicationState(app_ptr, args.state_file, journal);
+    } else if (replay.records == 0) {
+        journal->Checkpoint(app_ptr->MakeCheckpoint(RandomSeed()));
+    }
+    return journal;
+}
+
+// Parses the config on the thread that got the signal, only the swap itself
+// runs on the API strand between two ticks
+template <typename Strand>
+void WaitConfigReload(net::signal_set& signals, const utils::Args& args,
+                      app::Application::Pointer app_ptr, Strand strand) {
+    signals.async_wait([&signals, &args, app_ptr, strand](
+                           const boost::system::error_code& ec,
+                           [[maybe_unused]] int signal_number) {
+        if (ec) {
+            return;
+        }
+        try {
+            auto config = std::make_shared<json_loader::Config>(
+                LoadConfig(args));
+            net::post(strand, [app_ptr, config] {
+                auto result = app_ptr->ReloadConfig(
+                    config->game->GetMaps(), *config->loot_handler,
+                    *config->loot_number_map_handler);
+                BOOST_LOG_TRIVIAL(info)
+                    << boost::log::add_value(
+                           additional_data,
+                           boost::json::value{
+                               {"added", result.added},
+                               {"changed", result.changed},
+                               {"removed", result.removed},
+                               {"migratedSessions",
+                                result.migrated_sessions}})
+                    << "config reloaded";
+            });
+        } catch (const std::exception& ex) {
+            BOOST_LOG_TRIVIAL(error)
+                << boost::log::add_value(
+                       additional_data,
+                       boost::json::value{{"exception", ex.what()}})
+                << "config reload failed";
+        }
+        WaitConfigReload(signals, args, std::move(app_ptr), strand);
+    });
+}
+
+#ifdef GAME_SERVER_PROFILING
+// The first signal starts a capture, the next one stops it and writes the
+// trace files
+void WaitProfilerToggle(net::signal_set& signals, std::string prefix) {
+    signals.async_wait([&signals, prefix = std::move(prefix)](
+                           const boost::system::error_code& ec,
+                           [[maybe_unused]] int signal_number) mutable {
+        if (ec) {
+            return;
+        }
+        auto& profiler = utils::profiler::Profiler::Instance();
+        if (!profiler.IsRunning()) {
+            profiler.Start();
+            BOOST_LOG_TRIVIAL(info) << "profiler started";
+        } else {
+            profiler.Stop();
+            profiler.Dump(prefix);
+            BOOST_LOG_TRIVIAL(info)
+                << boost::log::add_value(
+                       additional_data,
+                       boost::json::value{
+                           {"prefix", prefix},
+                           {"dropped", profiler.GetDroppedCount()}})
+                << "profiler stopped";
+        }
+        WaitProfilerToggle(signals, std::move(prefix));
+    });
+}
+#endif
+
 }  // namespace
 
 int main(int argc, const char* argv[]) {
@@ -97,8 +356,20 @@ int main(int argc, const char* argv[]) {
 
     try {
         InitBoostLogFilter();
-        const unsigned num_threads = std::thread::hardware_concurrency();
-        net::io_context ioc(num_threads);
+        const unsigned num_threads =
+            std::max(1u, std::thread::hardware_concurrency());
+        // With --io-per-core every core gets an io_context of its own,
+        // otherwise all the threads share a single one. Signals and timers
+        // outside the simulation use the first.
+        std::vector<std::unique_ptr<net::io_context>> iocs;
+        if (args->is_io_context_per_core) {
+            for (unsigned core = 0; core < num_threads; ++core) {
+                iocs.push_back(std::make_unique<net::io_context>(1));
+            }
+        } else {
+            iocs.push_back(std::make_unique<net::io_context>(num_threads));
+        }
+        net::io_context& ioc = *iocs.front();
 
         net::signal_set signals(ioc, SIGINT, SIGTERM);
         signals.async_wait([&ioc](const boost::system::error_code& ec,
@@ -113,47 +384,90 @@ int main(int argc, const char* argv[]) {
             }
         });
 
-        app::Application::Pointer app_ptr = CreateApplication(*args);
-        auto api_strand = net::make_strand(ioc);
+#ifdef GAME_SERVER_PROFILING
+        net::signal_set profiler_signals(ioc, SIGUSR1);
+        if (args->profile_output) {
+            WaitProfilerToggle(profiler_signals, *args->profile_output);
+        }
+#endif
+
+        // Loaded even when the game comes from a snapshot, the server
+        // settings live in the config only
+        auto config = LoadConfig(*args);
+        const auto rate_limits = config.rate_limits;
+        app::Application::Pointer app_ptr =
+            CreateApplication(*args, std::move(config));
+        auto journal = StartJournal(*args, app_ptr);
+        // With the ticker moves wait in lock-free inboxes for the next tick
+        // instead of for the API strand. Manual ticks keep them immediate,
+        // a state request right after a move sees it.
+        app_ptr->SetQueueMoves(args->delta_time.has_value());
+        // Game actions and ticks run on the API strand. With --tick-thread
+        // the strand gets an io_context and a thread of its own, so parsing
+        // and writing HTTP messages can't delay a tick.
+        net::io_context tick_ioc(1);
+        auto api_strand = net::make_strand(
+            args->is_dedicated_tick_thread ? tick_ioc : ioc);
 
+        std::shared_ptr<utils::Ticker> ticker;
         if (args->delta_time) {
-            auto ticker = std::make_shared<utils::Ticker>(
+            ticker = std::make_shared<utils::Ticker>(
                 api_strand, *args->delta_time,
                 [app = app_ptr](std::chrono::milliseconds delta) {
                     app->Tick(delta);
-                });
+                },
+                args->tick_catch_up);
 
             ticker->Start();
         }
 
+        net::signal_set reload_signals(ioc, SIGHUP);
+        WaitConfigReload(reload_signals, *args, app_ptr, api_strand);
+
         boost::signals2::scoped_connection save_state_connection =
             app_ptr->DoOnTick([total = 0ms, period = args->save_state_period,
-                               state_file = args->state_file, &app_ptr](
+                               state_file = args->state_file, &app_ptr,
+                               journal](
                                   std::chrono::milliseconds delta) mutable {
                 if (!period.has_value()) {
                     return;
                 }
                 total += delta;
                 if (total >= *period) {
-                    TrySaveApplicationState(app_ptr, state_file);
+                    TrySaveApplicationState(app_ptr, state_file, journal);
                     total = 0ms;
                 }
             });
 
+        serialization::RequestRecorder::Pointer recorder;
+        boost::signals2::scoped_connection record_tick_connection;
+        if (args->record_file) {
+            recorder = std::make_shared<serialization::RequestRecorder>(
+                *args->record_file);
+            record_tick_connection = app_ptr->DoOnTick(
+                [recorder](std::chrono::milliseconds delta) {
+                    recorder->Tick(delta);
+                });
+        }
+
         auto handler = std::make_shared<request_handler::RequestHandler>(
             args->static_source_folder, app_ptr, api_strand,
-            !args->delta_time.has_value());
+            !args->delta_time.has_value(), recorder, rate_limits,
+            GetAdminToken(*args));
         LoggingRequestHandler logging_handler{handler};
 
         const auto address = net::ip::make_address("0.0.0.0");
         constexpr net::ip::port_type port = 8080;
-        http_server::ServeHttp(ioc, {address, port},
-                               [&logging_handler](const boost::string_view ip,
-                                                  auto&& req, auto&& send) {
-                                   logging_handler(
-                                       ip, std::forward<decltype(req)>(req),
-                                       std::forward<decltype(send)>(send));
-                               });
+        auto serve = [&logging_handler](const boost::string_view ip,
+                                        auto&& req, auto&& send) {
+            logging_handler(ip, std::forward<decltype(req)>(req),
+                            std::forward<decltype(send)>(send));
+        };
+        // Per core acceptors keep a connection on the core that accepted it
+        for (const auto& core_ioc : iocs) {
+            http_server::ServeHttp(*core_ioc, {address, port}, serve,
+                                   args->is_io_context_per_core);
+        }
 
         BOOST_LOG_TRIVIAL(info)
             << boost::log::add_value(
@@ -162,8 +476,21 @@ int main(int argc, const char* argv[]) {
                                       {"address", address.to_string()}})
             << "server started";
 
-        RunWorkers(std::max(1u, num_threads), [&ioc] { ioc.run(); });
-        TrySaveApplicationState(app_ptr, args->state_file);
+        {
+            std::optional<DedicatedThread> tick_thread;
+            if (args->is_dedicated_tick_thread) {
+                tick_thread.emplace(tick_ioc);
+            }
+            if (args->is_io_context_per_core) {
+                RunPinnedWorkers(iocs);
+            } else {
+                RunWorkers(num_threads, [&ioc] { ioc.run(); });
+            }
+        }
+        if (ticker) {
+            LogTickerStats(ticker->GetStats());
+        }
+        TrySaveApplicationState(app_ptr, args->state_file, journal);
     } catch (const boost::archive::archive_exception& e) {
         BOOST_LOG_TRIVIAL(error) << "Invalid data in state file";
     } catch (const std::exception& ex) {
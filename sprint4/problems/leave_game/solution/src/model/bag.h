@@ -0,0 +1,144 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "model/item.h"
+
+namespace model {
+
+// Loot carried by a dog. A carried item has no position, so a bag keeps
+// only what the state and the score need. Up to INLINE_CAPACITY items live
+// in the bag itself, bags of maps with a bigger capacity spill to the heap
+// once and keep that buffer when emptied.
+class Bag {
+   public:
+    struct Entry {
+        Item::Id id;
+        int type;
+        int value;
+
+        Item ToItem() const {
+            return {.id = id, .type = type, .position = {}, .value = value};
+        }
+
+        bool operator==(const Entry& other) const = default;
+    };
+
+    static constexpr std::uint32_t INLINE_CAPACITY = 3;
+
+    Bag() noexcept : inline_{} {}
+
+    Bag(const Bag& other) : Bag() { *this = other; }
+
+    Bag(Bag&& other) noexcept : Bag() { *this = std::move(other); }
+
+    Bag& operator=(const Bag& other) {
+        if (this != &other) {
+            size_ = 0;
+            Reserve(other.size_);
+            std::copy(other.begin(), other.end(), GetData());
+            size_ = other.size_;
+        }
+        return *this;
+    }
+
+    Bag& operator=(Bag&& other) noexcept {
+        if (this == &other) {
+            return *this;
+        }
+        if (other.IsInline()) {
+            std::copy(other.begin(), other.end(), GetData());
+        } else {
+            Free();
+            heap_ = other.heap_;
+            capacity_ = other.capacity_;
+            other.capacity_ = INLINE_CAPACITY;
+        }
+        size_ = std::exchange(other.size_, 0);
+        return *this;
+    }
+
+    ~Bag() { Free(); }
+
+    void Add(const Item& item) {
+        if (size_ == capacity_) {
+            Reserve(capacity_ * 2);
+        }
+        GetData()[size_++] = {item.id, item.type, item.value};
+    }
+
+    void Clear() noexcept { size_ = 0; }
+
+    size_t GetSize() const noexcept { return size_; }
+    bool IsEmpty() const noexcept { return size_ == 0; }
+
+    const Entry* begin() const noexcept { return GetData(); }
+    const Entry* end() const noexcept { return GetData() + size_; }
+
+    // Sum of the item values, what the bag scores when handed in
+    int GetValue() const noexcept {
+        int value = 0;
+        for (const auto& entry : *this) {
+            value += entry.value;
+        }
+        return value;
+    }
+
+    std::vector<Item> ToItems() const {
+        std::vector<Item> items;
+        items.reserve(size_);
+        for (const auto& entry : *this) {
+            items.push_back(entry.ToItem());
+        }
+        return items;
+    }
+
+    size_t GetHeapBytes() const noexcept {
+        return IsInline() ? 0 : capacity_ * sizeof(Entry);
+    }
+
+    bool operator==(const Bag& other) const {
+        return std::equal(begin(), end(), other.begin(), other.end());
+    }
+
+   private:
+    union {
+        std::array<Entry, INLINE_CAPACITY> inline_;
+        Entry* heap_;
+    };
+    std::uint32_t size_ = 0;
+    std::uint32_t capacity_ = INLINE_CAPACITY;
+
+    bool IsInline() const noexcept { return capacity_ == INLINE_CAPACITY; }
+
+    Entry* GetData() noexcept { return IsInline() ? inline_.data() : heap_; }
+
+    const Entry* GetData() const noexcept {
+        return IsInline() ? inline_.data() : heap_;
+    }
+
+    void Reserve(std::uint32_t capacity) {
+        if (capacity <= capacity_) {
+            return;
+        }
+        auto* heap = new Entry[capacity];
+        std::copy(begin(), end(), heap);
+        Free();
+        heap_ = heap;
+        capacity_ = capacity;
+    }
+
+    void Free() noexcept {
+        if (!IsInline()) {
+            delete[] heap_;
+            capacity_ = INLINE_CAPACITY;
+        }
+    }
+};
+
+}  // namespace model
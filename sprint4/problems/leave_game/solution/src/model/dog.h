@@ -2,10 +2,12 @@
 
 #include <chrono>
 #include <string>
-#include <vector>
+#include <string_view>
 
 #include "item.h"
 #include "model.h"
+#include "model/bag.h"
+#include "utils/interner.h"
 
 namespace serialization {
 class DogRepr;
@@ -20,9 +22,12 @@ class Dog {
     using Pointer = Dog*;
     using ConstPointer = const Dog*;
 
-    explicit Dog(uint32_t id, std::string name, double max_speed,
+    explicit Dog(uint32_t id, std::string_view name, double max_speed,
                  Coordinate position)
-        : id_{id}, name_{name}, max_speed_(max_speed), position_(position) {}
+        : id_{id},
+          name_(GetNames().Intern(name)),
+          max_speed_(max_speed),
+          position_(position) {}
 
     Dog(const Dog& other) = default;
     Dog& operator=(const Dog& other) = default;
@@ -30,7 +35,7 @@ class Dog {
     Dog& operator=(Dog&& other) = default;
 
     Id GetId() const noexcept { return id_; }
-    std::string_view GetName() const noexcept { return name_; }
+    std::string_view GetName() const noexcept { return name_.GetKey(); }
     Coordinate GetPosition() const noexcept { return position_; }
     Coordinate GetVelocity() const noexcept { return velocity_per_second_; }
     Direction GetDirection() const noexcept { return direction_; }
@@ -60,17 +65,16 @@ class Dog {
     void SetPosition(Coordinate position) { position_ = position; }
     void Stop() { velocity_per_second_ = {0, 0}; }
 
-    void AddItem(Item item) { items_.push_back(item); }
+    void AddItem(Item item) { items_.Add(item); }
 
-    std::vector<Item> DropAllItems() {
-        IncreaseScore();
-        std::vector<Item> items = items_;
-        items_.clear();
-        return items;
+    // Hands the bag in, its items are added to the score
+    void DropAllItems() {
+        scores_ += items_.GetValue();
+        items_.Clear();
     }
 
-    size_t GetItemCount() const { return items_.size(); }
-    std::vector<Item> GetItems() const { return items_; }
+    size_t GetItemCount() const { return items_.GetSize(); }
+    const Bag& GetItems() const noexcept { return items_; }
     int GetScore() const { return scores_; }
 
     void SetTimeInGame(std::chrono::milliseconds time_in_game) {
@@ -86,25 +90,29 @@ class Dog {
         return last_move_time_;
     }
 
+    size_t GetHeapBytes() const noexcept { return items_.GetHeapBytes(); }
+
+    // Players often share a name, so dogs keep a reference into one table.
+    // A name leaves it with the last dog that has it.
+    static utils::RefCountedInterner& GetNames() {
+        static utils::RefCountedInterner names;
+        return names;
+    }
+
    private:
+    // Small fields first, so they pack without padding
     Id id_;
-    std::string name_;
-    double max_speed_;
-    std::vector<Item> items_;
     int scores_ = 0;
+    Direction direction_ = Direction::NORTH;
+    utils::RefCountedInterner::Ref name_;
+    double max_speed_;
+    Bag items_;
 
     Coordinate position_;
     Coordinate velocity_per_second_ = {0, 0};
-    Direction direction_ = Direction::NORTH;
 
     std::chrono::milliseconds time_in_game_ = std::chrono::milliseconds(0);
     std::chrono::milliseconds last_move_time_ = std::chrono::milliseconds(0);
-
-    void IncreaseScore() {
-        for (const auto& item : items_) {
-            scores_ += item.value;
-        }
-    }
 };
 
 }  // namespace model
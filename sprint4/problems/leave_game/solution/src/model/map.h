@@ -1,19 +1,28 @@
 #pragma once
 
+#include <algorithm>
+#include <cstdint>
 #include <memory>
+#include <memory_resource>
 #include <optional>
 #include <string>
 #include <utility>
 #include <vector>
 
 #include "model/model.h"
+#include "model/office_index.h"
 #include "model/roads_handler.h"
+#include "utils/interner.h"
+#include "utils/memory_usage.h"
 
 namespace model {
 
 class Map {
    public:
     using Id = util::Tagged<std::string, Map>;
+    struct HandleTag {};
+    // Dense stand-in for Id, hot structures are flat vectors indexed by it
+    using Handle = util::Tagged<utils::Interner::Handle, HandleTag>;
     using Pointer = std::shared_ptr<Map>;
     using Roads = RoadsHandler::Roads;
     using Buildings = std::vector<Building>;
@@ -23,15 +32,32 @@ class Map {
         Offices offices, std::optional<double> dog_speed,
         int number_loot_types) noexcept
         : id_(std::move(id)),
+          handle_(GetHandles().Intern(*id_)),
           name_(std::move(name)),
           roads_handler_(std::move(roads)),
           buildings_(std::move(buildings)),
           offices_(std::move(offices)),
+          office_index_(offices_),
           dog_speed_(dog_speed),
           number_loot_types_(number_loot_types) {}
 
     const Id& GetId() const noexcept { return id_; }
 
+    Handle GetHandle() const noexcept { return handle_; }
+
+    // Maps with the same id share a handle, also across config reloads
+    static utils::Interner& GetHandles() {
+        static utils::Interner handles;
+        return handles;
+    }
+
+    static std::optional<Handle> FindHandle(const Id& id) {
+        if (auto handle = GetHandles().Find(*id)) {
+            return Handle{*handle};
+        }
+        return std::nullopt;
+    }
+
     const std::string& GetName() const noexcept { return name_; }
 
     const Buildings& GetBuildings() const noexcept { return buildings_; }
@@ -40,20 +66,65 @@ class Map {
 
     const Offices& GetOffices() const noexcept { return offices_; }
 
+    // Ids are indices in GetOffices()
+    const OfficeIndex& GetOfficeIndex() const noexcept { return office_index_; }
+
     std::optional<double> GetMaxSpeed() const noexcept { return dog_speed_; }
 
     int GetNumberOfLootTypes() const noexcept { return number_loot_types_; }
 
-    std::vector<Road::Pointer> FindRoads(Coordinate pos) const {
-        return roads_handler_.FindRoads(pos);
+    std::pmr::vector<Road::Pointer> FindRoads(
+        Coordinate pos, std::pmr::memory_resource* resource =
+                            std::pmr::get_default_resource()) const {
+        return roads_handler_.FindRoads(pos, resource);
+    }
+
+    std::uint64_t GetRoadPointsCount() const noexcept {
+        return roads_handler_.GetRoadPointsCount();
+    }
+
+    Coordinate GetRoadPoint(std::uint64_t index) const {
+        return roads_handler_.GetRoadPoint(index);
+    }
+
+    Coordinate ClampToNearestRoad(Coordinate pos) const {
+        return roads_handler_.ClampToNearestRoad(pos);
+    }
+
+    size_t GetMemoryBytes() const noexcept {
+        size_t bytes = sizeof(*this) + utils::memory::HeapBytes(*id_) +
+                       utils::memory::HeapBytes(name_) +
+                       roads_handler_.GetHeapBytes() +
+                       utils::memory::HeapBytes(buildings_) +
+                       utils::memory::HeapBytes(offices_) +
+                       office_index_.GetHeapBytes();
+        for (const auto& office : offices_) {
+            bytes += utils::memory::HeapBytes(*office.GetId());
+        }
+        return bytes;
+    }
+
+    // True when both maps would play the same, the config reload keeps
+    // sessions of such maps untouched
+    bool HasSameLayout(const Map& other) const {
+        return name_ == other.name_ && dog_speed_ == other.dog_speed_ &&
+               number_loot_types_ == other.number_loot_types_ &&
+               buildings_ == other.buildings_ && offices_ == other.offices_ &&
+               std::equal(GetRoads().begin(), GetRoads().end(),
+                          other.GetRoads().begin(), other.GetRoads().end(),
+                          [](const auto& lhs, const auto& rhs) {
+                              return *lhs == *rhs;
+                          });
     }
 
    private:
     const Id id_;
+    const Handle handle_;
     const std::string name_;
     const RoadsHandler roads_handler_;
     const Buildings buildings_;
     const Offices offices_;
+    const OfficeIndex office_index_;
     const std::optional<double> dog_speed_;
     const int number_loot_types_;
 };
@@ -0,0 +1,49 @@
+#include "office_index.h"
+
+namespace model {
+
+OfficeIndex::OfficeIndex(const std::vector<Office>& offices) {
+    positions_.reserve(offices.size());
+    for (const auto& office : offices) {
+        positions_.push_back({static_cast<double>(office.GetPosition().x),
+                              static_cast<double>(office.GetPosition().y)});
+    }
+    if (positions_.empty()) {
+        return;
+    }
+
+    origin_ = max_ = positions_.front();
+    for (const auto& position : positions_) {
+        origin_.x = std::min(origin_.x, position.x);
+        origin_.y = std::min(origin_.y, position.y);
+        max_.x = std::max(max_.x, position.x);
+        max_.y = std::max(max_.y, position.y);
+    }
+    while (true) {
+        cols_ = static_cast<size_t>((max_.x - origin_.x) / cell_size_) + 1;
+        rows_ = static_cast<size_t>((max_.y - origin_.y) / cell_size_) + 1;
+        if (cols_ * rows_ <= MAX_CELLS) {
+            break;
+        }
+        cell_size_ *= 2;
+    }
+
+    const auto cell_of = [this](Coordinate position) {
+        return ClampedCell(position.y - origin_.y, rows_) * cols_ +
+               ClampedCell(position.x - origin_.x, cols_);
+    };
+    cell_start_.assign(cols_ * rows_ + 1, 0);
+    for (const auto& position : positions_) {
+        ++cell_start_[cell_of(position) + 1];
+    }
+    for (size_t i = 1; i < cell_start_.size(); ++i) {
+        cell_start_[i] += cell_start_[i - 1];
+    }
+    std::vector<size_t> cursor(cell_start_.begin(), cell_start_.end() - 1);
+    ids_.resize(positions_.size());
+    for (Id id = 0; id < positions_.size(); ++id) {
+        ids_[cursor[cell_of(positions_[id])]++] = id;
+    }
+}
+
+}  // namespace model
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "model/model.h"
+#include "utils/memory_usage.h"
+
+namespace model {
+
+// Offices never move, so their grid is built once with the map. An office
+// is known by its index in the offices the index was built from.
+class OfficeIndex {
+   public:
+    using Id = std::uint32_t;
+
+    static constexpr double CELL_SIZE = 8.0;
+    // Cells grow past CELL_SIZE rather than exceed this
+    static constexpr size_t MAX_CELLS = 1 << 16;
+
+    explicit OfficeIndex(const std::vector<Office>& offices);
+
+    // Calls fn(id) for every office that may lie within margin of the
+    // segment from a to b. Candidates only, fn makes the exact test.
+    template <typename Fn>
+    void ForEachCandidate(Coordinate a, Coordinate b, double margin,
+                          Fn&& fn) const {
+        if (positions_.empty()) {
+            return;
+        }
+        const double min_x = std::min(a.x, b.x) - margin;
+        const double max_x = std::max(a.x, b.x) + margin;
+        const double min_y = std::min(a.y, b.y) - margin;
+        const double max_y = std::max(a.y, b.y) + margin;
+        if (max_x < origin_.x || max_y < origin_.y || min_x > max_.x ||
+            min_y > max_.y) {
+            return;
+        }
+
+        const size_t col_begin = ClampedCell(min_x - origin_.x, cols_);
+        const size_t col_end = ClampedCell(max_x - origin_.x, cols_);
+        const size_t row_begin = ClampedCell(min_y - origin_.y, rows_);
+        const size_t row_end = ClampedCell(max_y - origin_.y, rows_);
+        for (size_t row = row_begin; row <= row_end; ++row) {
+            const size_t first = cell_start_[row * cols_ + col_begin];
+            const size_t last = cell_start_[row * cols_ + col_end + 1];
+            for (size_t i = first; i < last; ++i) {
+                fn(ids_[i]);
+            }
+        }
+    }
+
+    Coordinate GetPosition(Id id) const { return positions_.at(id); }
+
+    size_t GetSize() const noexcept { return positions_.size(); }
+
+    size_t GetHeapBytes() const noexcept {
+        return utils::memory::HeapBytes(positions_) +
+               utils::memory::HeapBytes(cell_start_) +
+               utils::memory::HeapBytes(ids_);
+    }
+
+   private:
+    size_t ClampedCell(double offset, size_t count) const {
+        if (offset <= 0) {
+            return 0;
+        }
+        return std::min(static_cast<size_t>(offset / cell_size_), count - 1);
+    }
+
+    double cell_size_ = CELL_SIZE;
+    Coordinate origin_{0.0, 0.0};
+    Coordinate max_{0.0, 0.0};
+    size_t cols_ = 0;
+    size_t rows_ = 0;
+    // By id
+    std::vector<Coordinate> positions_;
+    // Offices of cell c are ids_[cell_start_[c]..cell_start_[c + 1])
+    std::vector<size_t> cell_start_;
+    std::vector<Id> ids_;
+};
+
+}  // namespace model
@@ -1,6 +1,10 @@
 #include "roads_handler.h"
 
 #include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <iterator>
+#include <limits>
 
 namespace model {
 
@@ -44,8 +48,9 @@ std::optional<model::Coordinate> FindClampedPositionIfOutside(
     return clamped;
 }
 
-std::vector<Road::Pointer> RoadsHandler::FindRoads(Coordinate pos) const {
-    std::vector<Road::Pointer> result;
+std::pmr::vector<Road::Pointer> RoadsHandler::FindRoads(
+    Coordinate pos, std::pmr::memory_resource* resource) const {
+    std::pmr::vector<Road::Pointer> result(resource);
 
     auto [low_it_y, high_it_y] = GetCandidateRangeByY(pos.y);
     for (auto it = low_it_y; it != high_it_y; ++it) {
@@ -93,6 +98,37 @@ void RoadsHandler::InitializeSegments() {
               });
 }
 
+void RoadsHandler::InitializeRoadPoints() {
+    road_points_prefix_.reserve(roads_.size());
+    std::uint64_t total = 0;
+    for (const auto& road : roads_) {
+        auto start = road->GetStart();
+        auto end = road->GetEnd();
+        total += std::abs(static_cast<std::int64_t>(end.x) - start.x) +
+                 std::abs(static_cast<std::int64_t>(end.y) - start.y) + 1;
+        road_points_prefix_.push_back(total);
+    }
+}
+
+Coordinate RoadsHandler::GetRoadPoint(std::uint64_t index) const {
+    auto it = std::upper_bound(road_points_prefix_.begin(),
+                               road_points_prefix_.end(), index);
+    assert(it != road_points_prefix_.end());
+    auto road_index = std::distance(road_points_prefix_.begin(), it);
+    auto offset = static_cast<double>(
+        road_index == 0 ? index : index - road_points_prefix_[road_index - 1]);
+
+    auto start = roads_[road_index]->GetStart();
+    auto end = roads_[road_index]->GetEnd();
+    if (roads_[road_index]->IsHorizontal()) {
+        double step = end.x >= start.x ? 1.0 : -1.0;
+        return {.x = start.x + step * offset,
+                .y = static_cast<double>(start.y)};
+    }
+    double step = end.y >= start.y ? 1.0 : -1.0;
+    return {.x = static_cast<double>(start.x), .y = start.y + step * offset};
+}
+
 std::pair<RoadsHandler::Segments::const_iterator,
           RoadsHandler::Segments::const_iterator>
 RoadsHandler::GetCandidateRangeByY(double pos_y) const {
@@ -121,4 +157,20 @@ RoadsHandler::GetCandidateRangeByX(double pos_x) const {
     return {lower, upper};
 }
 
+Coordinate RoadsHandler::ClampToNearestRoad(Coordinate pos) const {
+    Coordinate nearest = pos;
+    double min_distance = std::numeric_limits<double>::max();
+    for (const auto& road : roads_) {
+        auto clamped = ClampPositionToRoad(road, pos);
+        const double dx = clamped.x - pos.x;
+        const double dy = clamped.y - pos.y;
+        const double distance = dx * dx + dy * dy;
+        if (distance < min_distance) {
+            min_distance = distance;
+            nearest = clamped;
+        }
+    }
+    return nearest;
+}
+
 }  // namespace model
@@ -1,9 +1,12 @@
 #pragma once
 
+#include <cstdint>
+#include <memory_resource>
 #include <optional>
 #include <vector>
 
 #include "model/model.h"
+#include "utils/memory_usage.h"
 
 namespace model {
 
@@ -19,11 +22,40 @@ class RoadsHandler {
 
     explicit RoadsHandler(Roads roads) noexcept : roads_{std::move(roads)} {
         InitializeSegments();
+        InitializeRoadPoints();
     }
 
     const Roads& GetRoads() const noexcept { return roads_; }
 
-    std::vector<Road::Pointer> FindRoads(Coordinate pos) const;
+    // Roads are made with std::make_shared, each shares its allocation
+    // with a control block of two counters and a vtable pointer
+    size_t GetHeapBytes() const noexcept {
+        constexpr size_t CONTROL_BLOCK = 2 * sizeof(int) + sizeof(void*);
+        return utils::memory::HeapBytes(roads_) +
+               roads_.size() * (sizeof(Road) + CONTROL_BLOCK) +
+               utils::memory::HeapBytes(vertical_segments_) +
+               utils::memory::HeapBytes(horizontal_segments_) +
+               utils::memory::HeapBytes(road_points_prefix_);
+    }
+
+    // The result is allocated from resource, the tick passes its arena
+    std::pmr::vector<Road::Pointer> FindRoads(
+        Coordinate pos, std::pmr::memory_resource* resource =
+                            std::pmr::get_default_resource()) const;
+
+    // Number of integer points lying on roads, crossroads are counted once
+    // per road
+    std::uint64_t GetRoadPointsCount() const noexcept {
+        return road_points_prefix_.empty() ? 0 : road_points_prefix_.back();
+    }
+
+    // Maps index in [0, GetRoadPointsCount()) to an integer point on a road,
+    // so a uniform index gives a length-weighted point in O(log R)
+    Coordinate GetRoadPoint(std::uint64_t index) const;
+
+    // pos itself when it is on a road, otherwise the closest point of the
+    // closest road. Linear in the number of roads, meant for rare fixups.
+    Coordinate ClampToNearestRoad(Coordinate pos) const;
 
    private:
     struct Segment {
@@ -34,9 +66,13 @@ class RoadsHandler {
     using Segments = std::vector<Segment>;
     Roads roads_;
     Segments vertical_segments_, horizontal_segments_;
+    // road_points_prefix_[i] is the number of points on roads [0, i]
+    std::vector<std::uint64_t> road_points_prefix_;
 
     void InitializeSegments();
 
+    void InitializeRoadPoints();
+
     std::pair<Segments::const_iterator, Segments::const_iterator>
     GetCandidateRangeByY(double pos_y) const;
 
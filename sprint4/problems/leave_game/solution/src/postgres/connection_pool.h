@@ -1,72 +1,354 @@
 #pragma once
 
+#include <algorithm>
+#include <cassert>
+#include <chrono>
 #include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
 #include <memory>
 #include <mutex>
+#include <optional>
 #include <pqxx/pqxx>
+#include <stdexcept>
 #include <utility>
 #include <vector>
 
-class ConnectionPool {
-    using PoolType = ConnectionPool;
-    using ConnectionPtr = std::shared_ptr<pqxx::connection>;
+#include <boost/asio/post.hpp>
+#include <boost/asio/steady_timer.hpp>
+
+struct ConnectionPoolConfig {
+    // Connections opened by the constructor
+    size_t min_size = 1;
+    // The pool grows lazily up to this size
+    size_t max_size = 1;
+    std::chrono::milliseconds acquire_timeout{5000};
+    // Idle connections older than this are health-checked before reuse
+    std::chrono::milliseconds idle_check_after{30000};
+};
+
+struct ConnectionPoolMetrics {
+    size_t size = 0;
+    size_t idle = 0;
+    size_t in_use = 0;
+    size_t waiting = 0;
+    std::uint64_t acquired = 0;
+    std::uint64_t timeouts = 0;
+    std::uint64_t failures = 0;
+    // Connections closed because they failed a health check or were
+    // returned broken, each is replaced by a new one when needed
+    std::uint64_t dropped_broken = 0;
+    std::chrono::nanoseconds total_wait{0};
+    std::chrono::nanoseconds max_wait{0};
+};
+
+struct ConnectionPoolTimeoutError : public std::runtime_error {
+    ConnectionPoolTimeoutError()
+        : std::runtime_error("Timed out waiting for a database connection") {}
+};
+
+template <typename Connection>
+class BasicConnectionPool {
+    using PoolType = BasicConnectionPool;
+    using ConnectionPtr = std::shared_ptr<Connection>;
+    using Clock = std::chrono::steady_clock;
 
    public:
+    using ConnectionFactory = std::function<ConnectionPtr()>;
+    using HealthCheck = std::function<bool(Connection&)>;
+
     class ConnectionWrapper {
        public:
-        ConnectionWrapper(std::shared_ptr<pqxx::connection>&& conn,
+        ConnectionWrapper() = default;
+
+        ConnectionWrapper(std::shared_ptr<Connection>&& conn,
                           PoolType& pool) noexcept
             : conn_{std::move(conn)}, pool_{&pool} {}
 
         ConnectionWrapper(const ConnectionWrapper&) = delete;
         ConnectionWrapper& operator=(const ConnectionWrapper&) = delete;
 
-        ConnectionWrapper(ConnectionWrapper&&) = default;
-        ConnectionWrapper& operator=(ConnectionWrapper&&) = default;
+        ConnectionWrapper(ConnectionWrapper&& other) noexcept
+            : conn_{std::move(other.conn_)},
+              pool_{other.pool_},
+              is_broken_{other.is_broken_} {}
+
+        ConnectionWrapper& operator=(ConnectionWrapper&& other) noexcept {
+            if (this != &other) {
+                Release();
+                conn_ = std::move(other.conn_);
+                pool_ = other.pool_;
+                is_broken_ = other.is_broken_;
+            }
+            return *this;
+        }
+
+        Connection& operator*() const& noexcept { return *conn_; }
+        Connection& operator*() const&& = delete;
+
+        Connection* operator->() const& noexcept { return conn_.get(); }
 
-        pqxx::connection& operator*() const& noexcept { return *conn_; }
-        pqxx::connection& operator*() const&& = delete;
+        explicit operator bool() const noexcept { return conn_ != nullptr; }
 
-        pqxx::connection* operator->() const& noexcept { return conn_.get(); }
+        // The connection is closed instead of going back to the pool
+        void Invalidate() noexcept { is_broken_ = true; }
 
-        ~ConnectionWrapper() {
+        ~ConnectionWrapper() { Release(); }
+
+       private:
+        void Release() noexcept {
             if (conn_) {
-                pool_->ReturnConnection(std::move(conn_));
+                pool_->ReturnConnection(std::move(conn_), is_broken_);
             }
         }
 
-       private:
-        std::shared_ptr<pqxx::connection> conn_;
-        PoolType* pool_;
+        std::shared_ptr<Connection> conn_;
+        PoolType* pool_ = nullptr;
+        bool is_broken_ = false;
     };
 
-    template <typename ConnectionFactory>
-    ConnectionPool(size_t capacity, ConnectionFactory&& connection_factory) {
-        pool_.reserve(capacity);
-        for (size_t i = 0; i < capacity; ++i) {
-            pool_.emplace_back(connection_factory());
+    BasicConnectionPool(
+        ConnectionPoolConfig config, ConnectionFactory connection_factory,
+        HealthCheck health_check = [](Connection& conn) {
+            return conn.is_open();
+        })
+        : config_{config},
+          connection_factory_{std::move(connection_factory)},
+          health_check_{std::move(health_check)} {
+        config_.max_size = std::max<size_t>(config_.max_size, 1);
+        config_.min_size = std::min(config_.min_size, config_.max_size);
+        for (size_t i = 0; i < config_.min_size; ++i) {
+            idle_.push_back({connection_factory_(), Clock::now()});
+            ++size_;
         }
     }
 
+    BasicConnectionPool(const BasicConnectionPool&) = delete;
+    BasicConnectionPool& operator=(const BasicConnectionPool&) = delete;
+
+    // Blocks for at most acquire_timeout, then throws
+    // ConnectionPoolTimeoutError. Waiting callers, blocking or not, are
+    // served first in, first out, a caller arriving later never takes a
+    // connection before them.
     ConnectionWrapper GetConnection() {
+        const auto start = Clock::now();
+
         std::unique_lock lock{mutex_};
-        cond_var_.wait(lock,
-                       [this] { return used_connections_ < pool_.size(); });
-        return {std::move(pool_[used_connections_++]), *this};
+        if (auto slot = Slot{}; waiters_.empty() && TryTakeSlot(slot)) {
+            lock.unlock();
+            return {FillSlot(std::move(slot), start), *this};
+        }
+
+        std::condition_variable cond_var;
+        std::optional<Slot> served;
+        auto waiter = std::make_shared<Waiter>();
+        waiter->serve = [&cond_var, &served](Slot slot) {
+            served = std::move(slot);
+            cond_var.notify_one();
+        };
+        waiters_.push_back(waiter);
+        if (!cond_var.wait_until(lock, start + config_.acquire_timeout,
+                                 [&served] { return served.has_value(); })) {
+            waiters_.erase(std::find(waiters_.begin(), waiters_.end(), waiter));
+            ++metrics_.timeouts;
+            throw ConnectionPoolTimeoutError();
+        }
+        lock.unlock();
+
+        return {FillSlot(std::move(*served), start), *this};
+    }
+
+    // Calls handler(std::exception_ptr, ConnectionWrapper) on executor
+    // once a connection is available, queued with the blocking callers.
+    // No thread blocks while waiting: the connection is checked or opened
+    // on executor, and the wait ends with ConnectionPoolTimeoutError after
+    // acquire_timeout. With several threads running the io_context the
+    // executor should be a strand.
+    template <typename Executor, typename Handler>
+    void AsyncGetConnection(const Executor& executor, Handler&& handler) {
+        const auto start = Clock::now();
+        auto timer = std::make_shared<boost::asio::steady_timer>(
+            executor, config_.acquire_timeout);
+        // Runs on executor, so checking or opening a connection never
+        // blocks the thread that handed the slot over. A missing slot
+        // means the wait timed out.
+        auto complete = [this, executor, start, timer,
+                         handler = std::make_shared<std::decay_t<Handler>>(
+                             std::forward<Handler>(handler))](
+                            std::optional<Slot> slot) {
+            boost::asio::post(executor, [this, start, timer, handler,
+                                         slot = std::move(slot)]() mutable {
+                timer->cancel();
+                if (!slot) {
+                    (*handler)(
+                        std::make_exception_ptr(ConnectionPoolTimeoutError()),
+                        ConnectionWrapper{});
+                    return;
+                }
+                ConnectionPtr conn;
+                try {
+                    conn = FillSlot(std::move(*slot), start);
+                } catch (...) {
+                    (*handler)(std::current_exception(), ConnectionWrapper{});
+                    return;
+                }
+                (*handler)(nullptr, ConnectionWrapper{std::move(conn), *this});
+            });
+        };
+
+        std::unique_lock lock{mutex_};
+        if (auto slot = Slot{}; waiters_.empty() && TryTakeSlot(slot)) {
+            lock.unlock();
+            complete(std::move(slot));
+            return;
+        }
+
+        auto waiter = std::make_shared<Waiter>();
+        waiter->serve = complete;
+        // The wait is started before the waiter becomes visible to other
+        // threads, so it is never cancelled before it starts
+        timer->async_wait([this, waiter, complete](
+                              const boost::system::error_code& ec) {
+            if (ec) {
+                return;
+            }
+            std::unique_lock lock{mutex_};
+            auto it = std::find(waiters_.begin(), waiters_.end(), waiter);
+            if (it == waiters_.end()) {
+                return;
+            }
+            waiters_.erase(it);
+            ++metrics_.timeouts;
+            lock.unlock();
+            complete(std::nullopt);
+        });
+        waiters_.push_back(std::move(waiter));
+    }
+
+    ConnectionPoolMetrics GetMetrics() const {
+        std::lock_guard lock{mutex_};
+        auto metrics = metrics_;
+        metrics.size = size_;
+        metrics.idle = idle_.size();
+        metrics.in_use = size_ - idle_.size();
+        metrics.waiting = waiters_.size();
+        return metrics;
     }
 
    private:
-    void ReturnConnection(ConnectionPtr&& conn) {
-        {
+    struct IdleConnection {
+        ConnectionPtr conn;
+        Clock::time_point since;
+    };
+
+    // Either an idle connection or a reserved place for a new one
+    struct Slot {
+        ConnectionPtr conn;
+        bool needs_check = false;
+    };
+
+    // A blocking or an asynchronous caller waiting for a slot. serve is
+    // called once with mutex_ locked and must not block.
+    struct Waiter {
+        std::function<void(Slot)> serve;
+    };
+
+    // Must be called with mutex_ locked
+    bool TryTakeSlot(Slot& slot) {
+        if (!idle_.empty()) {
+            auto idle = std::move(idle_.back());
+            idle_.pop_back();
+            slot.needs_check =
+                Clock::now() - idle.since >= config_.idle_check_after;
+            slot.conn = std::move(idle.conn);
+            return true;
+        }
+        if (size_ < config_.max_size) {
+            ++size_;
+            return true;
+        }
+        return false;
+    }
+
+    // Turns a slot into a live connection without holding mutex_
+    ConnectionPtr FillSlot(Slot slot, Clock::time_point start) {
+        if (slot.conn && slot.needs_check && !IsHealthy(*slot.conn)) {
+            slot.conn.reset();
             std::lock_guard lock{mutex_};
-            assert(used_connections_ != 0);
-            pool_[--used_connections_] = std::move(conn);
+            ++metrics_.dropped_broken;
+        }
+
+        if (!slot.conn) {
+            try {
+                slot.conn = connection_factory_();
+            } catch (...) {
+                std::lock_guard lock{mutex_};
+                ++metrics_.failures;
+                PassOn(nullptr);
+                throw;
+            }
+        }
+
+        const auto wait = Clock::now() - start;
+        std::lock_guard lock{mutex_};
+        ++metrics_.acquired;
+        metrics_.total_wait += wait;
+        metrics_.max_wait = std::max<std::chrono::nanoseconds>(
+            metrics_.max_wait, wait);
+        return std::move(slot.conn);
+    }
+
+    bool IsHealthy(Connection& conn) {
+        try {
+            return health_check_(conn);
+        } catch (...) {
+            return false;
         }
-        cond_var_.notify_one();
     }
 
-    std::mutex mutex_;
-    std::condition_variable cond_var_;
-    std::vector<ConnectionPtr> pool_;
-    size_t used_connections_ = 0;
+    void ReturnConnection(ConnectionPtr&& conn, bool is_broken) {
+        if (is_broken || !conn->is_open()) {
+            conn.reset();
+        }
+
+        std::lock_guard lock{mutex_};
+        if (!conn) {
+            ++metrics_.dropped_broken;
+        }
+        PassOn(std::move(conn));
+    }
+
+    // Must be called with mutex_ locked. Hands conn to the longest waiting
+    // caller, a null conn hands over the place of a connection that is
+    // gone and the caller opens a new one. A blocking waiter is notified
+    // with mutex_ held, it may leave and destroy its cond_var once
+    // unlocked.
+    void PassOn(ConnectionPtr conn) {
+        if (waiters_.empty()) {
+            if (conn) {
+                idle_.push_back({std::move(conn), Clock::now()});
+            } else {
+                assert(size_ != 0);
+                --size_;
+            }
+            return;
+        }
+        auto waiter = std::move(waiters_.front());
+        waiters_.pop_front();
+        waiter->serve(Slot{.conn = std::move(conn)});
+    }
+
+    ConnectionPoolConfig config_;
+    ConnectionFactory connection_factory_;
+    HealthCheck health_check_;
+
+    mutable std::mutex mutex_;
+    std::vector<IdleConnection> idle_;
+    std::deque<std::shared_ptr<Waiter>> waiters_;
+    size_t size_ = 0;
+    ConnectionPoolMetrics metrics_;
 };
+
+using ConnectionPool = BasicConnectionPool<pqxx::connection>;
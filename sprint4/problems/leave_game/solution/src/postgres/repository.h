@@ -1,5 +1,6 @@
 #pragma once
 
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -11,11 +12,31 @@ struct PlayerInfo {
     double time_in_game;
 };
 
+// Position of a row in the records order. time_in_game keeps the text the
+// server sent, so comparing it with the stored real value is exact.
+struct RecordKey {
+    int score;
+    std::string time_in_game;
+    std::string name;
+    std::string id;
+};
+
+struct RecordsPage {
+    std::vector<PlayerInfo> players;
+    // Set when more rows follow the page
+    std::optional<RecordKey> next;
+};
+
 class PlayerRepository {
    public:
     virtual ~PlayerRepository() = default;
 
     virtual void Write(const PlayerInfo& player) const = 0;
+    // Writes all players in a single round trip
+    virtual void WriteAll(const std::vector<PlayerInfo>& players) const = 0;
     virtual std::vector<PlayerInfo> Read(int count, int max_items) const = 0;
+    // Reads the rows following after, or the first page when it is empty
+    virtual RecordsPage ReadAfter(const std::optional<RecordKey>& after,
+                                  int max_items) const = 0;
 };
 }  // namespace postgres
@@ -1,5 +1,7 @@
 #include "repository_impl.h"
 
+#include <algorithm>
+#include <pqxx/pipeline>
 #include <pqxx/result>
 #include <string>
 #include <vector>
@@ -9,29 +11,126 @@
 
 namespace postgres {
 
+using namespace std::literals;
+using pqxx::operator"" _zv;
+
+namespace {
+
+constexpr auto INSERT_PLAYER = "insert_retired_player"_zv;
+constexpr auto SELECT_PLAYERS = "select_retired_players"_zv;
+constexpr auto SELECT_FIRST_PAGE = "select_retired_players_first"_zv;
+constexpr auto SELECT_PAGE_AFTER = "select_retired_players_after"_zv;
+
+// random_generator seeds itself from the OS, so it is created once per
+// thread instead of once per insert
+std::string GenerateId() {
+    thread_local boost::uuids::random_generator generator;
+    return to_string(generator());
+}
+
+}  // namespace
+
 PlayerRepositoryImpl::PlayerRepositoryImpl(pqxx::work& work) : work_(work) {}
 
+void PlayerRepositoryImpl::PrepareStatements(pqxx::connection& conn) {
+    conn.prepare(INSERT_PLAYER,
+                 "INSERT INTO retired_players (id, name, score, time_in_game) "
+                 "VALUES ($1, $2, $3, $4);"_zv);
+    conn.prepare(SELECT_PLAYERS,
+                 "SELECT name, score, time_in_game FROM retired_players "
+                 "ORDER BY score DESC, time_in_game, name, id "
+                 "LIMIT $1 OFFSET $2;"_zv);
+    conn.prepare(SELECT_FIRST_PAGE,
+                 "SELECT id, name, score, time_in_game FROM retired_players "
+                 "ORDER BY score DESC, time_in_game, name, id "
+                 "LIMIT $1;"_zv);
+    // score is sorted descending and the rest ascending, so one row-value
+    // comparison can not express the order. The rest of the cursor's score
+    // group and the lower scores are read by two branches, each starting
+    // its index scan right at its first row, and merged in index order.
+    // A page deep inside a large group of equal scores reads no more rows
+    // than one at the start.
+    conn.prepare(SELECT_PAGE_AFTER,
+                 "(SELECT id, name, score, time_in_game FROM retired_players "
+                 "WHERE score = $1 AND "
+                 "(time_in_game, name, id) > ($2::real, $3, $4::uuid) "
+                 "ORDER BY score DESC, time_in_game, name, id LIMIT $5) "
+                 "UNION ALL "
+                 "(SELECT id, name, score, time_in_game FROM retired_players "
+                 "WHERE score < $1 "
+                 "ORDER BY score DESC, time_in_game, name, id LIMIT $5) "
+                 "ORDER BY score DESC, time_in_game, name, id "
+                 "LIMIT $5;"_zv);
+}
+
 void PlayerRepositoryImpl::Write(const PlayerInfo& player_info) const {
-    work_.exec_params(
-        "INSERT INTO retired_players (id, name, score, time_in_game) "
-        "VALUES ($1, $2, $3, $4);",
-        to_string(boost::uuids::random_generator()()), player_info.name,
-        player_info.score, player_info.time_in_game);
+    work_.exec_prepared(INSERT_PLAYER, GenerateId(), player_info.name,
+                        player_info.score, player_info.time_in_game);
+}
+
+void PlayerRepositoryImpl::WriteAll(
+    const std::vector<PlayerInfo>& players) const {
+    if (players.size() <= 1) {
+        for (const auto& player : players) {
+            Write(player);
+        }
+        return;
+    }
+
+    // Pipelined queries are plain SQL, so the prepared statement is run
+    // with EXECUTE and quoted arguments
+    pqxx::pipeline pipeline{work_};
+    std::vector<pqxx::pipeline::query_id> queries;
+    queries.reserve(players.size());
+    for (const auto& player : players) {
+        queries.push_back(pipeline.insert(
+            "EXECUTE "s + INSERT_PLAYER.c_str() + "(" +
+            work_.quote(GenerateId()) + ", " + work_.quote(player.name) +
+            ", " + work_.quote(player.score) + ", " +
+            work_.quote(player.time_in_game) + ");"));
+    }
+    for (auto query : queries) {
+        pipeline.retrieve(query);
+    }
 }
 
 std::vector<PlayerInfo> PlayerRepositoryImpl::Read(int count,
                                                    int max_items) const {
-    std::string request =
-        "SELECT name, score, time_in_game FROM retired_players ORDER BY score "
-        "DESC, "
-        "time_in_game, name LIMIT " +
-        std::to_string(max_items) + " OFFSET " + std::to_string(count) + ";";
     std::vector<PlayerInfo> players;
-    for (const auto [name, score, time_in_game] :
-         work_.query<std::string, int, double>(request)) {
-        players.emplace_back(name, score, time_in_game);
+    for (const auto& row : work_.exec_prepared(SELECT_PLAYERS, max_items,
+                                               count)) {
+        players.emplace_back(row[0].as<std::string>(), row[1].as<int>(),
+                             row[2].as<double>());
     }
     return players;
 }
 
+RecordsPage PlayerRepositoryImpl::ReadAfter(
+    const std::optional<RecordKey>& after, int max_items) const {
+    // One extra row tells whether a next page exists
+    const int limit = max_items + 1;
+    auto rows = after ? work_.exec_prepared(SELECT_PAGE_AFTER, after->score,
+                                            after->time_in_game, after->name,
+                                            after->id, limit)
+                      : work_.exec_prepared(SELECT_FIRST_PAGE, limit);
+
+    RecordsPage page;
+    const auto count =
+        std::min<pqxx::result::size_type>(rows.size(), max_items);
+    page.players.reserve(count);
+    for (pqxx::result::size_type i = 0; i < count; ++i) {
+        const auto& row = rows[i];
+        page.players.emplace_back(row[1].as<std::string>(), row[2].as<int>(),
+                                  row[3].as<double>());
+    }
+    if (rows.size() > count && count > 0) {
+        const auto& last = rows[count - 1];
+        page.next = RecordKey{.score = last[2].as<int>(),
+                              .time_in_game = last[3].c_str(),
+                              .name = last[1].as<std::string>(),
+                              .id = last[0].as<std::string>()};
+    }
+    return page;
+}
+
 }  // namespace postgres
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <pqxx/connection>
 #include <pqxx/transaction>
 
 #include "repository.h"
@@ -10,8 +11,15 @@ class PlayerRepositoryImpl : public PlayerRepository {
    public:
     PlayerRepositoryImpl(pqxx::work& work);
 
+    // Prepares the repository statements, must be called for every new
+    // connection
+    static void PrepareStatements(pqxx::connection& conn);
+
     void Write(const PlayerInfo& player_info) const override;
+    void WriteAll(const std::vector<PlayerInfo>& players) const override;
     std::vector<PlayerInfo> Read(int count, int max_items) const override;
+    RecordsPage ReadAfter(const std::optional<RecordKey>& after,
+                          int max_items) const override;
 
    private:
     pqxx::work& work_;
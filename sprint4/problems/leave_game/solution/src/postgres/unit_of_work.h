@@ -1,5 +1,7 @@
 #pragma once
 
+#include <exception>
+#include <functional>
 #include <memory>
 
 #include "repository.h"
@@ -16,8 +18,16 @@ class UnitOfWork {
 
 class UnitOfWorkFactory {
    public:
+    using UnitOfWorkHandler = std::function<void(
+        std::exception_ptr error, std::unique_ptr<UnitOfWork> unit_of_work)>;
+
     virtual ~UnitOfWorkFactory() = default;
     virtual std::unique_ptr<UnitOfWork> CreateUnitOfWork() = 0;
+
+    // Returns at once, handler gets the unit of work or the error later
+    // and may block on the database, it runs where the factory does its
+    // database work and never on the caller's thread
+    virtual void AsyncCreateUnitOfWork(UnitOfWorkHandler handler) = 0;
 };
 
 }  // namespace postgres
@@ -1,6 +1,7 @@
 #include "unit_of_work_impl.h"
 
 #include <algorithm>
+#include <thread>
 #include <utility>
 
 #include "postgres/connection_pool.h"
@@ -11,8 +12,9 @@ namespace postgres {
 using namespace std::literals;
 using pqxx::operator"" _zv;
 
-Database::Database(pqxx::work& work) : work_(work) {
-    work_.exec(R"(
+void MigrateSchema(pqxx::connection& conn) {
+    pqxx::work work{conn};
+    work.exec(R"(
 CREATE TABLE IF NOT EXISTS retired_players (
    id UUID CONSTRAINT retired_players_pkey PRIMARY KEY,
    name varchar(100) NOT NULL,
@@ -21,12 +23,17 @@ CREATE TABLE IF NOT EXISTS retired_players (
 );
 )"_zv);
 
-    work_.exec(R"(
-CREATE INDEX IF NOT EXISTS idx_score_playtime_name
-ON retired_players (score DESC, time_in_game, name);
+    // id makes the records order total, which keyset pagination needs
+    work.exec(R"(
+CREATE INDEX IF NOT EXISTS idx_score_playtime_name_id
+ON retired_players (score DESC, time_in_game, name, id);
 )"_zv);
+    work.exec("DROP INDEX IF EXISTS idx_score_playtime_name;"_zv);
+    work.commit();
 }
 
+Database::Database(pqxx::work& work) : work_(work) {}
+
 PlayerRepositoryImpl& Database::GetPlayers() { return players_; }
 
 UnitOfWorkImpl::UnitOfWorkImpl(ConnectionPool::ConnectionWrapper wrapper)
@@ -40,17 +47,59 @@ UnitOfWorkFactoryImpl::UnitOfWorkFactoryImpl(
     std::unique_ptr<ConnectionPool> pool)
     : pool_(std::move(pool)) {}
 
+UnitOfWorkFactoryImpl::~UnitOfWorkFactoryImpl() { database_thread_.join(); }
+
 std::unique_ptr<UnitOfWork> UnitOfWorkFactoryImpl::CreateUnitOfWork() {
     return std::make_unique<postgres::UnitOfWorkImpl>(pool_->GetConnection());
 }
 
+void UnitOfWorkFactoryImpl::AsyncCreateUnitOfWork(UnitOfWorkHandler handler) {
+    pool_->AsyncGetConnection(
+        database_thread_.get_executor(),
+        [handler = std::move(handler)](
+            std::exception_ptr error,
+            ConnectionPool::ConnectionWrapper wrapper) {
+            if (error) {
+                handler(error, nullptr);
+                return;
+            }
+            std::unique_ptr<UnitOfWork> unit_of_work;
+            try {
+                unit_of_work =
+                    std::make_unique<UnitOfWorkImpl>(std::move(wrapper));
+            } catch (...) {
+                handler(std::current_exception(), nullptr);
+                return;
+            }
+            handler(nullptr, std::move(unit_of_work));
+        });
+}
+
 std::shared_ptr<UnitOfWorkFactory> CreateFactory() {
     if (const auto* url = std::getenv("GAME_DB_URL")) {
         static const std::string db_url = url;
+        {
+            // Statements are prepared on every new connection and need the
+            // schema to exist
+            pqxx::connection conn{db_url};
+            MigrateSchema(conn);
+        }
+
+        ConnectionPoolConfig config{
+            .min_size = 1,
+            .max_size = std::max(1u, std::thread::hardware_concurrency())};
         return std::make_shared<UnitOfWorkFactoryImpl>(
             std::make_unique<ConnectionPool>(
-                std::max(1u, std::thread::hardware_concurrency()),
-                [] { return std::make_shared<pqxx::connection>(db_url); }));
+                config,
+                [] {
+                    auto conn = std::make_shared<pqxx::connection>(db_url);
+                    PlayerRepositoryImpl::PrepareStatements(*conn);
+                    return conn;
+                },
+                [](pqxx::connection& conn) {
+                    pqxx::nontransaction(conn).exec("SELECT 1;"_zv);
+                    return true;
+                }));
     }
     throw std::runtime_error("Missing GAME_DB_URL environment variable");
 }
@@ -4,6 +4,8 @@
 #include <pqxx/connection>
 #include <pqxx/transaction>
 
+#include <boost/asio/thread_pool.hpp>
+
 #include "connection_pool.h"
 #include "postgres/repository.h"
 #include "postgres/repository_impl.h"
@@ -11,6 +13,9 @@
 
 namespace postgres {
 
+// Creates tables and indexes if they do not exist, runs once at startup
+void MigrateSchema(pqxx::connection& conn);
+
 class Database {
    public:
     explicit Database(pqxx::work& work);
@@ -38,10 +43,18 @@ class UnitOfWorkImpl : public UnitOfWork {
 class UnitOfWorkFactoryImpl : public UnitOfWorkFactory {
    public:
     explicit UnitOfWorkFactoryImpl(std::unique_ptr<ConnectionPool> pool);
+    // Waits for the asynchronous units of work already requested
+    ~UnitOfWorkFactoryImpl() override;
+
     std::unique_ptr<UnitOfWork> CreateUnitOfWork() override;
+    void AsyncCreateUnitOfWork(UnitOfWorkHandler handler) override;
 
    private:
     std::unique_ptr<ConnectionPool> pool_;
+    // One thread, so asynchronous units of work run one at a time in the
+    // order they were requested. Declared after pool_, the thread is gone
+    // before the pool is.
+    boost::asio::thread_pool database_thread_{1};
 };
 
 std::shared_ptr<UnitOfWorkFactory> CreateFactory();
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <string_view>
+
+#include <boost/beast/http/status.hpp>
+
+#include "request_handler/utils/error_codes.h"
+#include "request_handler/utils/response_utils.h"
+#include "utils/rate_limiter.h"
+
+namespace request_handler {
+
+// Decides whether an API request may be handled at all. Checked on the
+// I/O thread before the request is dispatched, so rejected requests never
+// reach the API strand.
+class AdmissionControl {
+   public:
+    explicit AdmissionControl(const utils::RateLimitConfig& config)
+        : max_api_queue_(config.max_api_queue) {
+        if (config.per_token) {
+            per_token_ =
+                std::make_unique<utils::RateLimiter>(*config.per_token);
+        }
+        if (config.per_ip) {
+            per_ip_ = std::make_unique<utils::RateLimiter>(*config.per_ip);
+        }
+    }
+
+    // Returns the rejection, nullopt when the request may go on.
+    // authorization is the raw header, requests without one are limited
+    // by their IP only.
+    std::optional<response_utils::StringResponse> Admit(
+        std::string_view client_ip, std::string_view authorization) {
+        if (per_ip_ && !per_ip_->TryAcquire(client_ip)) {
+            return MakeTooManyRequests();
+        }
+        if (per_token_ && !authorization.empty() &&
+            !per_token_->TryAcquire(authorization)) {
+            return MakeTooManyRequests();
+        }
+        return std::nullopt;
+    }
+
+    // Sheds requests that would wait for the API strand behind
+    // queue_size others
+    std::optional<response_utils::StringResponse> AdmitToStrand(
+        std::size_t queue_size) const {
+        if (max_api_queue_ && queue_size >= *max_api_queue_) {
+            auto response = response_utils::MakeErrorResponse(
+                boost::beast::http::status::service_unavailable,
+                error_codes::kServerBusy, "Server is busy");
+            response.retry_after = RETRY_AFTER;
+            return response;
+        }
+        return std::nullopt;
+    }
+
+   private:
+    static constexpr boost::string_view RETRY_AFTER = "1";
+
+    static response_utils::StringResponse MakeTooManyRequests() {
+        auto response = response_utils::MakeErrorResponse(
+            boost::beast::http::status::too_many_requests,
+            error_codes::kTooManyRequests, "Too many requests");
+        response.retry_after = RETRY_AFTER;
+        return response;
+    }
+
+    std::unique_ptr<utils::RateLimiter> per_token_;
+    std::unique_ptr<utils::RateLimiter> per_ip_;
+    std::optional<std::size_t> max_api_queue_;
+};
+
+}  // namespace request_handler
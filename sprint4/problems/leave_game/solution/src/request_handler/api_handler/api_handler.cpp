@@ -13,11 +13,15 @@
 #include "json_converter.h"
 #include "request_handler/api_handler/parsers/game_tick_request.h"
 #include "request_handler/api_handler/parsers/get_game_records_request.h"
+#include "request_handler/api_handler/parsers/get_game_state_request.h"
 #include "request_handler/api_handler/parsers/join_game_request.h"
 #include "request_handler/api_handler/parsers/player_action_request.h"
 #include "request_handler/utils/error_codes.h"
 #include "request_handler/utils/response_utils.h"
+#include "utils/cbor_writer.h"
+#include "utils/json_writer.h"
 #include "utils/logger.h"
+#include "utils/profiler.h"
 
 namespace request_handler::api_handler {
 
@@ -33,16 +37,48 @@ inline static constexpr beast::string_view PLAYER_ACTION =
     "/game/player/action";
 inline static constexpr beast::string_view GAME_TICK = "/game/tick";
 inline static constexpr beast::string_view GAME_RECORDS = "/game/records";
+inline static constexpr beast::string_view ADMIN_MEMORY = "/admin/memory";
 
 }  // namespace api_keys
 
 ApiHandler::ApiHandler(app::Application::Pointer app_ptr,
-                       bool is_aviable_game_tick)
+                       bool is_aviable_game_tick,
+                       serialization::RequestRecorder::Pointer recorder,
+                       std::optional<std::string> admin_token)
     : app_ptr_{std::move(app_ptr)},
-      is_aviable_game_tick_(is_aviable_game_tick) {
+      is_aviable_game_tick_(is_aviable_game_tick),
+      recorder_(std::move(recorder)),
+      admin_token_(std::move(admin_token)) {
     InitializeRoutes();
 }
 
+namespace {
+
+encoding::Encoding AcceptedEncoding(
+    const http::request<http::string_body>& req) {
+    const auto accept = req[http::field::accept];
+    return encoding::Negotiate({accept.data(), accept.size()});
+}
+
+// write gets a utils::JsonWriter or a utils::CborWriter, whichever the
+// client accepts, and puts the whole body in it
+template <typename Write>
+ApiHandler::StringResponse MakeOkEncodedResponse(encoding::Encoding accepted,
+                                                 Write&& write) {
+    std::string body;
+    if (accepted == encoding::Encoding::CBOR) {
+        utils::CborWriter writer{body};
+        write(writer);
+    } else {
+        utils::JsonWriter writer{body};
+        write(writer);
+    }
+    return response_utils::MakeOkSerializedResponse(
+        std::move(body), encoding::ContentType(accepted));
+}
+
+}  // namespace
+
 void ApiHandler::InitializeRoutes() {
     route_map_[api_keys::GAME_JOIN] =
         [this](const http::request<http::string_body>& req) {
@@ -52,7 +88,8 @@ void ApiHandler::InitializeRoutes() {
     route_map_[api_keys::GAME_PLAYERS] =
         [this](const http::request<http::string_body>& req) {
             return GetGamePlayers(req.method(),
-                                  req[http::field::authorization]);
+                                  req[http::field::authorization],
+                                  AcceptedEncoding(req));
         };
 
     route_map_[api_keys::ALL_MAPS] =
@@ -62,7 +99,8 @@ void ApiHandler::InitializeRoutes() {
 
     route_map_[api_keys::GAME_STATE] =
         [this](const http::request<http::string_body>& req) {
-            return GetGameState(req.method(), req[http::field::authorization]);
+            return GetGameState(req.method(), req[http::field::authorization],
+                                AcceptedEncoding(req));
         };
 
     route_map_[api_keys::PLAYER_ACTION] =
@@ -76,29 +114,58 @@ void ApiHandler::InitializeRoutes() {
             return GameTick(req.method(), req[http::field::content_type],
                             req.body());
         };
+
+    route_map_[api_keys::ADMIN_MEMORY] =
+        [this](const http::request<http::string_body>& req) {
+            return GetMemoryReport(req.method(),
+                                   req[http::field::authorization]);
+        };
 }
 
 ApiHandler::StringResponse ApiHandler::operator()(
     const http::request<http::string_body>& req) {
+    PROFILE_SCOPE("ApiHandler");
     auto target = req.target().substr(API_KEY.size() + API_VERSION_KEY.size());
 
     auto it = route_map_.find(target);
     if (it != route_map_.end()) {
+        // Route keys are string literals, so they outlive any capture
+        PROFILE_SCOPE(std::string_view(it->first.data(), it->first.size()));
         return it->second(req);
     }
 
     if (target.rfind(api_keys::ALL_MAPS) == 0) {
-        return GetMapResponse(req.method(), target);
+        PROFILE_SCOPE("/maps/{id}");
+        return GetMapResponse(req.method(), target, AcceptedEncoding(req));
+    }
+
+    if (target.rfind(api_keys::GAME_STATE) == 0 &&
+        target.size() > api_keys::GAME_STATE.size() &&
+        target[api_keys::GAME_STATE.size()] == '?') {
+        PROFILE_SCOPE(std::string_view(api_keys::GAME_STATE.data(),
+                                       api_keys::GAME_STATE.size()));
+        return GetGameState(req.method(), req[http::field::authorization],
+                            AcceptedEncoding(req),
+                            std::string_view(target.data(), target.size()));
     }
 
     if (target.rfind(api_keys::GAME_RECORDS) == 0) {
-        return GetGameRecords(req.method(), target.to_string());
+        PROFILE_SCOPE(std::string_view(api_keys::GAME_RECORDS.data(),
+                                       api_keys::GAME_RECORDS.size()));
+        return GetGameRecords(req.method(), target.to_string(),
+                              AcceptedEncoding(req));
     }
 
     return response_utils::MakeBadRequestResponse(error_codes::kBadRequest,
                                                   "Bad request");
 }
 
+bool ApiHandler::IsPlayerAction(beast::string_view target) {
+    const auto prefix_size = API_KEY.size() + API_VERSION_KEY.size();
+    return target.size() >= prefix_size &&
+           target.substr(prefix_size) == api_keys::PLAYER_ACTION;
+}
+
 std::optional<app::Token> TryExtractToken(
     const beast::string_view authorization_header) {
     static constexpr beast::string_view BEARER_HEADER_PREFIX = "Bearer ";
@@ -127,7 +194,8 @@ ApiHandler::StringResponse ExecuteAuthorized(
 }
 
 ApiHandler::StringResponse ApiHandler::GetMapResponse(
-    const http::verb method, beast::string_view target) const {
+    const http::verb method, beast::string_view target,
+    encoding::Encoding accepted) const {
     if (method != http::verb::get && method != http::verb::head) {
         return response_utils::MakeMethodNotAllowedResponse(
             error_codes::kInvalidMethod, "GET, HEAD");
@@ -136,12 +204,17 @@ ApiHandler::StringResponse ApiHandler::GetMapResponse(
     auto map_id = model::Map::Id{std::string(
         target.substr(api_keys::ALL_MAPS.size() + 1,
                       target.size() - api_keys::ALL_MAPS.size() - 1))};
+    if (recorder_) {
+        recorder_->GetMap(map_id);
+    }
 
     try {
         auto get_map_result = app_ptr_->GetMap(map_id);
         auto map_json = json_converter::FullMapToJson(*get_map_result.map_ptr);
         map_json["lootTypes"] = get_map_result.loot_types;
-        return response_utils::MakeOkResponse(map_json);
+        const boost::json::value map_value(std::move(map_json));
+        return MakeOkEncodedResponse(
+            accepted, [&map_value](auto& writer) { writer.Value(map_value); });
     } catch (const GetMapError& error) {
         switch (error.reason) {
             case GetMapErrorReason::MapNotFound:
@@ -168,14 +241,19 @@ ApiHandler::StringResponse ApiHandler::GameJoin(const http::verb method,
             error_codes::kInvalidArgument, "Invalid JSON body");
     }
 
+    model::Map::Id map_id{join_game_request->map_id};
     try {
-        auto result =
-            app_ptr_->JoinGame(model::Map::Id{join_game_request->map_id},
-                               join_game_request->user_name);
+        auto result = app_ptr_->JoinGame(map_id, join_game_request->user_name);
+        if (recorder_) {
+            recorder_->Join(map_id, result.token);
+        }
         boost::json::object answer{{"authToken", *result.token},
                                    {"playerId", *result.player_id}};
         return response_utils::MakeOkResponse(answer);
     } catch (const JoinGameError& error) {
+        if (recorder_) {
+            recorder_->Join(map_id, std::nullopt);
+        }
         switch (error.reason) {
             case JoinGameErrorReason::InvalidMap:
                 return response_utils::MakeNotFoundResponse(error.code,
@@ -191,7 +269,8 @@ ApiHandler::StringResponse ApiHandler::GameJoin(const http::verb method,
 }
 
 ApiHandler::StringResponse ApiHandler::GetGamePlayers(
-    const http::verb method, const beast::string_view authorization_header) {
+    const http::verb method, const beast::string_view authorization_header,
+    encoding::Encoding accepted) {
     if (method != http::verb::get && method != http::verb::head) {
         return response_utils::MakeMethodNotAllowedResponse(
             error_codes::kInvalidMethod, "GET, HEAD");
@@ -199,21 +278,19 @@ ApiHandler::StringResponse ApiHandler::GetGamePlayers(
 
     return ExecuteAuthorized(
         authorization_header, [&](const app::Token& token) {
-            boost::json::array players_json;
+            if (recorder_) {
+                recorder_->ListPlayers(token);
+            }
             try {
                 auto list_player_result = app_ptr_->ListPlayers(token);
-
-                for (const auto& player_info :
-                     list_player_result.player_infos) {
-                    players_json.push_back(
-                        json_converter::PlayerInfoToJson(player_info));
-                }
+                return MakeOkEncodedResponse(accepted, [&](auto& writer) {
+                    json_converter::WritePlayerInfos(
+                        writer, list_player_result.player_infos);
+                });
             } catch (const ListPlayerError& error) {
                 return response_utils::MakeUnauthorizedResponse(error.code,
                                                                 error.what());
             }
-
-            return response_utils::MakeOkResponse(players_json);
         });
 }
 
@@ -224,6 +301,9 @@ ApiHandler::StringResponse ApiHandler::GetAllMapsResponse(
             error_codes::kInvalidMethod, http::to_string(http::verb::get));
     }
 
+    if (recorder_) {
+        recorder_->ListMaps();
+    }
     boost::json::array maps;
     for (const auto map : app_ptr_->ListMaps()) {
         maps.push_back(json_converter::MapToJson(*map));
@@ -233,18 +313,31 @@ ApiHandler::StringResponse ApiHandler::GetAllMapsResponse(
 }
 
 ApiHandler::StringResponse ApiHandler::GetGameState(
-    const http::verb method, const beast::string_view authorization_header) {
+    const http::verb method, const beast::string_view authorization_header,
+    encoding::Encoding accepted, std::string_view target) {
     if (method != http::verb::get && method != http::verb::head) {
         return response_utils::MakeMethodNotAllowedResponse(
             error_codes::kInvalidMethod, "GET, HEAD");
     }
 
+    auto request = GetGameStateRequest::ParseFromTarget(target);
+    if (!request) {
+        return response_utils::MakeBadRequestResponse(
+            error_codes::kInvalidArgument, "Invalid area query");
+    }
+    const GameStateFilter filter{request->radius, request->viewport};
+
     return ExecuteAuthorized(
-        authorization_header, [this](const app::Token& token) {
+        authorization_header,
+        [this, &filter, accepted](const app::Token& token) {
+            if (recorder_) {
+                recorder_->GetState(token);
+            }
             try {
-                return response_utils::MakeOkResponse(
-                    json_converter::GameStateToJson(
-                        app_ptr_->GetGameState(token)));
+                const auto state = app_ptr_->GetGameState(token, filter);
+                return MakeOkEncodedResponse(accepted, [&state](auto& writer) {
+                    json_converter::WriteGameState(writer, state);
+                });
             } catch (const GetGameStateError& error) {
                 return response_utils::MakeUnauthorizedResponse(error.code,
                                                                 error.what());
@@ -276,6 +369,9 @@ ApiHandler::StringResponse ApiHandler::MovePlayers(
                         "Failed to parse action");
                 }
 
+                if (recorder_) {
+                    recorder_->Move(token, request->direction);
+                }
                 app_ptr_->MovePlayer(token, request->direction);
                 return response_utils::MakeOkResponse(boost::json::object{});
 
@@ -312,7 +408,8 @@ ApiHandler::StringResponse ApiHandler::GameTick(
 }
 
 ApiHandler::StringResponse ApiHandler::GetGameRecords(
-    const http::verb method, std::string_view target) const {
+    const http::verb method, std::string_view target,
+    encoding::Encoding accepted) const {
     if (method != http::verb::get) {
         return response_utils::MakeMethodNotAllowedResponse(
             error_codes::kInvalidMethod, http::to_string(http::verb::get));
@@ -325,12 +422,69 @@ ApiHandler::StringResponse ApiHandler::GetGameRecords(
             error_codes::kInvalidArgument, "Invalid JSON body");
     }
 
-    boost::json::array records;
-    for (const auto& record :
-         app_ptr_->GetGameRecords(request.start, request.max_element)) {
-        records.push_back(json_converter::GameRecordToJson(record));
+    if (recorder_) {
+        recorder_->GetRecords(request.start, request.max_element,
+                              request.cursor);
+    }
+
+    if (request.cursor) {
+        try {
+            const auto page = app_ptr_->GetGameRecordsPage(
+                *request.cursor, request.max_element);
+            return MakeOkEncodedResponse(accepted, [&page](auto& writer) {
+                json_converter::WriteGameRecordsPage(writer, page);
+            });
+        } catch (const GetGameRecordsError& error) {
+            return response_utils::MakeBadRequestResponse(error.code,
+                                                          error.what());
+        }
+    }
+
+    const auto records =
+        app_ptr_->GetGameRecords(request.start, request.max_element);
+    return MakeOkEncodedResponse(accepted, [&records](auto& writer) {
+        json_converter::WriteGameRecords(writer, records);
+    });
+}
+
+// Takes as long wherever the header differs from the token, so the
+// token can't be guessed a character at a time
+bool IsAdminAuthorization(const beast::string_view authorization_header,
+                          std::string_view token) {
+    static constexpr std::string_view BEARER_HEADER_PREFIX = "Bearer ";
+
+    const std::string_view header(authorization_header.data(),
+                                  authorization_header.size());
+    if (header.size() != BEARER_HEADER_PREFIX.size() + token.size() ||
+        !header.starts_with(BEARER_HEADER_PREFIX)) {
+        return false;
+    }
+    unsigned char difference = 0;
+    for (size_t i = 0; i < token.size(); ++i) {
+        difference |= static_cast<unsigned char>(
+            header[BEARER_HEADER_PREFIX.size() + i] ^ token[i]);
+    }
+    return difference == 0;
+}
+
+ApiHandler::StringResponse ApiHandler::GetMemoryReport(
+    const http::verb method,
+    const beast::string_view authorization_header) const {
+    if (!admin_token_) {
+        return response_utils::MakeBadRequestResponse(error_codes::kBadRequest,
+                                                      "Invalid endpoint");
     }
-    return response_utils::MakeOkResponse(records);
+    if (!IsAdminAuthorization(authorization_header, *admin_token_)) {
+        return response_utils::MakeUnauthorizedResponse(
+            error_codes::kInvalidToken, "Invalid token");
+    }
+    if (method != http::verb::get) {
+        return response_utils::MakeMethodNotAllowedResponse(
+            error_codes::kInvalidMethod, http::to_string(http::verb::get));
+    }
+
+    return response_utils::MakeOkResponse(
+        json_converter::MemoryReportToJson(app_ptr_->GetMemoryReport()));
 }
 
 }  // namespace request_handler::api_handler
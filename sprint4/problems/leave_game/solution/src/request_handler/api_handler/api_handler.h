@@ -1,6 +1,7 @@
 
 #pragma once
 
+#include <optional>
 #include <string>
 #include <unordered_map>
 
@@ -9,7 +10,9 @@
 #include <boost/beast/http/string_body.hpp>
 
 #include "app/application.h"
+#include "request_handler/utils/encoding.h"
 #include "request_handler/utils/response_utils.h"
+#include "serialization/request_recording.h"
 
 namespace request_handler::api_handler {
 
@@ -23,11 +26,21 @@ class ApiHandler {
     static constexpr beast::string_view API_KEY = "/api";
     static constexpr beast::string_view API_VERSION_KEY = "/v1";
 
-    explicit ApiHandler(app::Application::Pointer app_ptr,
-                        bool is_aviable_game_tick);
+    // Requests reaching the application are written to recorder when set.
+    // Ticks are not, they are recorded where they are applied. Admin
+    // endpoints answer only when admin_token is set, and only to requests
+    // bearing it.
+    explicit ApiHandler(
+        app::Application::Pointer app_ptr, bool is_aviable_game_tick,
+        serialization::RequestRecorder::Pointer recorder = nullptr,
+        std::optional<std::string> admin_token = std::nullopt);
 
     StringResponse operator()(const http::request<http::string_body>& req);
 
+    // Player actions touch nothing but thread-safe state when the
+    // application queues moves, they need not wait for the API strand
+    static bool IsPlayerAction(beast::string_view target);
+
    private:
     struct BeastStringViewHasher {
         std::size_t operator()(const beast::string_view& sv) const noexcept {
@@ -51,21 +64,30 @@ class ApiHandler {
     app::Application::Pointer app_ptr_;
     Routes route_map_;
     bool is_aviable_game_tick_;
+    serialization::RequestRecorder::Pointer recorder_;
+    std::optional<std::string> admin_token_;
 
     void InitializeRoutes();
 
+    // accepted is the encoding negotiated for the responses that have more
+    // than one, errors are always JSON
     StringResponse GetMapResponse(const http::verb method,
-                                  beast::string_view target) const;
+                                  beast::string_view target,
+                                  encoding::Encoding accepted) const;
 
     StringResponse GameJoin(const http::verb method, const std::string& body);
 
-    StringResponse GetGamePlayers(
-        const http::verb method, const beast::string_view authorization_header);
+    StringResponse GetGamePlayers(const http::verb method,
+                                  const beast::string_view authorization_header,
+                                  encoding::Encoding accepted);
 
     StringResponse GetAllMapsResponse(const http::verb method) const;
 
+    // target carries the area query, if the client sent one
     StringResponse GetGameState(const http::verb method,
-                                const beast::string_view authorization_header);
+                                const beast::string_view authorization_header,
+                                encoding::Encoding accepted,
+                                std::string_view target = {});
 
     StringResponse MovePlayers(const http::verb method,
                                const beast::string_view authorization_headet,
@@ -77,7 +99,12 @@ class ApiHandler {
                             const std::string& body);
 
     StringResponse GetGameRecords(const http::verb method,
-                                  std::string_view target) const;
+                                  std::string_view target,
+                                  encoding::Encoding accepted) const;
+
+    StringResponse GetMemoryReport(
+        const http::verb method,
+        const beast::string_view authorization_header) const;
 };
 
 }  // namespace request_handler::api_handler
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <array>
+#include <charconv>
+#include <cmath>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "app/game/spatial_grid.h"
+#include "request_handler/api_handler/parsers/target_args.h"
+
+// Query of /game/state: radius=R around the player's dog, or a viewport
+// given by two corners x0, y0, x1, y1. Both are optional.
+struct GetGameStateRequest {
+    std::optional<double> radius;
+    std::optional<app::AreaOfInterest> viewport;
+
+    // Empty when an argument is not a number, the radius is not positive
+    // or the viewport misses a corner coordinate
+    static std::optional<GetGameStateRequest> ParseFromTarget(
+        std::string_view target) {
+        GetGameStateRequest request;
+        if (target.find('?') == target.npos) {
+            return request;
+        }
+        auto args = ParseTargetArgs(target);
+
+        if (args.contains("radius")) {
+            request.radius = ParseNumber(args.at("radius"));
+            if (!request.radius || *request.radius <= 0) {
+                return std::nullopt;
+            }
+        }
+
+        static constexpr std::array<std::string_view, 4> CORNER_KEYS = {
+            "x0", "y0", "x1", "y1"};
+        std::array<double, 4> corners;
+        size_t found = 0;
+        for (size_t i = 0; i < CORNER_KEYS.size(); ++i) {
+            auto it = args.find(std::string(CORNER_KEYS[i]));
+            if (it == args.end()) {
+                continue;
+            }
+            auto value = ParseNumber(it->second);
+            if (!value) {
+                return std::nullopt;
+            }
+            corners[i] = *value;
+            ++found;
+        }
+        if (found == CORNER_KEYS.size()) {
+            request.viewport = app::AreaOfInterest::Viewport(
+                {corners[0], corners[1]}, {corners[2], corners[3]});
+        } else if (found != 0) {
+            return std::nullopt;
+        }
+
+        return request;
+    }
+
+   private:
+    static std::optional<double> ParseNumber(std::string_view text) {
+        double value = 0.0;
+        const auto [end, ec] =
+            std::from_chars(text.data(), text.data() + text.size(), value);
+        if (ec != std::errc{} || end != text.data() + text.size() ||
+            !std::isfinite(value)) {
+            return std::nullopt;
+        }
+        return value;
+    }
+};
@@ -1,16 +1,29 @@
 #pragma once
 
-#include <string>
+#include <optional>
+#include <string_view>
+#include <type_traits>
 
 #include <boost/json.hpp>
 
-inline std::optional<boost::json::object> Parse(const std::string& body) {
+// Request bodies are small, so they are parsed into a per-request arena on
+// the stack. The DOM dies with the arena: handler copies out what it needs
+// and returns an optional, which is empty when the body is not valid JSON.
+template <typename Handler>
+auto Parse(std::string_view body, Handler&& handler)
+    -> std::invoke_result_t<Handler, const boost::json::object&> {
+    static constexpr size_t ARENA_SIZE = 4096;
+
+    unsigned char arena[ARENA_SIZE];
+    boost::json::monotonic_resource resource(arena, sizeof(arena));
     boost::system::error_code ec;
-    const boost::json::value json_body_value = boost::json::parse(body, ec);
+    const boost::json::value json_body_value =
+        boost::json::parse(boost::json::string_view(body.data(), body.size()),
+                           ec, &resource);
 
     if (ec) {
         return std::nullopt;
     }
 
-    return json_body_value.as_object();
+    return handler(json_body_value.as_object());
 }
@@ -15,19 +15,17 @@ struct PlayerActionRequest {
         const std::string& body) {
         static constexpr boost::json::string_view direction_key = "move";
 
-        const auto json_body = Parse(body);
-        if (!json_body) {
-            return std::nullopt;
-        }
-
-        auto direction_it = json_body->find(direction_key);
-        if (direction_it == json_body->end()) {
-            return std::nullopt;
-        }
-
-        return PlayerActionRequest{
-            .direction = model::direction_converter::ToDirection(
-                std::string(direction_it->value().as_string()))};
+        return Parse(body, [](const boost::json::object& json_body)
+                                -> std::optional<PlayerActionRequest> {
+            auto direction_it = json_body.find(direction_key);
+            if (direction_it == json_body.end()) {
+                return std::nullopt;
+            }
+
+            return PlayerActionRequest{
+                .direction = model::direction_converter::ToDirection(
+                    std::string(direction_it->value().as_string()))};
+        });
     }
 };
 
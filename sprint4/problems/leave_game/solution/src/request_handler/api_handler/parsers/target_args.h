@@ -0,0 +1,42 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+
+// Splits the query of a request target into its key=value arguments
+inline std::unordered_map<std::string, std::string> ParseTargetArgs(
+    std::string_view req_target) {
+    const auto parse_arg = [](std::string_view arg) {
+        size_t equal_sign = arg.find('=');
+        std::string key = std::string(arg.substr(0, equal_sign));
+        std::string value = std::string(arg.substr(equal_sign + 1, arg.npos));
+
+        return std::make_pair(std::move(key), std::move(value));
+    };
+
+    std::unordered_map<std::string, std::string> args;
+
+    size_t prev = req_target.find('?') + 1;
+
+    size_t next_amper = req_target.find('&');
+    while (next_amper != req_target.npos) {
+        std::string arg;
+        size_t length = next_amper - prev;
+        arg = req_target.substr(prev, length);
+
+        auto parsed_arg = parse_arg(arg);
+        args.emplace(std::move(parsed_arg.first), std::move(parsed_arg.second));
+
+        prev = next_amper + 1;
+        next_amper = req_target.find('&', prev);
+    }
+
+    size_t length = next_amper - prev;
+    std::string last_arg = std::string(req_target.substr(prev, length));
+    auto parsed_arg = parse_arg(last_arg);
+    args.emplace(std::move(parsed_arg.first), std::move(parsed_arg.second));
+
+    return args;
+}
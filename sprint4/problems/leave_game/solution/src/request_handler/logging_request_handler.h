@@ -55,7 +55,7 @@ class LoggingRequestHandler {
         };
         LogRequest(client_ip, req.target(),
                    boost::beast::http::to_string(req.method()));
-        (*decorated_)(std::move(req), std::move(logging_sender));
+        (*decorated_)(client_ip, std::move(req), std::move(logging_sender));
     }
 
    private:
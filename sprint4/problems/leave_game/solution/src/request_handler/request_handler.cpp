@@ -1,6 +1,7 @@
 #include "request_handler.h"
 
 #include <string>
+#include <utility>
 
 #include <boost/beast/http/field.hpp>
 #include <boost/beast/http/file_body.hpp>
@@ -44,8 +45,14 @@ RequestHandler::JsonResponse RequestHandler::MakeJsonResponse(
     if (string_response.allow) {
         response.set(http::field::allow, *string_response.allow);
     }
-    response.body() = string_response.answer;
+    if (string_response.retry_after) {
+        response.set(http::field::retry_after, *string_response.retry_after);
+    }
+    if (string_response.vary) {
+        response.set(http::field::vary, *string_response.vary);
+    }
     response.content_length(string_response.answer.size());
+    response.body() = std::move(string_response.answer);
     response.keep_alive(keep_alive);
     return response;
 }
@@ -1,6 +1,8 @@
 #pragma once
 
 #include <memory>
+#include <optional>
+#include <string>
 #include <utility>
 #include <variant>
 
@@ -12,8 +14,10 @@
 
 #include "api_handler/api_handler.h"
 #include "file_handler.h"
+#include "request_handler/admission_control.h"
 #include "request_handler/utils/response_utils.h"
 #include "utils/logger.h"
+#include "utils/strand_inbox.h"
 
 #define BOOST_BEAST_USE_STD_STRING_VIEW
 
@@ -27,12 +31,20 @@ class RequestHandler : public std::enable_shared_from_this<RequestHandler> {
     using JsonResponse = http::response<http::string_body>;
     using FileResponse = http::response<http::file_body>;
 
-    explicit RequestHandler(std::filesystem::path static_files_root,
-                            app::Application::Pointer app_ptr, Strand strand,
-                            bool is_aviable_game_tick)
+    explicit RequestHandler(
+        std::filesystem::path static_files_root,
+        app::Application::Pointer app_ptr, Strand strand,
+        bool is_aviable_game_tick,
+        serialization::RequestRecorder::Pointer recorder = nullptr,
+        const utils::RateLimitConfig& rate_limits = {},
+        std::optional<std::string> admin_token = std::nullopt)
         : api_strand_(strand),
+          api_inbox_(std::make_shared<utils::StrandInbox<Strand>>(strand)),
+          are_moves_queued_(app_ptr->AreMovesQueued()),
+          admission_(rate_limits),
           api_handler_(std::make_shared<api_handler::ApiHandler>(
-              std::move(app_ptr), is_aviable_game_tick)),
+              std::move(app_ptr), is_aviable_game_tick, std::move(recorder),
+              std::move(admin_token))),
           file_handler_(
               std::make_shared<file_handler::FileHandler>(static_files_root)) {}
 
@@ -40,7 +52,8 @@ class RequestHandler : public std::enable_shared_from_this<RequestHandler> {
     RequestHandler& operator=(const RequestHandler&) = delete;
 
     template <typename Body, typename Allocator, typename Send>
-    void operator()(http::request<Body, http::basic_fields<Allocator>>&& req,
+    void operator()(boost::string_view client_ip,
+                    http::request<Body, http::basic_fields<Allocator>>&& req,
                     Send&& send) {
         using namespace std::literals;
         auto version = req.version();
@@ -49,6 +62,26 @@ class RequestHandler : public std::enable_shared_from_this<RequestHandler> {
 
         try {
             if (target.starts_with(api_handler::ApiHandler::API_KEY)) {
+                const auto authorization = req[http::field::authorization];
+                if (auto rejection = admission_.Admit(
+                        {client_ip.data(), client_ip.size()},
+                        {authorization.data(), authorization.size()})) {
+                    return send(MakeJsonResponse(version, keep_alive,
+                                                 std::move(*rejection)));
+                }
+
+                if (are_moves_queued_ &&
+                    api_handler::ApiHandler::IsPlayerAction(target)) {
+                    return send(MakeJsonResponse(version, keep_alive,
+                                                 (*api_handler_)(req)));
+                }
+
+                if (auto rejection =
+                        admission_.AdmitToStrand(api_inbox_->GetSize())) {
+                    return send(MakeJsonResponse(version, keep_alive,
+                                                 std::move(*rejection)));
+                }
+
                 auto handle = [self = shared_from_this(), send,
                                req = std::forward<decltype(req)>(req), version,
                                keep_alive] {
@@ -60,7 +93,7 @@ class RequestHandler : public std::enable_shared_from_this<RequestHandler> {
                         send(self->ReportServerError(version, keep_alive));
                     }
                 };
-                return boost::asio::dispatch(api_strand_, handle);
+                return api_inbox_->Push(std::move(handle));
             }
 
             return std::visit(
@@ -76,6 +109,12 @@ class RequestHandler : public std::enable_shared_from_this<RequestHandler> {
 
    private:
     Strand api_strand_;
+    // API requests reach the strand through a lock-free queue, so I/O
+    // threads don't contend on the strand lock for every request
+    std::shared_ptr<utils::StrandInbox<Strand>> api_inbox_;
+    // Queued moves are handled on the calling thread
+    bool are_moves_queued_;
+    AdmissionControl admission_;
     std::shared_ptr<api_handler::ApiHandler> api_handler_;
     std::shared_ptr<file_handler::FileHandler> file_handler_;
 
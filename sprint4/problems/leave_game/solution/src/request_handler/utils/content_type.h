@@ -9,6 +9,7 @@ using namespace std::literals;
 
 constexpr static boost::string_view TEXT_HTML = "text/html";
 constexpr static boost::string_view JSON = "application/json";
+constexpr static boost::string_view CBOR = "application/cbor";
 constexpr static boost::string_view CSS = "text/css";
 constexpr static boost::string_view TEXT = "text/plain";
 constexpr static boost::string_view JS = "text/javascript";
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <string_view>
+
+#include <boost/utility/string_view.hpp>
+
+#include "request_handler/utils/content_type.h"
+
+namespace request_handler::encoding {
+
+// Body encodings of API responses that have more than one
+enum class Encoding { JSON, CBOR };
+
+namespace detail {
+
+inline std::string_view Trim(std::string_view str) {
+    while (!str.empty() && (str.front() == ' ' || str.front() == '\t')) {
+        str.remove_prefix(1);
+    }
+    while (!str.empty() && (str.back() == ' ' || str.back() == '\t')) {
+        str.remove_suffix(1);
+    }
+    return str;
+}
+
+inline bool EqualsIgnoreCase(std::string_view lhs, boost::string_view rhs) {
+    return lhs.size() == rhs.size() &&
+           std::equal(lhs.begin(), lhs.end(), rhs.begin(), [](char a, char b) {
+               return std::tolower(static_cast<unsigned char>(a)) ==
+                      std::tolower(static_cast<unsigned char>(b));
+           });
+}
+
+// Weight of one media range of an Accept header, 1 without a q parameter.
+// A malformed q counts as 0, so the range is ignored.
+inline double Quality(std::string_view params) {
+    while (!params.empty()) {
+        const auto semicolon = params.find(';');
+        const auto param = Trim(params.substr(0, semicolon));
+        params = semicolon == params.npos ? std::string_view{}
+                                          : params.substr(semicolon + 1);
+        if (param.size() < 2 || (param[0] != 'q' && param[0] != 'Q') ||
+            param[1] != '=') {
+            continue;
+        }
+        double quality = 0.0;
+        const auto value = param.substr(2);
+        const auto [end, ec] = std::from_chars(
+            value.data(), value.data() + value.size(), quality);
+        if (ec != std::errc{} || end != value.data() + value.size() ||
+            quality < 0.0 || quality > 1.0) {
+            return 0.0;
+        }
+        return quality;
+    }
+    return 1.0;
+}
+
+}  // namespace detail
+
+// Picks the encoding for an Accept header. CBOR only when the client lists
+// application/cbor and weighs it at least as much as JSON, anything else,
+// no header included, keeps the JSON answer existing clients get.
+inline Encoding Negotiate(std::string_view accept) {
+    double cbor = 0.0;
+    double json = 0.0;
+    while (!accept.empty()) {
+        const auto comma = accept.find(',');
+        const auto range = accept.substr(0, comma);
+        accept = comma == accept.npos ? std::string_view{}
+                                      : accept.substr(comma + 1);
+
+        const auto semicolon = range.find(';');
+        const auto media = detail::Trim(range.substr(0, semicolon));
+        const double quality =
+            semicolon == range.npos
+                ? 1.0
+                : detail::Quality(range.substr(semicolon + 1));
+        if (detail::EqualsIgnoreCase(media, content_type::CBOR)) {
+            cbor = std::max(cbor, quality);
+        } else if (detail::EqualsIgnoreCase(media, content_type::JSON) ||
+                   media == "application/*" || media == "*/*") {
+            json = std::max(json, quality);
+        }
+    }
+    return cbor > 0.0 && cbor >= json ? Encoding::CBOR : Encoding::JSON;
+}
+
+inline boost::string_view ContentType(Encoding encoding) {
+    return encoding == Encoding::CBOR ? content_type::CBOR
+                                      : content_type::JSON;
+}
+
+}  // namespace request_handler::encoding
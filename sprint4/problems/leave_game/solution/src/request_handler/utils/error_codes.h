@@ -11,5 +11,7 @@ inline constexpr std::string_view kNotFound = "notFound";
 inline constexpr std::string_view kInvalidToken = "invalidToken";
 inline constexpr std::string_view kMapNotFound = "mapNotFound";
 inline constexpr std::string_view kInvalidArgument = "invalidArgument";
+inline constexpr std::string_view kTooManyRequests = "tooManyRequests";
+inline constexpr std::string_view kServerBusy = "serverBusy";
 
 }  // namespace request_handler::error_codes
@@ -2,11 +2,13 @@
 
 #include <optional>
 #include <string>
+#include <utility>
 
 #include <boost/beast/http/status.hpp>
 #include <boost/json.hpp>
 
 #include "request_handler/utils/content_type.h"
+#include "utils/json_writer.h"
 
 namespace request_handler::response_utils {
 
@@ -19,16 +21,26 @@ struct StringResponse {
     boost::string_view content_type = content_type::TEXT;
     std::optional<boost::string_view> cache_control = std::nullopt;
     std::optional<boost::string_view> allow = std::nullopt;
+    std::optional<boost::string_view> retry_after = std::nullopt;
+    std::optional<boost::string_view> vary = std::nullopt;
 };
 
 namespace detail {
 
 static constexpr boost::string_view NO_CACHE_KEY = "no-cache";
+static constexpr boost::string_view VARY_ACCEPT = "Accept";
 
 inline std::string GetJsonResponse(std::string_view code,
                                    std::string_view message) {
-    boost::json::object body{{"code", code}, {"message", message}};
-    return boost::json::serialize(body);
+    std::string body;
+    utils::JsonWriter writer{body};
+    writer.BeginObject()
+        .Key("code")
+        .String(code)
+        .Key("message")
+        .String(message)
+        .EndObject();
+    return body;
 }
 
 }  // namespace detail
@@ -84,4 +96,15 @@ inline StringResponse MakeOkResponse(const boost::json::value& json_body) {
                           .cache_control = detail::NO_CACHE_KEY};
 }
 
+// For bodies already serialized by a json_converter writer, in the
+// encoding negotiated from the Accept header
+inline StringResponse MakeOkSerializedResponse(
+    std::string body, boost::string_view body_type = content_type::JSON) {
+    return StringResponse{.status = boost::beast::http::status::ok,
+                          .answer = std::move(body),
+                          .content_type = body_type,
+                          .cache_control = detail::NO_CACHE_KEY,
+                          .vary = detail::VARY_ACCEPT};
+}
+
 }  // namespace request_handler::response_utils
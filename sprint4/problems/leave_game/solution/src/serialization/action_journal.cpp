@@ -0,0 +1,299 @@
+#include "action_journal.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <optional>
+#include <stdexcept>
+#include <string_view>
+#include <system_error>
+#include <utility>
+
+#include <boost/crc.hpp>
+#include <boost/log/trivial.hpp>
+
+#include "app/use_cases/join_game_use_case.h"
+#include "app/use_cases/move_player.h"
+#include "serialization/binary_codec.h"
+
+namespace serialization {
+
+namespace {
+
+using namespace std::literals;
+
+enum class RecordType : std::uint8_t { Checkpoint = 1, Join, Move, Tick };
+
+constexpr size_t HEADER_SIZE = 2 * sizeof(std::uint32_t);
+
+std::uint32_t Crc32(std::string_view data) {
+    boost::crc_32_type crc;
+    crc.process_bytes(data.data(), data.size());
+    return crc.checksum();
+}
+
+BinaryWriter MakeRecord(RecordType type) {
+    BinaryWriter writer;
+    writer.U8(static_cast<std::uint8_t>(type));
+    return writer;
+}
+
+void WriteAll(int fd, std::string_view data) {
+    while (!data.empty()) {
+        const auto written = ::write(fd, data.data(), data.size());
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw std::system_error(errno, std::generic_category(),
+                                    "Journal write failed"s);
+        }
+        data.remove_prefix(static_cast<size_t>(written));
+    }
+}
+
+// The snapshot generation a checkpoint record continues, nullopt for the
+// other records
+std::optional<std::uint64_t> ReadGeneration(std::string_view payload) {
+    BinaryReader reader{payload};
+    if (static_cast<RecordType>(reader.U8()) != RecordType::Checkpoint) {
+        return std::nullopt;
+    }
+    return reader.U64();
+}
+
+// Returns false when the journal diverged from the recorded run
+bool ApplyRecord(std::string_view payload, app::Application& app) {
+    BinaryReader reader{payload};
+    switch (static_cast<RecordType>(reader.U8())) {
+        case RecordType::Checkpoint: {
+            app::JournalCheckpoint checkpoint{.generation = reader.U64(),
+                                              .seed = reader.U64()};
+            const auto count = reader.U32();
+            for (std::uint32_t i = 0; i < count; ++i) {
+                checkpoint.loot_timers.emplace_back(reader.I64());
+            }
+            app.RestoreCheckpoint(checkpoint);
+            return true;
+        }
+        case RecordType::Join: {
+            model::Map::Id map_id{reader.String()};
+            auto name = reader.String();
+            const app::Token token{reader.String()};
+            return app.JoinGame(std::move(map_id), name).token == token;
+        }
+        case RecordType::Move: {
+            const app::Token token{reader.String()};
+            const auto direction = static_cast<model::Direction>(reader.U8());
+            try {
+                app.MovePlayer(token, direction);
+            } catch (const MovePlayerError&) {
+                return false;
+            }
+            return true;
+        }
+        case RecordType::Tick: {
+            const std::chrono::milliseconds delta{reader.I64()};
+            const auto retired = reader.U32();
+            app.Tick(delta);
+            return app.GetLastTickRetiredCount() == retired;
+        }
+    }
+    throw std::invalid_argument("Unknown journal record type"s);
+}
+
+}  // namespace
+
+FileActionJournal::FileActionJournal(const std::filesystem::path& path) {
+    fd_ = ::open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC,
+                 0644);
+    if (fd_ < 0) {
+        throw std::system_error(errno, std::generic_category(),
+                                "Can't open journal " + path.string());
+    }
+    writer_ = std::thread([this] { WriteLoop(); });
+}
+
+FileActionJournal::~FileActionJournal() {
+    {
+        std::lock_guard lock{mutex_};
+        stop_ = true;
+    }
+    has_pending_.notify_one();
+    writer_.join();
+    ::close(fd_);
+}
+
+void FileActionJournal::Checkpoint(const app::JournalCheckpoint& checkpoint) {
+    auto writer = MakeRecord(RecordType::Checkpoint);
+    writer.U64(checkpoint.generation).U64(checkpoint.seed).U32(
+        static_cast<std::uint32_t>(checkpoint.loot_timers.size()));
+    for (const auto timer : checkpoint.loot_timers) {
+        writer.I64(timer.count());
+    }
+    Append(writer.GetData());
+}
+
+void FileActionJournal::Join(const model::Map::Id& map_id,
+                             const std::string& name,
+                             const app::Token& token) {
+    Append(MakeRecord(RecordType::Join)
+               .String(*map_id)
+               .String(name)
+               .String(*token)
+               .GetData());
+}
+
+void FileActionJournal::Move(const app::Token& token,
+                             model::Direction direction) {
+    Append(MakeRecord(RecordType::Move)
+               .String(*token)
+               .U8(static_cast<std::uint8_t>(direction))
+               .GetData());
+}
+
+void FileActionJournal::Tick(std::chrono::milliseconds delta,
+                             std::uint32_t retired_players) {
+    Append(MakeRecord(RecordType::Tick)
+               .I64(delta.count())
+               .U32(retired_players)
+               .GetData());
+}
+
+void FileActionJournal::Flush() {
+    std::unique_lock lock{mutex_};
+    const auto target = appended_bytes_;
+    synced_.wait(lock, [this, target] { return synced_bytes_ >= target; });
+}
+
+void FileActionJournal::Truncate() {
+    std::unique_lock lock{mutex_};
+    pending_.clear();
+    synced_.wait(lock, [this] { return !is_writing_; });
+    if (::ftruncate(fd_, 0) != 0) {
+        BOOST_LOG_TRIVIAL(error)
+            << "Journal truncation failed: " << std::strerror(errno);
+    }
+    synced_bytes_ = appended_bytes_;
+    lock.unlock();
+    synced_.notify_all();
+}
+
+void FileActionJournal::Append(const std::string& payload) {
+    {
+        BinaryWriter header;
+        header.U32(static_cast<std::uint32_t>(payload.size()))
+            .U32(Crc32(payload));
+
+        std::lock_guard lock{mutex_};
+        pending_.append(header.GetData());
+        pending_.append(payload);
+        appended_bytes_ += HEADER_SIZE + payload.size();
+    }
+    has_pending_.notify_one();
+}
+
+void FileActionJournal::WriteLoop() {
+    std::unique_lock lock{mutex_};
+    while (true) {
+        has_pending_.wait(lock, [this] { return stop_ || !pending_.empty(); });
+        if (pending_.empty()) {
+            return;
+        }
+
+        writing_.swap(pending_);
+        const auto batch_end = appended_bytes_;
+        is_writing_ = true;
+        lock.unlock();
+
+        try {
+            WriteAll(fd_, writing_);
+            if (::fdatasync(fd_) != 0) {
+                throw std::system_error(errno, std::generic_category(),
+                                        "Journal sync failed"s);
+            }
+        } catch (const std::exception& ex) {
+            BOOST_LOG_TRIVIAL(error) << ex.what();
+        }
+        writing_.clear();
+
+        lock.lock();
+        is_writing_ = false;
+        synced_bytes_ = std::max(synced_bytes_, batch_end);
+        synced_.notify_all();
+    }
+}
+
+JournalReplayResult ReplayActionJournal(const std::filesystem::path& path,
+                                        app::Application& app) {
+    JournalReplayResult result;
+    std::ifstream input(path, std::ios::binary);
+    if (!input.is_open()) {
+        return result;
+    }
+    const std::string data{std::istreambuf_iterator<char>(input),
+                           std::istreambuf_iterator<char>()};
+
+    app.SetWriteRetiredPlayers(false);
+    size_t pos = 0;
+    while (pos < data.size()) {
+        if (data.size() - pos < HEADER_SIZE) {
+            result.is_torn = true;
+            break;
+        }
+        BinaryReader header{std::string_view{data}.substr(pos, HEADER_SIZE)};
+        const auto size = header.U32();
+        const auto crc = header.U32();
+        if (data.size() - pos - HEADER_SIZE < size) {
+            result.is_torn = true;
+            break;
+        }
+        const std::string_view payload{data.data() + pos + HEADER_SIZE,
+                                       size};
+        if (Crc32(payload) != crc) {
+            result.is_torn = true;
+            break;
+        }
+
+        try {
+            // A journal starts with the checkpoint of the snapshot it
+            // follows. One of another generation was left by a crash
+            // between saving a snapshot and truncating the journal, the
+            // snapshot already holds its actions.
+            const auto generation = ReadGeneration(payload);
+            if ((result.records == 0 || generation) &&
+                generation != app.GetSnapshotGeneration()) {
+                BOOST_LOG_TRIVIAL(error)
+                    << "Journal record " << result.records
+                    << " does not continue snapshot generation "
+                    << app.GetSnapshotGeneration();
+                result.is_stale = true;
+                break;
+            }
+            // Later records would be applied to a state known to be wrong
+            if (!ApplyRecord(payload, app)) {
+                BOOST_LOG_TRIVIAL(error)
+                    << "Journal replay diverged at record " << result.records;
+                result.is_diverged = true;
+                break;
+            }
+        } catch (const std::exception& ex) {
+            BOOST_LOG_TRIVIAL(error) << "Journal record " << result.records
+                                     << " is not applicable: " << ex.what();
+            result.is_torn = true;
+            break;
+        }
+        pos += HEADER_SIZE + size;
+        ++result.records;
+    }
+    app.SetWriteRetiredPlayers(true);
+
+    result.valid_size = pos;
+    return result;
+}
+
+}  // namespace serialization
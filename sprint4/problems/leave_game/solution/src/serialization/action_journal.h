@@ -0,0 +1,86 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "app/action_journal.h"
+#include "app/application.h"
+
+namespace serialization {
+
+// Append-only binary journal of the actions applied since the last
+// snapshot. Every record is framed as [size:u32][crc32:u32][payload] in
+// little-endian order, so a torn tail after a crash is detected on replay.
+//
+// Callers only append to a memory buffer. A background thread writes the
+// buffer and calls fdatasync; records that arrive during one sync go out
+// together with the next one (group commit).
+class FileActionJournal : public app::ActionJournal {
+   public:
+    using Pointer = std::shared_ptr<FileActionJournal>;
+
+    explicit FileActionJournal(const std::filesystem::path& path);
+    ~FileActionJournal() override;
+
+    FileActionJournal(const FileActionJournal&) = delete;
+    FileActionJournal& operator=(const FileActionJournal&) = delete;
+
+    void Checkpoint(const app::JournalCheckpoint& checkpoint) override;
+
+    void Join(const model::Map::Id& map_id, const std::string& name,
+              const app::Token& token) override;
+
+    void Move(const app::Token& token, model::Direction direction) override;
+
+    void Tick(std::chrono::milliseconds delta,
+              std::uint32_t retired_players) override;
+
+    // Blocks until everything appended so far is on disk
+    void Flush();
+
+    // Drops the journal once a snapshot holds everything in it. Records
+    // not written yet are dropped too.
+    void Truncate();
+
+   private:
+    void Append(const std::string& payload);
+    void WriteLoop();
+
+    int fd_ = -1;
+    std::mutex mutex_;
+    std::condition_variable has_pending_;
+    std::condition_variable synced_;
+    std::string pending_;
+    std::string writing_;
+    std::uint64_t appended_bytes_ = 0;
+    std::uint64_t synced_bytes_ = 0;
+    bool is_writing_ = false;
+    bool stop_ = false;
+    std::thread writer_;
+};
+
+struct JournalReplayResult {
+    size_t records = 0;
+    // Bytes of the records applied, anything after them is not replayable
+    std::uintmax_t valid_size = 0;
+    bool is_torn = false;
+    // The journal continues another snapshot than the one app holds
+    bool is_stale = false;
+    // A record did not reproduce its recorded outcome
+    bool is_diverged = false;
+};
+
+// Applies the journal to app, which must hold the snapshot the journal was
+// started from. Retired players are not written to the database again.
+// Stops at the first incomplete or corrupted record, at a checkpoint of
+// another snapshot generation and at the first record that diverges. The
+// diverged record has been applied already.
+JournalReplayResult ReplayActionJournal(const std::filesystem::path& path,
+                                        app::Application& app);
+
+}  // namespace serialization
@@ -1,8 +1,12 @@
 #pragma once
 
+#include <chrono>
+#include <cstdint>
 #include <deque>
 #include <functional>
+#include <iterator>
 #include <memory>
+#include <stdexcept>
 #include <string>
 #include <unordered_map>
 #include <utility>
@@ -12,6 +16,7 @@
 #include <boost/serialization/deque.hpp>
 #include <boost/serialization/unordered_map.hpp>
 #include <boost/serialization/vector.hpp>
+#include <boost/serialization/version.hpp>
 
 #include "app/application.h"
 #include "app/game/game_session.h"
@@ -172,7 +177,9 @@ class GameSessionRepr {
     GameSessionRepr() = default;
 
     explicit GameSessionRepr(const app::GameSession& session)
-        : map_id_(session.GetMapId()), last_item_id_(session.GetLastItemId()) {
+        : map_id_(session.GetMapId()),
+          last_item_id_(session.GetLastItemId()),
+          next_dog_id_(session.next_dog_id_) {
         for (const auto& dog : session.GetDogs()) {
             dogs_.emplace_back(dog);
         }
@@ -182,16 +189,23 @@ class GameSessionRepr {
     }
 
     template <typename Archive>
-    void serialize(Archive& ar, [[maybe_unused]] const unsigned version) {
+    void serialize(Archive& ar, const unsigned version) {
         ar&* map_id_;
         ar & dogs_;
         ar & items_;
         ar & last_item_id_;
+        if (version >= 1) {
+            ar & next_dog_id_;
+        } else {
+            // Dogs were never removed before, their ids are 0..size - 1
+            next_dog_id_ = static_cast<std::uint32_t>(dogs_.size());
+        }
     }
 
     app::GameSession Restore(
         std::function<model::Map::Pointer(model::Map::Id)> map_finder) const {
         app::GameSession game_session(map_finder(map_id_), last_item_id_);
+        game_session.next_dog_id_ = next_dog_id_;
         for (const auto& dog_repr : dogs_) {
             auto dog = dog_repr.Restore();
             game_session.dogs_.push_back(dog);
@@ -207,6 +221,7 @@ class GameSessionRepr {
     std::vector<serialization::DogRepr> dogs_;
     app::GameSession::LootPositionsVector items_;
     std::uint32_t last_item_id_;
+    std::uint32_t next_dog_id_ = 0;
 };
 
 class GameSessionHandlerRepr {
@@ -229,11 +244,8 @@ class GameSessionHandlerRepr {
         app::GameSessionHandler::Pointer handler =
             std::make_shared<app::GameSessionHandler>();
         for (const auto& session_repr : sessions_) {
-            const auto session = session_repr.Restore(map_finder);
-            auto game_session_ptr = handler->game_sessions_.emplace_back(
-                std::make_shared<app::GameSession>(session));
-            handler->map_id_to_game_session_[session.GetMap()->GetId()]
-                .push_back(game_session_ptr);
+            handler->AddGameSession(std::make_shared<app::GameSession>(
+                session_repr.Restore(map_finder)));
         }
         return handler;
     }
@@ -248,17 +260,22 @@ class GameRepr {
 
     explicit GameRepr(const app::Game& game)
         : handler_(*game.game_session_handler_),
-          default_dog_speed_(game.default_dog_speed_) {
+          default_dog_speed_(game.default_dog_speed_),
+          dog_retirement_time_(game.dog_retirement_time_.count()) {
         for (const auto& map : game.maps_) {
             maps_.emplace_back(*map);
         }
     }
 
     template <typename Archive>
-    void serialize(Archive& ar, [[maybe_unused]] const unsigned version) {
+    void serialize(Archive& ar, const unsigned version) {
         ar & maps_;
         ar & handler_;
         ar & default_dog_speed_;
+        // Snapshots without it restore the default retirement time
+        if (version >= 1) {
+            ar & dog_retirement_time_;
+        }
     }
 
     app::Game::Pointer Restore() const {
@@ -275,13 +292,16 @@ class GameRepr {
             throw std::runtime_error("Can't find map with this id: " + *map_id);
         };
         return std::make_shared<app::Game>(
-            maps, default_dog_speed_, handler_.Restore(std::move(map_finder)));
+            maps, default_dog_speed_, handler_.Restore(std::move(map_finder)),
+            std::chrono::milliseconds(dog_retirement_time_));
     }
 
    private:
     std::vector<serialization::MapRepr> maps_;
     serialization::GameSessionHandlerRepr handler_;
     double default_dog_speed_;
+    std::chrono::milliseconds::rep dog_retirement_time_ =
+        app::detail::DEFAULT_DOG_RETIREMENT_TIME.count();
 };
 
 class PlayerRepr {
@@ -306,7 +326,7 @@ class PlayerRepr {
             session_ptr->GetDogs().begin(), session_ptr->GetDogs().end(),
             [this](const model::Dog& dog) { return dog.GetId() == dog_id_; });
         model::Dog::Pointer dog = &const_cast<model::Dog&>(*dog_it);
-        return app::Player(session_ptr, dog);
+        return app::Player(session_ptr.get(), dog);
     }
 
    private:
@@ -318,10 +338,11 @@ class PlayersRepr {
    public:
     PlayersRepr() = default;
 
-    explicit PlayersRepr(const app::Players& players)
-        : tokens_(players.tokens_) {
+    explicit PlayersRepr(const app::Players& players) {
         for (const auto& player : players.players_) {
             players_.emplace_back(player);
+            tokens_.push_back(app::token::ToToken(
+                players.player_to_token_.at(player.GetId())));
         }
     }
 
@@ -334,21 +355,14 @@ class PlayersRepr {
         std::function<app::GameSession::Pointer(model::Map::Id)>
             game_session_finder) const {
         app::Players::Pointer players = std::make_shared<app::Players>();
-        for (const auto& player_repr : players_) {
+        for (size_t i = 0; i < players_.size(); ++i) {
+            auto key = app::token::ParseKey(*tokens_.at(i));
+            if (!key) {
+                throw std::runtime_error("Invalid token in the saved state");
+            }
             players->players_.push_back(
-                player_repr.Restore(game_session_finder));
-        }
-
-        players->tokens_ = tokens_;
-        for (size_t i = 0; i < players_.size(); i++) {
-            auto& player = players->players_[i];
-            auto& token = players->tokens_[i];
-            players->session_to_player_.emplace(
-                app::PlayerSession{player.GetId(),
-                                   player.GetSession()->GetMap()->GetId()},
-                &player);
-            players->token_to_player_.emplace(*token, &player);
-            players->player_to_token_.emplace(player.GetId(), &token);
+                players_[i].Restore(game_session_finder));
+            players->Index(std::prev(players->players_.end()), *key);
         }
         return players;
     }
@@ -454,16 +468,21 @@ class ApplicationRepr {
           loot_generator_(*application.loot_generator_),
           loot_handler_(*application.loot_handler_),
           loot_number_map_handler_(*application.loot_number_map_handler_),
-          is_random_spawn_point_(application.is_random_spawn_point_) {}
+          is_random_spawn_point_(application.is_random_spawn_point_),
+          snapshot_generation_(application.snapshot_generation_) {}
 
     template <typename Archive>
-    void serialize(Archive& archive, [[maybe_unused]] const unsigned version) {
+    void serialize(Archive& archive, const unsigned version) {
         archive & players_;
         archive & game_;
         archive & loot_generator_;
         archive & loot_handler_;
         archive & loot_number_map_handler_;
         archive & is_random_spawn_point_;
+        // Snapshots without it match only journals of generation 0
+        if (version >= 1) {
+            archive & snapshot_generation_;
+        }
     }
 
     [[nodiscard]] app::Application::Pointer Restore() const {
@@ -471,10 +490,12 @@ class ApplicationRepr {
         auto players = players_.Restore([&game](const model::Map::Id map_id) {
             return game->FindGameSession(map_id);
         });
-        return std::make_unique<app::Application>(
+        auto application = std::make_unique<app::Application>(
             players, game, loot_generator_.Restore(), loot_handler_.Restore(),
             loot_number_map_handler_.Restore(), is_random_spawn_point_,
             postgres::CreateFactory());
+        application->snapshot_generation_ = snapshot_generation_;
+        return application;
     }
 
    private:
@@ -484,6 +505,12 @@ class ApplicationRepr {
     serialization::LootHandlerRepr loot_handler_;
     serialization::LootNumberMapHandlerRepr loot_number_map_handler_;
     bool is_random_spawn_point_;
+    std::uint64_t snapshot_generation_ = 0;
 };
 
 }  // namespace serialization
+
+// Qualified from the root, the macro expands inside boost::serialization
+BOOST_CLASS_VERSION(::serialization::GameSessionRepr, 1)
+BOOST_CLASS_VERSION(::serialization::GameRepr, 1)
+BOOST_CLASS_VERSION(::serialization::ApplicationRepr, 1)
@@ -8,9 +8,11 @@
 
 #include "app/application.h"
 #include "serialization/application_serialization.h"
+#include "utils/profiler.h"
 
 void SaveApplicationState(app::Application::Pointer app,
                           std::filesystem::path state_file) {
+    PROFILE_SCOPE("SaveApplicationState");
     std::ofstream ofs(state_file);
     if (!ofs.is_open()) {
         BOOST_LOG_TRIVIAL(info) << "Invalid state file for saving application: "
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+namespace serialization {
+
+// Little-endian field encoding shared by the journal and the request
+// recording. Fixed-width fields are used where records must be patched or
+// checksummed, varints where size matters.
+class BinaryWriter {
+   public:
+    BinaryWriter& U8(std::uint8_t value) {
+        data_.push_back(static_cast<char>(value));
+        return *this;
+    }
+
+    BinaryWriter& U32(std::uint32_t value) { return Bytes(value, 4); }
+
+    BinaryWriter& U64(std::uint64_t value) { return Bytes(value, 8); }
+
+    BinaryWriter& I64(std::int64_t value) {
+        return U64(static_cast<std::uint64_t>(value));
+    }
+
+    // LEB128, 7 bits per byte
+    BinaryWriter& Varint(std::uint64_t value) {
+        while (value >= 0x80) {
+            U8(static_cast<std::uint8_t>(value | 0x80));
+            value >>= 7;
+        }
+        return U8(static_cast<std::uint8_t>(value));
+    }
+
+    BinaryWriter& String(std::string_view str) {
+        U32(static_cast<std::uint32_t>(str.size()));
+        data_.append(str);
+        return *this;
+    }
+
+    BinaryWriter& ShortString(std::string_view str) {
+        Varint(str.size());
+        data_.append(str);
+        return *this;
+    }
+
+    const std::string& GetData() const noexcept { return data_; }
+
+    void Clear() noexcept { data_.clear(); }
+
+   private:
+    BinaryWriter& Bytes(std::uint64_t value, int count) {
+        for (int i = 0; i < count; ++i) {
+            data_.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+        }
+        return *this;
+    }
+
+    std::string data_;
+};
+
+// Reads fields in the order BinaryWriter wrote them. Running past the end
+// of the data throws std::out_of_range.
+class BinaryReader {
+   public:
+    explicit BinaryReader(std::string_view data) : data_(data) {}
+
+    std::uint8_t U8() { return static_cast<std::uint8_t>(Bytes(1)); }
+
+    std::uint32_t U32() { return static_cast<std::uint32_t>(Bytes(4)); }
+
+    std::uint64_t U64() { return Bytes(8); }
+
+    std::int64_t I64() { return static_cast<std::int64_t>(U64()); }
+
+    std::uint64_t Varint() {
+        std::uint64_t value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            const auto byte = U8();
+            value |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0) {
+                return value;
+            }
+        }
+        throw std::out_of_range("Varint is too long");
+    }
+
+    std::string String() { return Take(U32()); }
+
+    std::string ShortString() { return Take(Varint()); }
+
+    bool IsEmpty() const noexcept { return pos_ == data_.size(); }
+
+    size_t GetPosition() const noexcept { return pos_; }
+
+   private:
+    void Require(size_t count) const {
+        if (data_.size() - pos_ < count) {
+            throw std::out_of_range("Binary data is too short");
+        }
+    }
+
+    std::string Take(size_t size) {
+        Require(size);
+        std::string str{data_.substr(pos_, size)};
+        pos_ += size;
+        return str;
+    }
+
+    std::uint64_t Bytes(int count) {
+        Require(count);
+        std::uint64_t value = 0;
+        for (int i = 0; i < count; ++i) {
+            value |= static_cast<std::uint64_t>(
+                         static_cast<unsigned char>(data_[pos_ + i]))
+                     << (8 * i);
+        }
+        pos_ += count;
+        return value;
+    }
+
+    std::string_view data_;
+    size_t pos_ = 0;
+};
+
+}  // namespace serialization
@@ -0,0 +1,242 @@
+#include "config_cache.h"
+
+#include <chrono>
+#include <exception>
+#include <fstream>
+#include <memory>
+#include <optional>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include <boost/archive/binary_iarchive.hpp>
+#include <boost/archive/binary_oarchive.hpp>
+#include <boost/log/trivial.hpp>
+
+#include "app/game/game_session_handler.h"
+#include "serialization/application_serialization.h"
+
+namespace serialization {
+
+namespace {
+
+// Bumped whenever the layout below changes
+constexpr std::uint32_t CONFIG_CACHE_VERSION = 2;
+
+// MapRepr is shaped for the application state and always stores a dog
+// speed, the config has to keep maps without one
+class MapConfigRepr {
+   public:
+    MapConfigRepr() = default;
+
+    explicit MapConfigRepr(const model::Map& map)
+        : id_(map.GetId()),
+          name_(map.GetName()),
+          has_dog_speed_(map.GetMaxSpeed().has_value()),
+          dog_speed_(map.GetMaxSpeed().value_or(0.0)),
+          number_loot_types_(map.GetNumberOfLootTypes()) {
+        roads_.reserve(map.GetRoads().size());
+        for (const auto& road : map.GetRoads()) {
+            roads_.emplace_back(*road);
+        }
+        buildings_.reserve(map.GetBuildings().size());
+        for (const auto& building : map.GetBuildings()) {
+            buildings_.emplace_back(building);
+        }
+        offices_.reserve(map.GetOffices().size());
+        for (const auto& office : map.GetOffices()) {
+            offices_.emplace_back(office);
+        }
+    }
+
+    template <typename Archive>
+    void serialize(Archive& ar, [[maybe_unused]] const unsigned version) {
+        ar & id_;
+        ar & name_;
+        ar & roads_;
+        ar & buildings_;
+        ar & offices_;
+        ar & has_dog_speed_;
+        ar & dog_speed_;
+        ar & number_loot_types_;
+    }
+
+    model::Map::Pointer Restore() const {
+        model::Map::Roads roads;
+        roads.reserve(roads_.size());
+        for (const auto& road : roads_) {
+            roads.push_back(std::make_shared<model::Road>(road.Restore()));
+        }
+        model::Map::Buildings buildings;
+        buildings.reserve(buildings_.size());
+        for (const auto& building : buildings_) {
+            buildings.push_back(building.Restore());
+        }
+        model::Map::Offices offices;
+        offices.reserve(offices_.size());
+        for (const auto& office : offices_) {
+            offices.push_back(office.Restore());
+        }
+        return std::make_shared<model::Map>(
+            id_, name_, std::move(roads), std::move(buildings),
+            std::move(offices),
+            has_dog_speed_ ? std::optional{dog_speed_} : std::nullopt,
+            number_loot_types_);
+    }
+
+   private:
+    model::Map::Id id_;
+    std::string name_;
+    std::vector<RoadRepr> roads_;
+    std::vector<BuildingRepr> buildings_;
+    std::vector<OfficeRepr> offices_;
+    bool has_dog_speed_ = false;
+    double dog_speed_ = 0.0;
+    int number_loot_types_ = {};
+};
+
+class RateLimitsRepr {
+   public:
+    RateLimitsRepr() = default;
+
+    explicit RateLimitsRepr(const utils::RateLimitConfig& limits)
+        : has_per_token_(limits.per_token.has_value()),
+          per_token_(limits.per_token.value_or(utils::TokenBucketLimit{})),
+          has_per_ip_(limits.per_ip.has_value()),
+          per_ip_(limits.per_ip.value_or(utils::TokenBucketLimit{})),
+          max_api_queue_(limits.max_api_queue.value_or(0)) {}
+
+    template <typename Archive>
+    void serialize(Archive& ar, [[maybe_unused]] const unsigned version) {
+        ar & has_per_token_;
+        ar & per_token_.rate;
+        ar & per_token_.burst;
+        ar & has_per_ip_;
+        ar & per_ip_.rate;
+        ar & per_ip_.burst;
+        ar & max_api_queue_;
+    }
+
+    utils::RateLimitConfig Restore() const {
+        return {.per_token = has_per_token_ ? std::optional{per_token_}
+                                           : std::nullopt,
+                .per_ip = has_per_ip_ ? std::optional{per_ip_} : std::nullopt,
+                .max_api_queue = max_api_queue_ > 0
+                                     ? std::optional{max_api_queue_}
+                                     : std::nullopt};
+    }
+
+   private:
+    bool has_per_token_ = false;
+    utils::TokenBucketLimit per_token_;
+    bool has_per_ip_ = false;
+    utils::TokenBucketLimit per_ip_;
+    // 0 when not set, the config never allows it
+    std::size_t max_api_queue_ = 0;
+};
+
+class ConfigRepr {
+   public:
+    ConfigRepr() = default;
+
+    explicit ConfigRepr(const json_loader::Config& config)
+        : default_dog_speed_(config.game->GetDefaultDogSpeed()),
+          dog_retirement_time_(config.game->GetDogRetirementTime().count()),
+          loot_generator_(*config.loot_generator),
+          loot_handler_(*config.loot_handler),
+          loot_number_map_handler_(*config.loot_number_map_handler),
+          rate_limits_(config.rate_limits) {
+        for (const auto& map : config.game->GetMaps()) {
+            maps_.emplace_back(*map);
+        }
+    }
+
+    template <typename Archive>
+    void serialize(Archive& ar, [[maybe_unused]] const unsigned version) {
+        ar & maps_;
+        ar & default_dog_speed_;
+        ar & dog_retirement_time_;
+        ar & loot_generator_;
+        ar & loot_handler_;
+        ar & loot_number_map_handler_;
+        ar & rate_limits_;
+    }
+
+    json_loader::Config Restore() const {
+        app::Game::Maps maps;
+        for (const auto& map : maps_) {
+            maps.push_back(map.Restore());
+        }
+        return {.game = std::make_shared<app::Game>(
+                    std::move(maps), default_dog_speed_,
+                    std::make_shared<app::GameSessionHandler>(),
+                    std::chrono::milliseconds(dog_retirement_time_)),
+                .loot_generator = loot_generator_.Restore(),
+                .loot_handler = loot_handler_.Restore(),
+                .loot_number_map_handler = loot_number_map_handler_.Restore(),
+                .rate_limits = rate_limits_.Restore()};
+    }
+
+   private:
+    std::vector<MapConfigRepr> maps_;
+    double default_dog_speed_ = 0.0;
+    std::chrono::milliseconds::rep dog_retirement_time_ = {};
+    LootGeneratorRepr loot_generator_;
+    LootHandlerRepr loot_handler_;
+    LootNumberMapHandlerRepr loot_number_map_handler_;
+    RateLimitsRepr rate_limits_;
+};
+
+}  // namespace
+
+std::optional<json_loader::Config> LoadConfigCache(
+    const std::filesystem::path& cache_file, std::uint64_t config_hash) {
+    std::ifstream ifs(cache_file, std::ios::binary);
+    if (!ifs.is_open()) {
+        return std::nullopt;
+    }
+
+    try {
+        boost::archive::binary_iarchive ia{ifs};
+        std::uint32_t version = 0;
+        std::uint64_t hash = 0;
+        ia >> version >> hash;
+        if (version != CONFIG_CACHE_VERSION || hash != config_hash) {
+            return std::nullopt;
+        }
+        ConfigRepr repr;
+        ia >> repr;
+        return repr.Restore();
+    } catch (const std::exception& ex) {
+        BOOST_LOG_TRIVIAL(info) << "Ignoring config cache "
+                                << cache_file.string() << ": " << ex.what();
+        return std::nullopt;
+    }
+}
+
+void SaveConfigCache(const std::filesystem::path& cache_file,
+                     std::uint64_t config_hash,
+                     const json_loader::Config& config) {
+    auto temp_file = cache_file;
+    temp_file += ".tmp";
+    try {
+        {
+            std::ofstream ofs(temp_file, std::ios::binary);
+            if (!ofs.is_open()) {
+                throw std::runtime_error("can't open " + temp_file.string());
+            }
+            boost::archive::binary_oarchive oa{ofs};
+            const std::uint32_t version = CONFIG_CACHE_VERSION;
+            const ConfigRepr repr(config);
+            oa << version << config_hash << repr;
+        }
+        std::filesystem::rename(temp_file, cache_file);
+    } catch (const std::exception& ex) {
+        BOOST_LOG_TRIVIAL(info) << "Can't write config cache "
+                                << cache_file.string() << ": " << ex.what();
+        std::error_code ec;
+        std::filesystem::remove(temp_file, ec);
+    }
+}
+
+}  // namespace serialization
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+
+#include "json_loader.h"
+
+namespace serialization {
+
+// Binary snapshot of the objects built from the config. It is keyed by the
+// hash of the config text, so a changed config never reuses a stale cache.
+// The archive is only meant for the machine and build that wrote it.
+
+// Returns nullopt when the cache is missing, unreadable or was built from
+// another config
+std::optional<json_loader::Config> LoadConfigCache(
+    const std::filesystem::path& cache_file, std::uint64_t config_hash);
+
+// Failures are logged, the server still runs without a cache
+void SaveConfigCache(const std::filesystem::path& cache_file,
+                     std::uint64_t config_hash,
+                     const json_loader::Config& config);
+
+}  // namespace serialization
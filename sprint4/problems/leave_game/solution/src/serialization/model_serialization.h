@@ -72,9 +72,9 @@ class DogRepr {
 
     explicit DogRepr(const model::Dog& dog)
         : id_(dog.id_),
-          name_(dog.name_),
+          name_(dog.GetName()),
           max_speed_(dog.max_speed_),
-          items_(dog.items_),
+          items_(dog.items_.ToItems()),
           scores_(dog.scores_),
           position_(dog.position_),
           direction_(dog.direction_),
@@ -94,7 +94,9 @@ class DogRepr {
 
     [[nodiscard]] model::Dog Restore() const {
         model::Dog dog(*id_, name_, max_speed_, position_);
-        dog.items_ = items_;
+        for (const auto& item : items_) {
+            dog.items_.Add(item);
+        }
         dog.scores_ = scores_;
         dog.direction_ = direction_;
         dog.velocity_per_second_ = velocity_per_second_;
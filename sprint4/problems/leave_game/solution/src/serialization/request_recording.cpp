@@ -0,0 +1,238 @@
+#include "request_recording.h"
+
+#include <iterator>
+#include <stdexcept>
+#include <utility>
+
+#include <boost/log/trivial.hpp>
+
+namespace serialization {
+
+namespace {
+
+using namespace std::literals;
+
+constexpr std::string_view RECORDING_MAGIC = "GREC"sv;
+// Bumped whenever the record layout changes. Version 1 records pages
+// without their cursor.
+constexpr std::uint8_t RECORDING_VERSION = 2;
+constexpr std::uint8_t MIN_RECORDING_VERSION = 1;
+constexpr size_t FLUSH_THRESHOLD = 64 * 1024;
+
+std::string ReadFile(const std::filesystem::path& path) {
+    std::ifstream input(path, std::ios::binary);
+    if (!input.is_open()) {
+        throw std::runtime_error("Can't open recording " + path.string());
+    }
+    return {std::istreambuf_iterator<char>(input),
+            std::istreambuf_iterator<char>()};
+}
+
+}  // namespace
+
+std::string_view RouteName(RecordedRoute route) {
+    switch (route) {
+        case RecordedRoute::Maps:
+            return "/maps"sv;
+        case RecordedRoute::Map:
+            return "/maps/{id}"sv;
+        case RecordedRoute::Join:
+            return "/game/join"sv;
+        case RecordedRoute::Players:
+            return "/game/players"sv;
+        case RecordedRoute::State:
+            return "/game/state"sv;
+        case RecordedRoute::Action:
+            return "/game/player/action"sv;
+        case RecordedRoute::Tick:
+            return "/game/tick"sv;
+        case RecordedRoute::Records:
+            return "/game/records"sv;
+    }
+    return "unknown"sv;
+}
+
+RequestRecorder::RequestRecorder(const std::filesystem::path& path)
+    : output_(path, std::ios::binary | std::ios::trunc) {
+    if (!output_.is_open()) {
+        throw std::runtime_error("Can't open recording " + path.string());
+    }
+    output_ << RECORDING_MAGIC;
+    output_.put(static_cast<char>(RECORDING_VERSION));
+}
+
+RequestRecorder::~RequestRecorder() {
+    std::lock_guard lock{mutex_};
+    output_ << writer_.GetData();
+}
+
+void RequestRecorder::ListMaps() {
+    std::lock_guard lock{mutex_};
+    Write({.route = RecordedRoute::Maps});
+}
+
+void RequestRecorder::GetMap(const model::Map::Id& map_id) {
+    std::lock_guard lock{mutex_};
+    Write({.route = RecordedRoute::Map, .map_id = *map_id});
+}
+
+void RequestRecorder::Join(const model::Map::Id& map_id,
+                           const std::optional<app::Token>& token) {
+    std::lock_guard lock{mutex_};
+    RecordedRequest request{.route = RecordedRoute::Join, .map_id = *map_id};
+    if (token) {
+        request.player = Pseudonym(*token);
+    }
+    Write(request);
+}
+
+void RequestRecorder::ListPlayers(const app::Token& token) {
+    std::lock_guard lock{mutex_};
+    Write({.route = RecordedRoute::Players, .player = Pseudonym(token)});
+}
+
+void RequestRecorder::GetState(const app::Token& token) {
+    std::lock_guard lock{mutex_};
+    Write({.route = RecordedRoute::State, .player = Pseudonym(token)});
+}
+
+void RequestRecorder::Move(const app::Token& token,
+                           model::Direction direction) {
+    std::lock_guard lock{mutex_};
+    Write({.route = RecordedRoute::Action,
+           .player = Pseudonym(token),
+           .direction = direction});
+}
+
+void RequestRecorder::Tick(std::chrono::milliseconds delta) {
+    std::lock_guard lock{mutex_};
+    Write({.route = RecordedRoute::Tick, .delta = delta});
+}
+
+void RequestRecorder::GetRecords(int start, int max_items,
+                                 const std::optional<std::string>& cursor) {
+    std::lock_guard lock{mutex_};
+    Write({.route = RecordedRoute::Records,
+           .start = start,
+           .max_items = max_items,
+           .cursor = cursor});
+}
+
+// Callers hold the mutex
+void RequestRecorder::Write(const RecordedRequest& request) {
+    const auto now = std::chrono::duration_cast<std::chrono::microseconds>(
+        Clock::now() - start_);
+    writer_.U8(static_cast<std::uint8_t>(request.route))
+        .Varint((now - last_time_).count());
+    last_time_ = now;
+
+    switch (request.route) {
+        case RecordedRoute::Maps:
+            break;
+        case RecordedRoute::Map:
+            writer_.ShortString(request.map_id);
+            break;
+        case RecordedRoute::Join:
+            writer_.ShortString(request.map_id).Varint(request.player);
+            break;
+        case RecordedRoute::Players:
+        case RecordedRoute::State:
+            writer_.Varint(request.player);
+            break;
+        case RecordedRoute::Action:
+            writer_.Varint(request.player)
+                .U8(static_cast<std::uint8_t>(request.direction));
+            break;
+        case RecordedRoute::Tick:
+            writer_.Varint(request.delta.count());
+            break;
+        case RecordedRoute::Records:
+            writer_.Varint(static_cast<std::uint32_t>(request.start))
+                .Varint(static_cast<std::uint32_t>(request.max_items))
+                .U8(request.cursor.has_value());
+            if (request.cursor) {
+                writer_.ShortString(*request.cursor);
+            }
+            break;
+    }
+
+    if (writer_.GetData().size() >= FLUSH_THRESHOLD) {
+        output_ << writer_.GetData();
+        writer_.Clear();
+        if (!output_) {
+            BOOST_LOG_TRIVIAL(error) << "Request recording write failed";
+        }
+    }
+}
+
+std::uint32_t RequestRecorder::Pseudonym(const app::Token& token) {
+    auto [it, inserted] = players_.try_emplace(
+        *token, static_cast<std::uint32_t>(players_.size() + 1));
+    return it->second;
+}
+
+RecordingReader::RecordingReader(const std::filesystem::path& path)
+    : data_(ReadFile(path)), reader_(data_) {
+    if (!data_.starts_with(RECORDING_MAGIC)) {
+        throw std::runtime_error(path.string() + " is not a recording"s);
+    }
+    for (size_t i = 0; i < RECORDING_MAGIC.size(); ++i) {
+        reader_.U8();
+    }
+    version_ = reader_.U8();
+    if (version_ < MIN_RECORDING_VERSION || version_ > RECORDING_VERSION) {
+        throw std::runtime_error("Unsupported recording version"s);
+    }
+}
+
+std::optional<RecordedRequest> RecordingReader::Next() {
+    if (reader_.IsEmpty()) {
+        return std::nullopt;
+    }
+
+    try {
+        RecordedRequest request;
+        request.route = static_cast<RecordedRoute>(reader_.U8());
+        last_time_ += std::chrono::microseconds(reader_.Varint());
+        request.time = last_time_;
+
+        switch (request.route) {
+            case RecordedRoute::Maps:
+                break;
+            case RecordedRoute::Map:
+                request.map_id = reader_.ShortString();
+                break;
+            case RecordedRoute::Join:
+                request.map_id = reader_.ShortString();
+                request.player = static_cast<std::uint32_t>(reader_.Varint());
+                break;
+            case RecordedRoute::Players:
+            case RecordedRoute::State:
+                request.player = static_cast<std::uint32_t>(reader_.Varint());
+                break;
+            case RecordedRoute::Action:
+                request.player = static_cast<std::uint32_t>(reader_.Varint());
+                request.direction = static_cast<model::Direction>(reader_.U8());
+                break;
+            case RecordedRoute::Tick:
+                request.delta = std::chrono::milliseconds(reader_.Varint());
+                break;
+            case RecordedRoute::Records:
+                request.start = static_cast<std::int32_t>(reader_.Varint());
+                request.max_items =
+                    static_cast<std::int32_t>(reader_.Varint());
+                if (version_ >= 2 && reader_.U8() != 0) {
+                    request.cursor = reader_.ShortString();
+                }
+                break;
+            default:
+                throw std::runtime_error("Unknown route in recording"s);
+        }
+        return request;
+    } catch (const std::out_of_range&) {
+        // The server was killed in the middle of a write
+        return std::nullopt;
+    }
+}
+
+}  // namespace serialization
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include "app/token.h"
+#include "model/map.h"
+#include "model/model.h"
+#include "serialization/binary_codec.h"
+
+namespace serialization {
+
+enum class RecordedRoute : std::uint8_t {
+    Maps,
+    Map,
+    Join,
+    Players,
+    State,
+    Action,
+    Tick,
+    Records
+};
+
+std::string_view RouteName(RecordedRoute route);
+
+// One API request as the application saw it. Tokens are replaced by the
+// number of the player they belong to and player names are not kept.
+struct RecordedRequest {
+    static constexpr std::uint32_t NO_PLAYER = 0;
+
+    // Since the recording started
+    std::chrono::microseconds time{0};
+    RecordedRoute route = RecordedRoute::Maps;
+    // 1-based in order of appearance, NO_PLAYER for failed joins
+    std::uint32_t player = NO_PLAYER;
+    std::string map_id = {};
+    model::Direction direction = model::Direction::NONE;
+    std::chrono::milliseconds delta{0};
+    int start = 0;
+    int max_items = 0;
+    // Set for records pages read by cursor, start is unused then
+    std::optional<std::string> cursor = std::nullopt;
+};
+
+// Writes requests to a compact binary file: a header followed by records
+// of a route byte, the varint time since the previous record and the
+// fields the route uses. Thread-safe.
+class RequestRecorder {
+   public:
+    using Pointer = std::shared_ptr<RequestRecorder>;
+
+    explicit RequestRecorder(const std::filesystem::path& path);
+    ~RequestRecorder();
+
+    RequestRecorder(const RequestRecorder&) = delete;
+    RequestRecorder& operator=(const RequestRecorder&) = delete;
+
+    void ListMaps();
+    void GetMap(const model::Map::Id& map_id);
+    // token is nullopt when the join failed
+    void Join(const model::Map::Id& map_id,
+              const std::optional<app::Token>& token);
+    void ListPlayers(const app::Token& token);
+    void GetState(const app::Token& token);
+    void Move(const app::Token& token, model::Direction direction);
+    void Tick(std::chrono::milliseconds delta);
+    void GetRecords(int start, int max_items,
+                    const std::optional<std::string>& cursor);
+
+   private:
+    using Clock = std::chrono::steady_clock;
+
+    void Write(const RecordedRequest& request);
+    std::uint32_t Pseudonym(const app::Token& token);
+
+    std::mutex mutex_;
+    std::ofstream output_;
+    BinaryWriter writer_;
+    Clock::time_point start_ = Clock::now();
+    std::chrono::microseconds last_time_{0};
+    std::unordered_map<std::string, std::uint32_t> players_;
+};
+
+// Reads a recording written by RequestRecorder. Throws std::runtime_error
+// for a file of another format; a truncated last record ends the stream.
+class RecordingReader {
+   public:
+    explicit RecordingReader(const std::filesystem::path& path);
+
+    RecordingReader(const RecordingReader&) = delete;
+    RecordingReader& operator=(const RecordingReader&) = delete;
+
+    std::optional<RecordedRequest> Next();
+
+   private:
+    std::string data_;
+    BinaryReader reader_;
+    std::uint8_t version_ = 0;
+    std::chrono::microseconds last_time_{0};
+};
+
+}  // namespace serialization
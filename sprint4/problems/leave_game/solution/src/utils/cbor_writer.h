@@ -0,0 +1,168 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#include <boost/json/value.hpp>
+
+namespace utils {
+
+// Appends CBOR (RFC 8949) to a string with the same interface as
+// JsonWriter, so a json_converter writer produces either encoding from one
+// description of the document. Objects and arrays are written with
+// indefinite length since their sizes are not known up front, numbers take
+// the shortest form that keeps their value.
+class CborWriter {
+   public:
+    explicit CborWriter(std::string& out) : out_(out) {}
+
+    CborWriter(const CborWriter&) = delete;
+    CborWriter& operator=(const CborWriter&) = delete;
+
+    CborWriter& BeginObject() {
+        out_.push_back(static_cast<char>(INDEFINITE_MAP));
+        return *this;
+    }
+
+    CborWriter& EndObject() {
+        out_.push_back(static_cast<char>(BREAK));
+        return *this;
+    }
+
+    CborWriter& BeginArray() {
+        out_.push_back(static_cast<char>(INDEFINITE_ARRAY));
+        return *this;
+    }
+
+    CborWriter& EndArray() {
+        out_.push_back(static_cast<char>(BREAK));
+        return *this;
+    }
+
+    CborWriter& Key(std::string_view key) { return String(key); }
+
+    CborWriter& String(std::string_view str) {
+        Head(TEXT_STRING, str.size());
+        out_.append(str);
+        return *this;
+    }
+
+    template <typename T>
+    CborWriter& Number(T number) {
+        static_assert(std::is_arithmetic_v<T>);
+        if constexpr (std::is_floating_point_v<T>) {
+            Float(static_cast<double>(number));
+        } else if constexpr (std::is_signed_v<T>) {
+            if (number < 0) {
+                // -1 - n in the unsigned domain, no overflow for the minimum
+                Head(NEGATIVE_INT, ~static_cast<std::uint64_t>(number));
+            } else {
+                Head(UNSIGNED_INT, static_cast<std::uint64_t>(number));
+            }
+        } else {
+            Head(UNSIGNED_INT, static_cast<std::uint64_t>(number));
+        }
+        return *this;
+    }
+
+    // Writes a whole DOM, for responses still built as boost::json values.
+    // Sizes are known here, so containers get definite lengths.
+    CborWriter& Value(const boost::json::value& value) {
+        if (value.is_null()) {
+            out_.push_back(static_cast<char>(NULL_VALUE));
+        } else if (value.is_bool()) {
+            out_.push_back(
+                static_cast<char>(value.as_bool() ? TRUE_VALUE : FALSE_VALUE));
+        } else if (value.is_int64()) {
+            Number(value.as_int64());
+        } else if (value.is_uint64()) {
+            Number(value.as_uint64());
+        } else if (value.is_double()) {
+            Number(value.as_double());
+        } else if (value.is_string()) {
+            const auto& str = value.as_string();
+            String({str.data(), str.size()});
+        } else if (value.is_array()) {
+            Head(ARRAY, value.as_array().size());
+            for (const auto& item : value.as_array()) {
+                Value(item);
+            }
+        } else {
+            Head(MAP, value.as_object().size());
+            for (const auto& entry : value.as_object()) {
+                String({entry.key().data(), entry.key().size()});
+                Value(entry.value());
+            }
+        }
+        return *this;
+    }
+
+   private:
+    // Major types, shifted into the top three bits of the initial byte
+    static constexpr std::uint8_t UNSIGNED_INT = 0 << 5;
+    static constexpr std::uint8_t NEGATIVE_INT = 1 << 5;
+    static constexpr std::uint8_t TEXT_STRING = 3 << 5;
+    static constexpr std::uint8_t ARRAY = 4 << 5;
+    static constexpr std::uint8_t MAP = 5 << 5;
+
+    static constexpr std::uint8_t INDEFINITE_ARRAY = ARRAY | 31;
+    static constexpr std::uint8_t INDEFINITE_MAP = MAP | 31;
+    static constexpr std::uint8_t FALSE_VALUE = 0xF4;
+    static constexpr std::uint8_t TRUE_VALUE = 0xF5;
+    static constexpr std::uint8_t NULL_VALUE = 0xF6;
+    static constexpr std::uint8_t FLOAT32 = 0xFA;
+    static constexpr std::uint8_t FLOAT64 = 0xFB;
+    static constexpr std::uint8_t BREAK = 0xFF;
+
+    void Head(std::uint8_t major, std::uint64_t argument) {
+        if (argument < 24) {
+            out_.push_back(static_cast<char>(major | argument));
+        } else if (argument <= UINT8_MAX) {
+            out_.push_back(static_cast<char>(major | 24));
+            BigEndian(argument, 1);
+        } else if (argument <= UINT16_MAX) {
+            out_.push_back(static_cast<char>(major | 25));
+            BigEndian(argument, 2);
+        } else if (argument <= UINT32_MAX) {
+            out_.push_back(static_cast<char>(major | 26));
+            BigEndian(argument, 4);
+        } else {
+            out_.push_back(static_cast<char>(major | 27));
+            BigEndian(argument, 8);
+        }
+    }
+
+    // Positions are mostly not exact in single precision, but scores,
+    // speeds and whole coordinates are and take half the bytes then
+    void Float(double number) {
+        // Doubles past the float range can't be converted at all
+        if (std::abs(number) <= std::numeric_limits<float>::max() &&
+            static_cast<double>(static_cast<float>(number)) == number) {
+            const auto narrow = static_cast<float>(number);
+            std::uint32_t bits;
+            std::memcpy(&bits, &narrow, sizeof(bits));
+            out_.push_back(static_cast<char>(FLOAT32));
+            BigEndian(bits, sizeof(bits));
+            return;
+        }
+        std::uint64_t bits;
+        std::memcpy(&bits, &number, sizeof(bits));
+        out_.push_back(static_cast<char>(FLOAT64));
+        BigEndian(bits, sizeof(bits));
+    }
+
+    void BigEndian(std::uint64_t value, int bytes) {
+        for (int i = bytes - 1; i >= 0; --i) {
+            out_.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+        }
+    }
+
+    std::string& out_;
+};
+
+}  // namespace utils
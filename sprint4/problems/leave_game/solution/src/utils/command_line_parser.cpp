@@ -12,7 +12,8 @@ std::optional<Args> ParseCommandLine(int argc, const char* argv[]) {
     po::options_description desc("All options");
 
     int delta_time, save_state_period;
-    std::string state_file;
+    std::string state_file, profile_output, config_cache, journal_file,
+        record_file, tick_catch_up;
     desc.add_options()("help,h", "produce help message")(
         "tick-period,t",
         po::value(&delta_time)->default_value(0)->value_name("milliseconds"s),
@@ -27,7 +28,33 @@ std::optional<Args> ParseCommandLine(int argc, const char* argv[]) {
         "spawn dogs at random positions")("state-file", po::value(&state_file),
                                           "set path to app save state")(
         "save-state-period", po::value(&save_state_period),
-        "set time period between app state saves");
+        "set time period between app state saves")(
+        "profile-output", po::value(&profile_output)->value_name("prefix"s),
+        "toggle profiling on SIGUSR1 and write <prefix>.trace.json and "
+        "<prefix>.folded when it stops")(
+        "config-cache", po::value(&config_cache)->value_name("file"s),
+        "keep the parsed config in file and reuse it while the config is "
+        "unchanged")(
+        "journal-file", po::value(&journal_file)->value_name("file"s),
+        "log applied actions to file and replay them on startup to recover "
+        "the state saved after the last snapshot")(
+        "record", po::value(&record_file)->value_name("file"s),
+        "record API requests and ticks with pseudonymised tokens to file for "
+        "game_replay")(
+        "tick-catch-up",
+        po::value(&tick_catch_up)->default_value("merge"s)->value_name(
+            "policy"s),
+        "what to do with periods missed by an overrunning tick: merge them "
+        "into one longer tick, skip them or substep through them")(
+        "tick-thread", po::bool_switch(&args.is_dedicated_tick_thread),
+        "run ticks and game actions on a dedicated high-priority thread, "
+        "apart from HTTP I/O")(
+        "io-per-core", po::bool_switch(&args.is_io_context_per_core),
+        "give every core an io_context, a pinned thread and an SO_REUSEPORT "
+        "acceptor of its own; implies --tick-thread")(
+        "admin-api", po::bool_switch(&args.is_admin_api),
+        "serve /api/v1/admin/ endpoints, such as the memory report, to "
+        "requests bearing the GAME_ADMIN_TOKEN environment variable");
     po::variables_map vm;
     po::store(po::parse_command_line(argc, argv, desc), vm);
     po::notify(vm);
@@ -49,10 +76,43 @@ std::optional<Args> ParseCommandLine(int argc, const char* argv[]) {
         args.state_file = state_file;
     }
 
+    if (tick_catch_up == "merge"s) {
+        args.tick_catch_up = CatchUpPolicy::Merge;
+    } else if (tick_catch_up == "skip"s) {
+        args.tick_catch_up = CatchUpPolicy::Skip;
+    } else if (tick_catch_up == "substep"s) {
+        args.tick_catch_up = CatchUpPolicy::SubStep;
+    } else {
+        throw std::invalid_argument("Unknown tick catch-up policy "s +
+                                    tick_catch_up);
+    }
+
+    // No core io_context may own the simulation, ticks would share a core
+    // with its connections
+    if (args.is_io_context_per_core) {
+        args.is_dedicated_tick_thread = true;
+    }
+
     if (save_state_period > 0) {
         args.save_state_period = std::chrono::milliseconds(save_state_period);
     }
 
+    if (!profile_output.empty()) {
+        args.profile_output = profile_output;
+    }
+
+    if (!config_cache.empty()) {
+        args.config_cache = config_cache;
+    }
+
+    if (!journal_file.empty()) {
+        args.journal_file = journal_file;
+    }
+
+    if (!record_file.empty()) {
+        args.record_file = record_file;
+    }
+
     if (!vm.count("www-root")) {
         throw std::invalid_argument("Static files root is not set"s);
     }
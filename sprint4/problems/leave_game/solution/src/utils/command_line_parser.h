@@ -7,6 +7,7 @@
 #include <boost/program_options.hpp>
 
 #include "utils/logger.h"
+#include "utils/ticker.h"
 
 namespace utils {
 
@@ -17,6 +18,14 @@ struct Args {
     bool is_random_spawnpoint;
     std::optional<std::string> state_file = std::nullopt;
     std::optional<std::chrono::milliseconds> save_state_period = std::nullopt;
+    std::optional<std::string> profile_output = std::nullopt;
+    std::optional<std::string> config_cache = std::nullopt;
+    std::optional<std::string> journal_file = std::nullopt;
+    std::optional<std::string> record_file = std::nullopt;
+    CatchUpPolicy tick_catch_up = CatchUpPolicy::Merge;
+    bool is_dedicated_tick_thread = false;
+    bool is_io_context_per_core = false;
+    bool is_admin_api = false;
 };
 
 [[nodiscard]] std::optional<Args> ParseCommandLine(int argc,
@@ -0,0 +1,199 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "utils/memory_usage.h"
+
+namespace utils {
+
+namespace detail {
+
+struct StringHash {
+    using is_transparent = void;
+    size_t operator()(std::string_view key) const noexcept {
+        return std::hash<std::string_view>{}(key);
+    }
+};
+
+}  // namespace detail
+
+// Hands out dense integer handles for strings in first-seen order. The
+// table only grows, so a handle stays valid for the life of the process
+// and can index flat vectors. Strings are looked up only where they come
+// in, hot paths carry the handle.
+class Interner {
+   public:
+    using Handle = std::uint32_t;
+
+    Interner() = default;
+    Interner(const Interner&) = delete;
+    Interner& operator=(const Interner&) = delete;
+
+    Handle Intern(std::string_view key) {
+        std::lock_guard lock{mutex_};
+        if (auto it = handles_.find(key); it != handles_.end()) {
+            return it->second;
+        }
+        const Handle handle = size_.load(std::memory_order_relaxed);
+        auto [it, _] = handles_.emplace(std::string(key), handle);
+        keys_.push_back(&it->first);
+        size_.store(handle + 1, std::memory_order_release);
+        return handle;
+    }
+
+    // Does not add key, unknown strings from clients leave no trace
+    std::optional<Handle> Find(std::string_view key) const {
+        std::lock_guard lock{mutex_};
+        if (auto it = handles_.find(key); it != handles_.end()) {
+            return it->second;
+        }
+        return std::nullopt;
+    }
+
+    // handle must have been handed out by this table. The view stays valid
+    // for the life of the table.
+    std::string_view GetKey(Handle handle) const {
+        std::lock_guard lock{mutex_};
+        return *keys_[handle];
+    }
+
+    // Every handle handed out so far is below this
+    Handle GetSize() const noexcept {
+        return size_.load(std::memory_order_acquire);
+    }
+
+    size_t GetMemoryBytes() const {
+        std::lock_guard lock{mutex_};
+        size_t bytes = sizeof(*this) + memory::HeapBytes(handles_) +
+                       memory::HeapBytes(keys_);
+        for (const auto& [key, _] : handles_) {
+            bytes += memory::HeapBytes(key);
+        }
+        return bytes;
+    }
+
+   private:
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, Handle, detail::StringHash,
+                       std::equal_to<>>
+        handles_;
+    // Keys by handle, nodes of handles_ never move
+    std::vector<const std::string*> keys_;
+    std::atomic<Handle> size_{0};
+};
+
+// Shares strings that come and go, such as names chosen by clients. A
+// string stays in the table while a Ref to it is alive and is dropped with
+// the last one, so the table holds only the strings in use. Reading or
+// copying a Ref takes no lock, only interning and dropping a last Ref do.
+// The table must outlive its Refs.
+class RefCountedInterner {
+    struct Entry;
+
+   public:
+    class Ref {
+       public:
+        Ref() = default;
+
+        Ref(const Ref& other) noexcept : entry_(other.entry_) {
+            if (entry_) {
+                entry_->refs.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+
+        Ref(Ref&& other) noexcept : entry_(std::exchange(other.entry_, {})) {}
+
+        Ref& operator=(Ref other) noexcept {
+            std::swap(entry_, other.entry_);
+            return *this;
+        }
+
+        ~Ref() {
+            if (entry_) {
+                entry_->table->Release(*entry_);
+            }
+        }
+
+        std::string_view GetKey() const noexcept {
+            return entry_ ? entry_->key : std::string_view{};
+        }
+
+       private:
+        friend class RefCountedInterner;
+
+        explicit Ref(Entry* entry) noexcept : entry_(entry) {}
+
+        Entry* entry_ = nullptr;
+    };
+
+    RefCountedInterner() = default;
+    RefCountedInterner(const RefCountedInterner&) = delete;
+    RefCountedInterner& operator=(const RefCountedInterner&) = delete;
+
+    Ref Intern(std::string_view key) {
+        std::lock_guard lock{mutex_};
+        auto it = entries_.find(key);
+        if (it == entries_.end()) {
+            it = entries_.try_emplace(std::string(key)).first;
+            it->second.key = it->first;
+            it->second.table = this;
+        }
+        it->second.refs.fetch_add(1, std::memory_order_relaxed);
+        return Ref{&it->second};
+    }
+
+    // Strings with at least one Ref
+    size_t GetSize() const {
+        std::lock_guard lock{mutex_};
+        return entries_.size();
+    }
+
+    size_t GetMemoryBytes() const {
+        std::lock_guard lock{mutex_};
+        size_t bytes = sizeof(*this) + memory::HeapBytes(entries_);
+        for (const auto& [key, _] : entries_) {
+            bytes += memory::HeapBytes(key);
+        }
+        return bytes;
+    }
+
+   private:
+    struct Entry {
+        std::atomic<std::uint32_t> refs{0};
+        // Views the key of the node holding the entry
+        std::string_view key;
+        RefCountedInterner* table = nullptr;
+    };
+
+    // Only the last Ref takes the lock and it counts down under it, so an
+    // entry found by Intern is never one that is being erased
+    void Release(Entry& entry) noexcept {
+        auto refs = entry.refs.load(std::memory_order_relaxed);
+        while (refs > 1) {
+            if (entry.refs.compare_exchange_weak(refs, refs - 1,
+                                                 std::memory_order_acq_rel,
+                                                 std::memory_order_relaxed)) {
+                return;
+            }
+        }
+        std::lock_guard lock{mutex_};
+        if (entry.refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            entries_.erase(entries_.find(entry.key));
+        }
+    }
+
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, Entry, detail::StringHash, std::equal_to<>>
+        entries_;
+};
+
+}  // namespace utils
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <boost/json/serializer.hpp>
+#include <boost/json/value.hpp>
+
+namespace utils {
+
+// Appends JSON straight to a string without building a boost::json DOM.
+// Keys, strings and numbers go through boost::json::serializer, so the
+// output is byte-identical to boost::json::serialize of the same document.
+// The caller is responsible for well-formed nesting.
+class JsonWriter {
+   public:
+    explicit JsonWriter(std::string& out) : out_(out) {}
+
+    JsonWriter(const JsonWriter&) = delete;
+    JsonWriter& operator=(const JsonWriter&) = delete;
+
+    JsonWriter& BeginObject() {
+        Open('{');
+        return *this;
+    }
+
+    JsonWriter& EndObject() {
+        Close('}');
+        return *this;
+    }
+
+    JsonWriter& BeginArray() {
+        Open('[');
+        return *this;
+    }
+
+    JsonWriter& EndArray() {
+        Close(']');
+        return *this;
+    }
+
+    JsonWriter& Key(std::string_view key) {
+        Separate();
+        WriteString(key);
+        out_.push_back(':');
+        after_key_ = true;
+        return *this;
+    }
+
+    JsonWriter& String(std::string_view str) {
+        Separate();
+        WriteString(str);
+        return *this;
+    }
+
+    // Integers and doubles, formatted as boost::json::value formats them
+    template <typename T>
+    JsonWriter& Number(T number) {
+        Separate();
+        boost::json::value value(number);
+        serializer_.reset(&value);
+        Flush();
+        return *this;
+    }
+
+    // Writes a whole DOM, for responses still built as boost::json values
+    JsonWriter& Value(const boost::json::value& value) {
+        Separate();
+        serializer_.reset(&value);
+        Flush();
+        return *this;
+    }
+
+   private:
+    void Open(char bracket) {
+        Separate();
+        out_.push_back(bracket);
+        needs_comma_.push_back(false);
+    }
+
+    void Close(char bracket) {
+        needs_comma_.pop_back();
+        out_.push_back(bracket);
+    }
+
+    void Separate() {
+        if (after_key_) {
+            after_key_ = false;
+            return;
+        }
+        if (!needs_comma_.empty()) {
+            if (needs_comma_.back()) {
+                out_.push_back(',');
+            }
+            needs_comma_.back() = true;
+        }
+    }
+
+    void WriteString(std::string_view str) {
+        serializer_.reset(boost::json::string_view(str.data(), str.size()));
+        Flush();
+    }
+
+    void Flush() {
+        while (!serializer_.done()) {
+            auto chunk = serializer_.read(buffer_.data(), buffer_.size());
+            out_.append(chunk.data(), chunk.size());
+        }
+    }
+
+    std::string& out_;
+    boost::json::serializer serializer_;
+    std::array<char, 256> buffer_;
+    std::vector<bool> needs_comma_;
+    bool after_key_ = false;
+};
+
+}  // namespace utils
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+namespace utils {
+
+// Log-linear histogram of durations in the spirit of HdrHistogram: values
+// are stored in microseconds with a relative error below 1% and constant
+// memory regardless of the number of recorded samples.
+class LatencyHistogram {
+   public:
+    using Duration = std::chrono::microseconds;
+
+    LatencyHistogram() : counts_(BUCKETS_COUNT, 0) {}
+
+    void Record(std::chrono::nanoseconds duration, std::uint64_t count = 1) {
+        auto value = static_cast<std::uint64_t>(std::max<std::int64_t>(
+            std::chrono::duration_cast<Duration>(duration).count(), 0));
+        counts_[BucketIndex(value)] += count;
+        total_count_ += count;
+        max_ = std::max(max_, value);
+        min_ = std::min(min_, value);
+        sum_ += value * count;
+    }
+
+    void Merge(const LatencyHistogram& other) {
+        for (size_t i = 0; i < counts_.size(); ++i) {
+            counts_[i] += other.counts_[i];
+        }
+        total_count_ += other.total_count_;
+        max_ = std::max(max_, other.max_);
+        min_ = std::min(min_, other.min_);
+        sum_ += other.sum_;
+    }
+
+    void Reset() {
+        std::fill(counts_.begin(), counts_.end(), 0);
+        total_count_ = 0;
+        max_ = 0;
+        min_ = UINT64_MAX;
+        sum_ = 0;
+    }
+
+    std::uint64_t Count() const noexcept { return total_count_; }
+
+    Duration Max() const noexcept { return Duration(max_); }
+
+    Duration Min() const noexcept {
+        return Duration(total_count_ == 0 ? 0 : min_);
+    }
+
+    Duration Mean() const noexcept {
+        return Duration(total_count_ == 0 ? 0 : sum_ / total_count_);
+    }
+
+    // percentile is in [0, 100]
+    Duration ValueAtPercentile(double percentile) const {
+        if (total_count_ == 0) {
+            return Duration(0);
+        }
+        auto target = static_cast<std::uint64_t>(
+            std::clamp(percentile, 0.0, 100.0) / 100.0 * total_count_ + 0.5);
+        target = std::clamp<std::uint64_t>(target, 1, total_count_);
+
+        std::uint64_t seen = 0;
+        for (size_t i = 0; i < counts_.size(); ++i) {
+            seen += counts_[i];
+            if (seen >= target) {
+                return Duration(std::min(BucketUpperBound(i), max_));
+            }
+        }
+        return Duration(max_);
+    }
+
+   private:
+    static constexpr unsigned SUB_BUCKET_BITS = 8;
+    static constexpr std::uint64_t SUB_BUCKET_COUNT = 1u << SUB_BUCKET_BITS;
+    static constexpr std::uint64_t HALF_SUB_BUCKET_COUNT = SUB_BUCKET_COUNT / 2;
+    static constexpr size_t BUCKETS_COUNT =
+        SUB_BUCKET_COUNT + (64 - SUB_BUCKET_BITS) * HALF_SUB_BUCKET_COUNT;
+
+    std::vector<std::uint64_t> counts_;
+    std::uint64_t total_count_ = 0;
+    std::uint64_t max_ = 0;
+    std::uint64_t min_ = UINT64_MAX;
+    std::uint64_t sum_ = 0;
+
+    static size_t BucketIndex(std::uint64_t value) {
+        if (value < SUB_BUCKET_COUNT) {
+            return value;
+        }
+        const unsigned shift = std::bit_width(value) - SUB_BUCKET_BITS;
+        const std::uint64_t sub_bucket = value >> shift;
+        return SUB_BUCKET_COUNT + (shift - 1) * HALF_SUB_BUCKET_COUNT +
+               (sub_bucket - HALF_SUB_BUCKET_COUNT);
+    }
+
+    static std::uint64_t BucketUpperBound(size_t index) {
+        if (index < SUB_BUCKET_COUNT) {
+            return index;
+        }
+        const std::uint64_t offset = index - SUB_BUCKET_COUNT;
+        const unsigned shift = offset / HALF_SUB_BUCKET_COUNT + 1;
+        const std::uint64_t sub_bucket =
+            offset % HALF_SUB_BUCKET_COUNT + HALF_SUB_BUCKET_COUNT;
+        return ((sub_bucket + 1) << shift) - 1;
+    }
+};
+
+}  // namespace utils
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstddef>
+#include <deque>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace utils {
+
+// Entities of one kind and the bytes they hold, their own size included
+struct MemoryUsage {
+    size_t count = 0;
+    size_t bytes = 0;
+
+    MemoryUsage& operator+=(const MemoryUsage& other) noexcept {
+        count += other.count;
+        bytes += other.bytes;
+        return *this;
+    }
+};
+
+}  // namespace utils
+
+// Estimates of the heap bytes held by standard containers, for the memory
+// report. Buffers are counted by capacity. Node based containers count a
+// node per element and their bucket array, allocator headers are left out.
+namespace utils::memory {
+
+inline size_t HeapBytes(const std::string& str) {
+    return str.capacity() > std::string{}.capacity() ? str.capacity() + 1
+                                                     : 0;
+}
+
+template <typename T, typename Allocator>
+size_t HeapBytes(const std::vector<T, Allocator>& vector) {
+    return vector.capacity() * sizeof(T);
+}
+
+// Blocks are 512 bytes in libstdc++, a partly used one counts in full
+template <typename T, typename Allocator>
+size_t HeapBytes(const std::deque<T, Allocator>& deque) {
+    constexpr size_t BLOCK = sizeof(T) < 512 ? 512 / sizeof(T) : 1;
+    return (deque.size() / BLOCK + 1) * BLOCK * sizeof(T);
+}
+
+template <typename T, typename Allocator>
+size_t HeapBytes(const std::list<T, Allocator>& list) {
+    return list.size() * (sizeof(T) + 2 * sizeof(void*));
+}
+
+// A node keeps the next pointer and the cached hash beside the value
+template <typename Key, typename Value, typename... Rest>
+size_t HeapBytes(const std::unordered_map<Key, Value, Rest...>& map) {
+    using Node = typename std::unordered_map<Key, Value, Rest...>::value_type;
+    return map.bucket_count() * sizeof(void*) +
+           map.size() * (sizeof(Node) + sizeof(void*) + sizeof(size_t));
+}
+
+}  // namespace utils::memory
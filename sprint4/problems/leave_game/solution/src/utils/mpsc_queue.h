@@ -0,0 +1,62 @@
+#pragma once
+
+#include <atomic>
+#include <optional>
+#include <utility>
+
+namespace utils {
+
+// Unbounded multi-producer single-consumer queue (D. Vyukov's node-based
+// design). Producers never wait for each other or for the consumer, Push is
+// one exchange and one store, but it allocates a node from the global
+// allocator first, so it is only lock-free as far as that allocator is.
+// Pop must only be called from one thread at a time. A Pop racing with a
+// Push may miss the element being pushed, callers that need to see it must
+// synchronise through something else after Push returns.
+template <typename T>
+class MpscQueue {
+   public:
+    MpscQueue() : head_(new Node), tail_(head_.load()) {}
+
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+
+    ~MpscQueue() {
+        while (Pop()) {
+        }
+        delete tail_;
+    }
+
+    void Push(T value) {
+        auto* node = new Node;
+        node->value.emplace(std::move(value));
+        Node* prev = head_.exchange(node, std::memory_order_acq_rel);
+        prev->next.store(node, std::memory_order_release);
+    }
+
+    std::optional<T> Pop() {
+        Node* tail = tail_;
+        Node* next = tail->next.load(std::memory_order_acquire);
+        if (!next) {
+            return std::nullopt;
+        }
+        std::optional<T> value = std::move(next->value);
+        next->value.reset();
+        tail_ = next;
+        delete tail;
+        return value;
+    }
+
+   private:
+    struct Node {
+        std::atomic<Node*> next{nullptr};
+        std::optional<T> value;
+    };
+
+    // Producers append after head_, the consumer owns tail_, which is
+    // always an already consumed node
+    std::atomic<Node*> head_;
+    Node* tail_;
+};
+
+}  // namespace utils
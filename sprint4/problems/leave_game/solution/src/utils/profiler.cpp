@@ -0,0 +1,188 @@
+#include "profiler.h"
+
+#include <algorithm>
+#include <fstream>
+#include <map>
+#include <string>
+
+namespace utils::profiler {
+
+namespace {
+
+thread_local std::uint32_t current_depth = 0;
+
+long long ToMicroseconds(Clock::duration duration) {
+    return std::chrono::duration_cast<std::chrono::microseconds>(duration)
+        .count();
+}
+
+void WriteEscaped(std::ostream& out, std::string_view str) {
+    for (char c : str) {
+        if (c == '"' || c == '\\') {
+            out << '\\';
+        }
+        out << c;
+    }
+}
+
+}  // namespace
+
+Profiler& Profiler::Instance() {
+    static Profiler profiler;
+    return profiler;
+}
+
+void Profiler::Start() {
+    Collect();
+    dropped_.store(0, std::memory_order_relaxed);
+    running_.store(true, std::memory_order_relaxed);
+}
+
+void Profiler::Stop() { running_.store(false, std::memory_order_relaxed); }
+
+std::vector<ThreadEvents> Profiler::Collect() {
+    std::vector<ThreadEvents> result;
+    std::lock_guard buffers_lock{buffers_mutex_};
+    for (const auto& buffer : buffers_) {
+        ThreadEvents thread_events{.thread_id = buffer->thread_id,
+                                   .events = {}};
+        {
+            std::lock_guard lock{buffer->mutex};
+            thread_events.events.swap(buffer->events);
+        }
+        if (!thread_events.events.empty()) {
+            result.push_back(std::move(thread_events));
+        }
+    }
+    return result;
+}
+
+void Profiler::Record(const Event& event) {
+    auto& buffer = GetThreadBuffer();
+    std::lock_guard lock{buffer.mutex};
+    if (buffer.events.size() >= MAX_EVENTS_PER_THREAD) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    buffer.events.push_back(event);
+}
+
+void Profiler::Dump(const std::filesystem::path& prefix) {
+    auto threads = Collect();
+
+    auto trace_file = prefix;
+    trace_file += ".trace.json";
+    std::ofstream trace_out(trace_file);
+    WriteChromeTrace(threads, trace_out);
+
+    auto folded_file = prefix;
+    folded_file += ".folded";
+    std::ofstream folded_out(folded_file);
+    WriteCollapsedStacks(threads, folded_out);
+}
+
+Profiler::ThreadBuffer& Profiler::GetThreadBuffer() {
+    thread_local std::shared_ptr<ThreadBuffer> buffer = [this] {
+        auto new_buffer = std::make_shared<ThreadBuffer>();
+        std::lock_guard lock{buffers_mutex_};
+        new_buffer->thread_id = static_cast<std::uint32_t>(buffers_.size());
+        buffers_.push_back(new_buffer);
+        return new_buffer;
+    }();
+    return *buffer;
+}
+
+void WriteChromeTrace(const std::vector<ThreadEvents>& threads,
+                      std::ostream& out) {
+    Clock::time_point origin = Clock::time_point::max();
+    for (const auto& thread : threads) {
+        for (const auto& event : thread.events) {
+            origin = std::min(origin, event.start);
+        }
+    }
+
+    out << R"({"displayTimeUnit":"ms","traceEvents":[)";
+    bool first = true;
+    for (const auto& thread : threads) {
+        for (const auto& event : thread.events) {
+            if (!first) {
+                out << ',';
+            }
+            first = false;
+            out << R"({"name":")";
+            WriteEscaped(out, event.name);
+            out << R"(","ph":"X","pid":1,"tid":)" << thread.thread_id
+                << R"(,"ts":)" << ToMicroseconds(event.start - origin)
+                << R"(,"dur":)" << ToMicroseconds(event.duration) << '}';
+        }
+    }
+    out << "]}\n";
+}
+
+void WriteCollapsedStacks(const std::vector<ThreadEvents>& threads,
+                          std::ostream& out) {
+    std::map<std::string, long long> self_time;
+
+    for (const auto& thread : threads) {
+        // Events are recorded when a scope ends, so children come before
+        // their parents. Sorting by start restores the call order.
+        auto events = thread.events;
+        std::sort(events.begin(), events.end(),
+                  [](const Event& lhs, const Event& rhs) {
+                      if (lhs.start != rhs.start) {
+                          return lhs.start < rhs.start;
+                      }
+                      return lhs.depth < rhs.depth;
+                  });
+
+        struct Frame {
+            std::uint32_t depth;
+            std::string path;
+        };
+        std::vector<Frame> stack;
+        for (const auto& event : events) {
+            while (!stack.empty() && stack.back().depth >= event.depth) {
+                stack.pop_back();
+            }
+
+            std::string path;
+            if (!stack.empty()) {
+                path = stack.back().path + ';';
+                self_time[stack.back().path] -=
+                    ToMicroseconds(event.duration);
+            }
+            path.append(event.name);
+            self_time[path] += ToMicroseconds(event.duration);
+            stack.push_back({event.depth, std::move(path)});
+        }
+    }
+
+    for (const auto& [path, time] : self_time) {
+        out << path << ' ' << std::max(time, 0LL) << '\n';
+    }
+}
+
+ScopedTimer::ScopedTimer(std::string_view name) noexcept
+    : name_(name), active_(Profiler::Instance().IsRunning()) {
+    if (active_) {
+        ++current_depth;
+        start_ = Clock::now();
+    }
+}
+
+ScopedTimer::~ScopedTimer() {
+    if (!active_) {
+        return;
+    }
+    auto finish = Clock::now();
+    --current_depth;
+    try {
+        Profiler::Instance().Record({.name = name_,
+                                     .start = start_,
+                                     .duration = finish - start_,
+                                     .depth = current_depth});
+    } catch (...) {
+    }
+}
+
+}  // namespace utils::profiler
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string_view>
+#include <vector>
+
+namespace utils::profiler {
+
+using Clock = std::chrono::steady_clock;
+
+// Names must point to storage that outlives the capture, string literals and
+// route keys are used throughout the server.
+struct Event {
+    std::string_view name;
+    Clock::time_point start;
+    Clock::duration duration;
+    std::uint32_t depth;
+};
+
+struct ThreadEvents {
+    std::uint32_t thread_id = 0;
+    std::vector<Event> events = {};
+};
+
+// In-process scoped-timer profiler. Timers are always compiled in when
+// GAME_SERVER_PROFILING is defined, but events are recorded only between
+// Start() and Stop(), so an idle profiler costs one atomic load per scope.
+class Profiler {
+   public:
+    static constexpr size_t MAX_EVENTS_PER_THREAD = 1 << 20;
+
+    static Profiler& Instance();
+
+    void Start();
+    void Stop();
+
+    bool IsRunning() const noexcept {
+        return running_.load(std::memory_order_relaxed);
+    }
+
+    // Takes all recorded events out of the thread buffers
+    std::vector<ThreadEvents> Collect();
+
+    size_t GetDroppedCount() const noexcept {
+        return dropped_.load(std::memory_order_relaxed);
+    }
+
+    void Record(const Event& event);
+
+    // Writes <prefix>.trace.json and <prefix>.folded
+    void Dump(const std::filesystem::path& prefix);
+
+   private:
+    struct ThreadBuffer {
+        std::uint32_t thread_id;
+        std::mutex mutex;
+        std::vector<Event> events;
+    };
+
+    Profiler() = default;
+
+    ThreadBuffer& GetThreadBuffer();
+
+    std::atomic<bool> running_{false};
+    std::atomic<size_t> dropped_{0};
+    std::mutex buffers_mutex_;
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers_;
+};
+
+// Chrome trace-event format, loadable in chrome://tracing and Perfetto
+void WriteChromeTrace(const std::vector<ThreadEvents>& threads,
+                      std::ostream& out);
+
+// Collapsed stacks with self time in microseconds, the input format of
+// flamegraph.pl and speedscope
+void WriteCollapsedStacks(const std::vector<ThreadEvents>& threads,
+                          std::ostream& out);
+
+class ScopedTimer {
+   public:
+    explicit ScopedTimer(std::string_view name) noexcept;
+    ~ScopedTimer();
+
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+   private:
+    std::string_view name_;
+    Clock::time_point start_;
+    bool active_;
+};
+
+}  // namespace utils::profiler
+
+#define PROFILE_CONCAT_IMPL(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_IMPL(a, b)
+
+#ifdef GAME_SERVER_PROFILING
+#define PROFILE_SCOPE(name)        \
+    ::utils::profiler::ScopedTimer \
+        PROFILE_CONCAT(profile_scope_, __LINE__)(name)
+#else
+#define PROFILE_SCOPE(name) static_cast<void>(0)
+#endif
@@ -0,0 +1,179 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string_view>
+
+namespace utils {
+
+struct TokenBucketLimit {
+    // Tokens added per second
+    double rate = 0.0;
+    // Bucket size, the longest burst let through after a quiet period
+    double burst = 0.0;
+};
+
+struct RateLimitConfig {
+    std::optional<TokenBucketLimit> per_token;
+    std::optional<TokenBucketLimit> per_ip;
+    // API requests waiting for the strand above which new ones are shed
+    std::optional<std::size_t> max_api_queue;
+};
+
+// Token buckets keyed by strings, in a fixed-size open addressing table.
+// A bucket is one 64-bit word with the token count and the time of its
+// last change, refilled lazily when a request takes from it, so every
+// operation is a handful of atomic loads and one CAS.
+//
+// Keys are never removed. A key whose bucket has refilled completely
+// carries no information, so a new key may take its slot over. When no
+// slot is free or full in the probe window, the request is let through
+// and counted as untracked.
+class RateLimiter {
+   public:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr size_t SHARDS = 16;
+    static constexpr size_t SLOTS_PER_SHARD = 4096;
+    static constexpr size_t PROBES = 8;
+    // Tokens are kept with 8 fractional bits in 24 bits
+    static constexpr double MAX_BURST = 65535.0;
+
+    explicit RateLimiter(TokenBucketLimit limit,
+                         Clock::time_point epoch = Clock::now())
+        : epoch_(epoch),
+          rate_(static_cast<std::uint64_t>(std::llround(limit.rate * ONE))),
+          burst_(static_cast<std::uint64_t>(
+              std::llround(std::min(limit.burst, MAX_BURST) * ONE))),
+          refill_ms_(static_cast<std::uint64_t>(
+              std::ceil(limit.burst / limit.rate * 1000.0)) + 1) {
+        for (auto& shard : shards_) {
+            shard = std::make_unique<Slot[]>(SLOTS_PER_SHARD);
+            for (size_t i = 0; i < SLOTS_PER_SHARD; ++i) {
+                shard[i].state.store(Pack(0, burst_),
+                                     std::memory_order_relaxed);
+            }
+        }
+    }
+
+    RateLimiter(const RateLimiter&) = delete;
+    RateLimiter& operator=(const RateLimiter&) = delete;
+
+    // Takes a token from the bucket of key, false when it is empty
+    bool TryAcquire(std::string_view key,
+                    Clock::time_point now = Clock::now()) {
+        const std::uint64_t hash = HashKey(key);
+        const std::uint64_t now_ms = ToMs(now);
+        Slot* slot = FindSlot(hash, now_ms);
+        if (!slot) {
+            untracked_.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+
+        std::uint64_t state = slot->state.load(std::memory_order_acquire);
+        while (true) {
+            const std::uint64_t tokens = Refill(state, now_ms);
+            if (tokens < ONE) {
+                return false;
+            }
+            const std::uint64_t time = std::max(now_ms, state >> TOKEN_BITS);
+            if (slot->state.compare_exchange_weak(
+                    state, Pack(time, tokens - ONE),
+                    std::memory_order_acq_rel, std::memory_order_acquire)) {
+                return true;
+            }
+        }
+    }
+
+    // Requests let through because their key found no slot
+    std::uint64_t GetUntrackedCount() const noexcept {
+        return untracked_.load(std::memory_order_relaxed);
+    }
+
+   private:
+    static constexpr int TOKEN_BITS = 24;
+    static constexpr std::uint64_t TOKEN_MASK = (1ull << TOKEN_BITS) - 1;
+    static constexpr std::uint64_t ONE = 256;
+    static constexpr std::uint64_t EMPTY = 0;
+
+    struct Slot {
+        std::atomic<std::uint64_t> key{EMPTY};
+        // Last change time in ms since epoch_ above TOKEN_BITS, tokens
+        // below
+        std::atomic<std::uint64_t> state{0};
+    };
+
+    static std::uint64_t Pack(std::uint64_t time_ms, std::uint64_t tokens) {
+        return (time_ms << TOKEN_BITS) | tokens;
+    }
+
+    static std::uint64_t HashKey(std::string_view key) {
+        const std::uint64_t hash = std::hash<std::string_view>{}(key);
+        return hash == EMPTY ? 1 : hash;
+    }
+
+    std::uint64_t ToMs(Clock::time_point now) const {
+        const auto elapsed =
+            std::chrono::duration_cast<std::chrono::milliseconds>(now - epoch_)
+                .count();
+        return elapsed > 0 ? static_cast<std::uint64_t>(elapsed) : 0;
+    }
+
+    std::uint64_t Refill(std::uint64_t state, std::uint64_t now_ms) const {
+        const std::uint64_t last_ms = state >> TOKEN_BITS;
+        const std::uint64_t tokens = state & TOKEN_MASK;
+        // Capped so the product can't overflow, the bucket is full by then
+        const std::uint64_t elapsed =
+            std::min(now_ms > last_ms ? now_ms - last_ms : 0, refill_ms_);
+        return std::min(burst_, tokens + elapsed * rate_ / 1000);
+    }
+
+    Slot* FindSlot(std::uint64_t hash, std::uint64_t now_ms) {
+        Slot* slots = shards_[hash % SHARDS].get();
+        Slot* full = nullptr;
+        std::uint64_t full_key = EMPTY;
+        for (size_t i = 0; i < PROBES; ++i) {
+            Slot& slot = slots[((hash / SHARDS) + i) % SLOTS_PER_SHARD];
+            std::uint64_t key = slot.key.load(std::memory_order_acquire);
+            if (key == EMPTY &&
+                slot.key.compare_exchange_strong(key, hash,
+                                                 std::memory_order_acq_rel)) {
+                return &slot;
+            }
+            if (key == hash) {
+                return &slot;
+            }
+            if (!full && Refill(slot.state.load(std::memory_order_acquire),
+                                now_ms) == burst_) {
+                full = &slot;
+                full_key = key;
+            }
+        }
+        // A full bucket is what the new key would start with anyway
+        if (full && (full->key.compare_exchange_strong(
+                         full_key, hash, std::memory_order_acq_rel) ||
+                     full_key == hash)) {
+            return full;
+        }
+        return nullptr;
+    }
+
+    Clock::time_point epoch_;
+    // Both in 1/ONE tokens
+    std::uint64_t rate_;
+    std::uint64_t burst_;
+    // Time an empty bucket takes to fill up
+    std::uint64_t refill_ms_;
+    std::array<std::unique_ptr<Slot[]>, SHARDS> shards_;
+    std::atomic<std::uint64_t> untracked_{0};
+};
+
+}  // namespace utils
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <utility>
+
+#include <boost/asio/post.hpp>
+
+#include "utils/mpsc_queue.h"
+
+namespace utils {
+
+// Hands tasks to a strand through a lock-free queue. The strand is only
+// posted to when the inbox turns non-empty, so a burst of tasks from many
+// threads costs one strand wake-up instead of one lock round-trip each.
+template <typename Strand>
+class StrandInbox : public std::enable_shared_from_this<StrandInbox<Strand>> {
+   public:
+    using Task = std::function<void()>;
+
+    // Tasks run per strand turn, so timers queued on the strand are not
+    // starved by a long burst
+    static constexpr size_t MAX_BATCH = 64;
+
+    explicit StrandInbox(Strand strand) : strand_(std::move(strand)) {}
+
+    void Push(Task task) {
+        size_.fetch_add(1, std::memory_order_relaxed);
+        queue_.Push(std::move(task));
+        if (!is_scheduled_.exchange(true, std::memory_order_acq_rel)) {
+            Schedule();
+        }
+    }
+
+    // Tasks waiting to run
+    size_t GetSize() const noexcept {
+        return size_.load(std::memory_order_relaxed);
+    }
+
+   private:
+    void Schedule() {
+        boost::asio::post(strand_,
+                          [self = this->shared_from_this()] { self->Drain(); });
+    }
+
+    void Drain() {
+        // Cleared before popping: a task pushed after the last Pop below
+        // schedules a new drain
+        is_scheduled_.exchange(false, std::memory_order_acq_rel);
+        for (size_t i = 0; i < MAX_BATCH; ++i) {
+            auto task = queue_.Pop();
+            if (!task) {
+                return;
+            }
+            size_.fetch_sub(1, std::memory_order_relaxed);
+            (*task)();
+        }
+        if (!is_scheduled_.exchange(true, std::memory_order_acq_rel)) {
+            Schedule();
+        }
+    }
+
+    Strand strand_;
+    MpscQueue<Task> queue_;
+    std::atomic<bool> is_scheduled_{false};
+    std::atomic<size_t> size_{0};
+};
+
+}  // namespace utils
@@ -1,64 +1,200 @@
 #pragma once
 
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
 #include <utility>
 
 #include <boost/asio/dispatch.hpp>
 #include <boost/asio/steady_timer.hpp>
 #include <boost/asio/strand.hpp>
+#include <boost/json/value.hpp>
+
+#include "utils/latency_histogram.h"
+#include "utils/logger.h"
 
 namespace utils {
 
 namespace net = boost::asio;
 namespace sys = boost::system;
 
+// What the ticker does with periods that passed while a tick overran
+enum class CatchUpPolicy {
+    // One tick with the whole missed time as delta
+    Merge,
+    // One tick of a single period, the missed time is dropped
+    Skip,
+    // One tick per missed period, up to Ticker::MAX_SUB_STEPS
+    SubStep
+};
+
+struct TickerStats {
+    std::uint64_t ticks = 0;
+    // Wake-ups whose handlers took longer than the period
+    std::uint64_t overruns = 0;
+    // Periods merged into a longer tick, skipped or sub-stepped
+    std::uint64_t late_periods = 0;
+    // Periods that were not simulated at all
+    std::uint64_t dropped_periods = 0;
+    std::uint64_t failures = 0;
+    LatencyHistogram handler_duration;
+    // How long after its deadline a wake-up happened
+    LatencyHistogram lateness;
+};
+
 class Ticker : public std::enable_shared_from_this<Ticker> {
    public:
     using Strand = net::strand<net::io_context::executor_type>;
     using Handler = std::function<void(std::chrono::milliseconds delta)>;
 
-    // Функция handler будет вызываться внутри strand с интервалом period
-    Ticker(Strand strand, std::chrono::milliseconds period, Handler handler)
-        : strand_{strand}, period_{period}, handler_{std::move(handler)} {}
+    static constexpr std::int64_t MAX_SUB_STEPS = 8;
+
+    // Функция handler будет вызываться внутри strand с интервалом period.
+    // Deadlines are absolute, so the handler time does not shift the grid.
+    Ticker(Strand strand, std::chrono::milliseconds period, Handler handler,
+           CatchUpPolicy policy = CatchUpPolicy::Merge)
+        : strand_{strand},
+          period_{period},
+          handler_{std::move(handler)},
+          policy_{policy} {}
 
     void Start() {
         net::dispatch(strand_, [self = shared_from_this()] {
-            self->last_tick_ = Clock::now();
+            self->next_deadline_ = Clock::now() + self->period_;
             self->ScheduleTick();
         });
     }
 
+    void Stop() {
+        net::dispatch(strand_, [self = shared_from_this()] {
+            self->is_stopped_ = true;
+            self->timer_.cancel();
+        });
+    }
+
+    TickerStats GetStats() const {
+        std::lock_guard lock{stats_mutex_};
+        return stats_;
+    }
+
    private:
+    using Clock = std::chrono::steady_clock;
+
     void ScheduleTick() {
         assert(strand_.running_in_this_thread());
-        timer_.expires_after(period_);
+        if (is_stopped_) {
+            return;
+        }
+        timer_.expires_at(next_deadline_);
         timer_.async_wait([self = shared_from_this()](sys::error_code ec) {
             self->OnTick(ec);
         });
     }
 
     void OnTick(sys::error_code ec) {
-        using namespace std::chrono;
         assert(strand_.running_in_this_thread());
+        if (ec || is_stopped_) {
+            return;
+        }
 
-        if (!ec) {
-            auto this_tick = Clock::now();
-            auto delta = duration_cast<milliseconds>(this_tick - last_tick_);
-            last_tick_ = this_tick;
-            try {
-                handler_(delta);
-            } catch (...) {
-            }
-            ScheduleTick();
+        const auto woke = Clock::now();
+        // Deadlines that have passed, the current one included
+        const std::int64_t due = 1 + (woke - next_deadline_) / period_;
+        const auto lateness = woke - next_deadline_;
+        next_deadline_ += period_ * due;
+
+        std::int64_t steps = 1;
+        auto delta = period_;
+        std::int64_t dropped = 0;
+        switch (policy_) {
+            case CatchUpPolicy::Merge:
+                delta = period_ * due;
+                break;
+            case CatchUpPolicy::Skip:
+                dropped = due - 1;
+                break;
+            case CatchUpPolicy::SubStep:
+                steps = std::min(due, MAX_SUB_STEPS);
+                dropped = due - steps;
+                break;
+        }
+
+        std::uint64_t failures = 0;
+        std::int64_t done = 0;
+        for (; done < steps && !is_stopped_; ++done) {
+            failures += RunHandler(delta) ? 0 : 1;
+        }
+        const auto duration = Clock::now() - woke;
+        const bool is_overrun = duration > period_;
+
+        {
+            std::lock_guard lock{stats_mutex_};
+            stats_.ticks += done;
+            stats_.overruns += is_overrun ? 1 : 0;
+            stats_.late_periods += due - 1;
+            stats_.dropped_periods += dropped;
+            stats_.failures += failures;
+            stats_.handler_duration.Record(duration);
+            stats_.lateness.Record(lateness);
+        }
+
+        if (is_overrun || due > 1) {
+            ReportOverrun(woke, due);
         }
+        ScheduleTick();
     }
 
-    using Clock = std::chrono::steady_clock;
+    // A failed tick is logged and the next one runs as usual
+    bool RunHandler(std::chrono::milliseconds delta) {
+        try {
+            handler_(delta);
+            return true;
+        } catch (const std::exception& ex) {
+            BOOST_LOG_TRIVIAL(error)
+                << boost::log::add_value(
+                       additional_data,
+                       boost::json::value{{"exception", ex.what()}})
+                << "tick failed";
+        } catch (...) {
+            BOOST_LOG_TRIVIAL(error) << "tick failed";
+        }
+        return false;
+    }
+
+    // At most one warning per second, with the overruns since the last one
+    void ReportOverrun(Clock::time_point now, std::int64_t due) {
+        ++unreported_overruns_;
+        if (now - last_report_ < std::chrono::seconds{1}) {
+            return;
+        }
+        BOOST_LOG_TRIVIAL(warning)
+            << boost::log::add_value(
+                   additional_data,
+                   boost::json::value{{"overruns", unreported_overruns_},
+                                      {"periodsDue", due}})
+            << "tick overrun";
+        unreported_overruns_ = 0;
+        last_report_ = now;
+    }
 
     Strand strand_;
     std::chrono::milliseconds period_;
     net::steady_timer timer_{strand_};
     Handler handler_;
-    std::chrono::steady_clock::time_point last_tick_;
+    CatchUpPolicy policy_;
+    Clock::time_point next_deadline_;
+    bool is_stopped_ = false;
+
+    Clock::time_point last_report_;
+    std::uint64_t unreported_overruns_ = 0;
+
+    mutable std::mutex stats_mutex_;
+    TickerStats stats_;
 };
 
 }  // namespace utils
@@ -0,0 +1,153 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace utils {
+
+// Hierarchical timer wheel over an integer clock. Level l has SLOTS slots
+// of SLOTS^l time units each. An entry sits on the lowest level whose span
+// still holds its deadline and moves one level down each time the clock
+// reaches its slot. Advance skips the slots of empty levels, so it costs
+// the slots it passes plus the entries it fires or moves, not the number
+// of entries waiting.
+//
+// Entries are never cancelled. A stale one fires and the caller decides
+// whether it still means anything.
+template <typename T>
+class TimerWheel {
+   public:
+    using Time = std::uint64_t;
+
+    static constexpr size_t SLOT_BITS = 6;
+    static constexpr size_t SLOTS = size_t{1} << SLOT_BITS;
+    static constexpr size_t LEVELS = 6;
+
+    explicit TimerWheel(Time now = 0) : now_(now) {}
+
+    // An entry due already fires on the next Advance
+    void Schedule(Time deadline, T value) {
+        ++size_;
+        Insert({deadline, std::move(value)});
+    }
+
+    // Moves the clock to now and calls on_expired(value) for every entry
+    // due by then. on_expired may schedule new entries.
+    template <typename Fn>
+    void Advance(Time now, Fn&& on_expired) {
+        FireDue(on_expired);
+        while (now_ < now) {
+            if (size_ == 0) {
+                now_ = now;
+                break;
+            }
+            // Nothing fires or cascades before the next slot of the lowest
+            // level holding entries, the clock goes straight to it
+            size_t lowest = 0;
+            while (lowest + 1 < LEVELS && counts_[lowest] == 0) {
+                ++lowest;
+            }
+            if (lowest > 0) {
+                now_ = std::min(now_ | ((Time{1} << (SLOT_BITS * lowest)) - 1),
+                                now);
+                if (now_ == now) {
+                    break;
+                }
+            }
+            ++now_;
+            Cascade();
+            auto& slot = levels_[0][now_ & MASK];
+            counts_[0] -= slot.size();
+            Fire(slot, on_expired);
+            // Cascaded entries due right now land there
+            FireDue(on_expired);
+        }
+    }
+
+    Time GetTime() const noexcept { return now_; }
+    size_t GetSize() const noexcept { return size_; }
+
+   private:
+    static constexpr Time MASK = SLOTS - 1;
+    static constexpr Time MAX_DELTA = (Time{1} << (SLOT_BITS * LEVELS)) - 1;
+
+    struct Entry {
+        Time deadline;
+        T value;
+    };
+    using Slot = std::vector<Entry>;
+
+    void Insert(Entry entry) {
+        if (entry.deadline <= now_) {
+            due_.push_back(std::move(entry));
+            return;
+        }
+        // The wheel covers SLOTS^LEVELS units ahead, later entries are put
+        // back when they reach the end of it
+        const Time delta = std::min(entry.deadline - now_, MAX_DELTA);
+        const Time place = now_ + delta;
+        size_t level = 0;
+        while (delta >> (SLOT_BITS * (level + 1))) {
+            ++level;
+        }
+        levels_[level][(place >> (SLOT_BITS * level)) & MASK].push_back(
+            std::move(entry));
+        ++counts_[level];
+    }
+
+    // When the clock enters a new slot of an upper level, its entries are
+    // spread over the levels below. Upper levels go first so that what
+    // they hand down is cascaded again if it lands in a slot just reached.
+    void Cascade() {
+        size_t top = 0;
+        while (top + 1 < LEVELS &&
+               (now_ & ((Time{1} << (SLOT_BITS * (top + 1))) - 1)) == 0) {
+            ++top;
+        }
+        for (size_t level = top; level > 0; --level) {
+            Slot entries = std::exchange(
+                levels_[level][(now_ >> (SLOT_BITS * level)) & MASK], {});
+            counts_[level] -= entries.size();
+            for (auto& entry : entries) {
+                Insert(std::move(entry));
+            }
+        }
+    }
+
+    template <typename Fn>
+    void FireDue(Fn& on_expired) {
+        while (!due_.empty()) {
+            Fire(due_, on_expired);
+        }
+    }
+
+    template <typename Fn>
+    void Fire(Slot& slot, Fn& on_expired) {
+        if (slot.empty()) {
+            return;
+        }
+        // on_expired may schedule into this very slot
+        Slot entries = std::exchange(slot, {});
+        for (auto& entry : entries) {
+            if (entry.deadline > now_) {
+                Insert(std::move(entry));
+                continue;
+            }
+            --size_;
+            on_expired(std::move(entry.value));
+        }
+    }
+
+    Time now_;
+    size_t size_ = 0;
+    std::array<std::array<Slot, SLOTS>, LEVELS> levels_;
+    std::array<size_t, LEVELS> counts_{};
+    // Scheduled at or before now_
+    Slot due_;
+};
+
+}  // namespace utils
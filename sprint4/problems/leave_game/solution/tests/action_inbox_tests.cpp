@@ -0,0 +1,104 @@
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "app/application.h"
+
+using namespace std::literals;
+
+namespace {
+
+app::Application::Pointer MakeApplication() {
+    auto map = std::make_shared<model::Map>(
+        model::Map::Id{"map"s}, "map"s,
+        model::Map::Roads{std::make_shared<model::Road>(
+            model::Road::HORIZONTAL, model::Point{0, 0}, 40)},
+        model::Map::Buildings{}, model::Map::Offices{}, std::nullopt, 3);
+    auto game = std::make_shared<app::Game>(
+        app::Game::Maps{map}, 2.0, std::make_shared<app::GameSessionHandler>());
+    return std::make_shared<app::Application>(
+        std::make_shared<app::Players>(), game,
+        std::make_shared<loot_gen::LootGenerator>(100ms, 0.0, 0ms),
+        std::make_shared<LootHandler>(
+            LootHandler::LootTypeByMap{},
+            LootHandler::LootTypeScoreByMap{{map->GetId(), {10, 20, 30}}}),
+        std::make_shared<LootNumberMapHandler>(
+            LootNumberMapHandler::LootNumberByMap{}, 10),
+        false, nullptr);
+}
+
+model::Direction GetDirection(const app::Application& app,
+                              const app::Token& token) {
+    return app.GetGameState(token).player_coord_infos.front().direction;
+}
+
+}  // namespace
+
+SCENARIO("Queued moves") {
+    GIVEN("an application queueing moves") {
+        auto app = MakeApplication();
+        app->SetQueueMoves(true);
+        const auto token = app->JoinGame(model::Map::Id{"map"s}, "Rex"s).token;
+
+        WHEN("a player moves") {
+            app->MovePlayer(token, model::Direction::EAST);
+
+            THEN("the move waits for the next tick") {
+                CHECK(GetDirection(*app, token) == model::Direction::NORTH);
+                app->Tick(10ms);
+                CHECK(GetDirection(*app, token) == model::Direction::EAST);
+            }
+        }
+
+        WHEN("a player moves several times between ticks") {
+            app->MovePlayer(token, model::Direction::EAST);
+            app->MovePlayer(token, model::Direction::NORTH);
+            app->MovePlayer(token, model::Direction::WEST);
+            app->Tick(10ms);
+
+            THEN("the last move wins") {
+                CHECK(GetDirection(*app, token) == model::Direction::WEST);
+            }
+        }
+
+        WHEN("the token is unknown") {
+            THEN("the move is rejected right away") {
+                CHECK_THROWS_AS(
+                    app->MovePlayer(app::Token{std::string(32, '0')},
+                                    model::Direction::EAST),
+                    MovePlayerError);
+            }
+        }
+
+        WHEN("players move from several threads") {
+            std::vector<app::Token> tokens{token};
+            for (int i = 0; i < 3; ++i) {
+                tokens.push_back(
+                    app->JoinGame(model::Map::Id{"map"s}, "Bob"s).token);
+            }
+            {
+                std::vector<std::jthread> workers;
+                for (const auto& player_token : tokens) {
+                    workers.emplace_back([&app, player_token] {
+                        for (int i = 0; i < 1000; ++i) {
+                            app->MovePlayer(player_token,
+                                            model::Direction::NORTH);
+                        }
+                        app->MovePlayer(player_token, model::Direction::SOUTH);
+                    });
+                }
+            }
+            app->Tick(10ms);
+
+            THEN("every player gets its last move") {
+                for (const auto& player_token : tokens) {
+                    CHECK(GetDirection(*app, player_token) ==
+                          model::Direction::SOUTH);
+                }
+            }
+        }
+    }
+}
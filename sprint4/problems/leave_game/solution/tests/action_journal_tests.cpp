@@ -0,0 +1,151 @@
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <filesystem>
+#include <memory>
+#include <string>
+
+#include "app/application.h"
+#include "serialization/action_journal.h"
+
+using namespace std::literals;
+
+namespace {
+
+app::Application::Pointer MakeApplication() {
+    auto map = std::make_shared<model::Map>(
+        model::Map::Id{"map"s}, "map"s,
+        model::Map::Roads{std::make_shared<model::Road>(
+                              model::Road::HORIZONTAL, model::Point{0, 0}, 40),
+                          std::make_shared<model::Road>(
+                              model::Road::VERTICAL, model::Point{40, 0}, 30)},
+        model::Map::Buildings{}, model::Map::Offices{}, std::nullopt, 3);
+    auto game = std::make_shared<app::Game>(
+        app::Game::Maps{map}, 2.0, std::make_shared<app::GameSessionHandler>());
+    return std::make_shared<app::Application>(
+        std::make_shared<app::Players>(), game,
+        std::make_shared<loot_gen::LootGenerator>(100ms, 1.0, 0ms),
+        std::make_shared<LootHandler>(
+            LootHandler::LootTypeByMap{},
+            LootHandler::LootTypeScoreByMap{{map->GetId(), {10, 20, 30}}}),
+        std::make_shared<LootNumberMapHandler>(
+            LootNumberMapHandler::LootNumberByMap{}, 10),
+        true, nullptr);
+}
+
+void CheckSameState(app::Application& expected, app::Application& actual,
+                    const app::Token& token) {
+    const auto expected_state = expected.GetGameState(token);
+    const auto actual_state = actual.GetGameState(token);
+    REQUIRE(actual_state.player_coord_infos.size() ==
+            expected_state.player_coord_infos.size());
+    for (size_t i = 0; i < expected_state.player_coord_infos.size(); ++i) {
+        const auto& lhs = expected_state.player_coord_infos[i];
+        const auto& rhs = actual_state.player_coord_infos[i];
+        CHECK(rhs.id == lhs.id);
+        CHECK(rhs.position == lhs.position);
+        CHECK(rhs.items.size() == lhs.items.size());
+    }
+    REQUIRE(actual_state.lost_objects.size() ==
+            expected_state.lost_objects.size());
+    for (size_t i = 0; i < expected_state.lost_objects.size(); ++i) {
+        CHECK(actual_state.lost_objects[i].type ==
+              expected_state.lost_objects[i].type);
+        CHECK(actual_state.lost_objects[i].position ==
+              expected_state.lost_objects[i].position);
+    }
+}
+
+}  // namespace
+
+SCENARIO("Action journal") {
+    GIVEN("an application journaling its actions") {
+        const auto journal_file =
+            std::filesystem::temp_directory_path() / "action_journal_tests.wal";
+        std::filesystem::remove(journal_file);
+
+        auto recorded = MakeApplication();
+        app::Token token{""s};
+        {
+            auto journal =
+                std::make_shared<serialization::FileActionJournal>(
+                    journal_file);
+            recorded->SetJournal(journal);
+            journal->Checkpoint(recorded->MakeCheckpoint(42));
+
+            token = recorded->JoinGame(model::Map::Id{"map"s}, "Rex"s).token;
+            recorded->JoinGame(model::Map::Id{"map"s}, "Bob"s);
+            recorded->Tick(250ms);
+            recorded->MovePlayer(token, model::Direction::EAST);
+            recorded->Tick(500ms);
+            recorded->MovePlayer(token, model::Direction::SOUTH);
+            recorded->Tick(300ms);
+            journal->Flush();
+            recorded->SetJournal(nullptr);
+        }
+
+        WHEN("the journal is replayed into a fresh application") {
+            auto replayed = MakeApplication();
+            const auto result =
+                serialization::ReplayActionJournal(journal_file, *replayed);
+
+            THEN("the recorded state is reproduced") {
+                CHECK(result.records == 8);
+                CHECK_FALSE(result.is_torn);
+                CHECK(result.valid_size ==
+                      std::filesystem::file_size(journal_file));
+                CHECK_FALSE(
+                    recorded->GetGameState(token).lost_objects.empty());
+                CheckSameState(*recorded, *replayed, token);
+            }
+        }
+
+        WHEN("the journal ends with a torn record") {
+            const auto full_size = std::filesystem::file_size(journal_file);
+            std::filesystem::resize_file(journal_file, full_size - 3);
+            auto replayed = MakeApplication();
+            const auto result =
+                serialization::ReplayActionJournal(journal_file, *replayed);
+
+            THEN("the replay stops before it") {
+                CHECK(result.records == 7);
+                CHECK(result.is_torn);
+                CHECK(result.valid_size < full_size - 3);
+                CHECK(replayed->GetGameState(token)
+                          .player_coord_infos.size() == 2);
+            }
+        }
+
+        WHEN("a newer snapshot already holds the journaled actions") {
+            auto replayed = MakeApplication();
+            replayed->AdvanceSnapshotGeneration();
+            const auto result =
+                serialization::ReplayActionJournal(journal_file, *replayed);
+
+            THEN("nothing is replayed") {
+                CHECK(result.records == 0);
+                CHECK(result.is_stale);
+                CHECK(result.valid_size == 0);
+                CHECK(replayed->GetMemoryReport().players.count == 0);
+            }
+        }
+
+        WHEN("the application replayed into differs from the recorded one") {
+            // The recorded token is taken, the journaled join gets another
+            auto replayed = MakeApplication();
+            replayed->MakeCheckpoint(42);
+            replayed->JoinGame(model::Map::Id{"map"s}, "Intruder"s);
+            const auto result =
+                serialization::ReplayActionJournal(journal_file, *replayed);
+
+            THEN("the replay stops at the first diverging record") {
+                CHECK(result.is_diverged);
+                CHECK_FALSE(result.is_torn);
+                CHECK(result.records == 1);
+                CHECK(result.valid_size <
+                      std::filesystem::file_size(journal_file));
+            }
+        }
+
+        std::filesystem::remove(journal_file);
+    }
+}
@@ -0,0 +1,126 @@
+#include <catch2/catch_test_macros.hpp>
+#include <cstddef>
+#include <cstdlib>
+#include <memory_resource>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "app/collision_detector.h"
+#include "request_handler/api_handler/parsers/game_tick_request.h"
+#include "request_handler/api_handler/parsers/join_game_request.h"
+
+// Heap allocations of the test binary are counted only inside
+// AllocationCounter scopes
+namespace {
+
+thread_local size_t* active_counter = nullptr;
+
+class AllocationCounter {
+   public:
+    AllocationCounter() { active_counter = &count_; }
+    ~AllocationCounter() { active_counter = nullptr; }
+
+    size_t GetCount() const noexcept { return count_; }
+
+   private:
+    size_t count_ = 0;
+};
+
+// Counts chunks requested by a memory resource from its upstream
+class CountingResource : public std::pmr::memory_resource {
+   public:
+    size_t GetCount() const noexcept { return count_; }
+
+   private:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+        ++count_;
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void* ptr, std::size_t bytes,
+                       std::size_t alignment) override {
+        std::pmr::new_delete_resource()->deallocate(ptr, bytes, alignment);
+    }
+
+    bool do_is_equal(
+        const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+
+    size_t count_ = 0;
+};
+
+class OneGathererProvider : public collision_detector::ItemGathererProvider {
+   public:
+    size_t ItemsCount() const override { return 64; }
+    collision_detector::Item GetItem(size_t idx) const override {
+        return {.position = {static_cast<double>(idx), 0.0}, .width = 0.0};
+    }
+    size_t GatherersCount() const override { return 1; }
+    collision_detector::Gatherer GetGatherer(size_t) const override {
+        return {.start_pos = {-1.0, 0.0},
+                .end_pos = {100.0, 0.0},
+                .width = 0.6};
+    }
+};
+
+}  // namespace
+
+void* operator new(std::size_t size) {
+    if (active_counter) {
+        ++*active_counter;
+    }
+    if (void* ptr = std::malloc(size == 0 ? 1 : size)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+
+void operator delete(void* ptr, [[maybe_unused]] std::size_t size) noexcept {
+    std::free(ptr);
+}
+
+SCENARIO("Per-request and per-tick allocations") {
+    using namespace request_handler::api_handler;
+
+    GIVEN("small request bodies") {
+        const std::string join_body = R"({"userName": "Rex", "mapId": "map1"})";
+        const std::string tick_body = R"({"timeDelta": 50})";
+
+        WHEN("they are parsed") {
+            AllocationCounter counter;
+            auto join = JoinGameRequest::ParseFromJson(join_body);
+            auto tick = GameTickRequest::ParseFromJson(tick_body);
+
+            THEN("the DOM lives in the stack arena") {
+                REQUIRE(join.has_value());
+                REQUIRE(tick.has_value());
+                CHECK(counter.GetCount() == 0);
+            }
+        }
+    }
+
+    GIVEN("a tick arena over a buffer") {
+        std::vector<std::byte> buffer(64 * 1024);
+        CountingResource upstream;
+        std::pmr::monotonic_buffer_resource arena(buffer.data(), buffer.size(),
+                                                  &upstream);
+        OneGathererProvider provider;
+
+        WHEN("gather events are found tick after tick") {
+            for (int tick = 0; tick < 100; ++tick) {
+                auto events =
+                    collision_detector::FindGatherEvents(provider, &arena);
+                REQUIRE(events.size() == 64);
+                arena.release();
+            }
+
+            THEN("nothing is requested from upstream") {
+                CHECK(upstream.GetCount() == 0);
+            }
+        }
+    }
+}
@@ -0,0 +1,247 @@
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <boost/json.hpp>
+
+#include "json_converter.h"
+#include "request_handler/utils/encoding.h"
+#include "utils/cbor_writer.h"
+
+namespace {
+
+// Reads back what CborWriter produces, enough to compare with a DOM
+class CborReader {
+   public:
+    explicit CborReader(const std::string& data) : data_(data) {}
+
+    boost::json::value Read() {
+        const std::uint8_t initial = Byte();
+        const std::uint8_t major = initial >> 5;
+        const std::uint8_t info = initial & 31;
+        switch (major) {
+            case 0:
+                return Argument(info);
+            case 1:
+                return -1 - static_cast<std::int64_t>(Argument(info));
+            case 3: {
+                const auto size = Argument(info);
+                std::string str = data_.substr(pos_, size);
+                pos_ += size;
+                return boost::json::string(str);
+            }
+            case 4: {
+                boost::json::array array;
+                ReadItems(info, [&] { array.push_back(Read()); });
+                return array;
+            }
+            case 5: {
+                boost::json::object object;
+                ReadItems(info, [&] {
+                    const auto key = Read();
+                    object[key.as_string()] = Read();
+                });
+                return object;
+            }
+            case 7:
+                return ReadSimple(info);
+        }
+        throw std::runtime_error("Unexpected major type");
+    }
+
+    bool IsAtEnd() const { return pos_ == data_.size(); }
+
+   private:
+    static constexpr std::uint8_t BREAK = 0xFF;
+
+    std::uint8_t Byte() { return static_cast<std::uint8_t>(data_.at(pos_++)); }
+
+    std::uint64_t BigEndian(int bytes) {
+        std::uint64_t value = 0;
+        for (int i = 0; i < bytes; ++i) {
+            value = (value << 8) | Byte();
+        }
+        return value;
+    }
+
+    std::uint64_t Argument(std::uint8_t info) {
+        if (info < 24) {
+            return info;
+        }
+        return BigEndian(1 << (info - 24));
+    }
+
+    template <typename Fn>
+    void ReadItems(std::uint8_t info, Fn&& read_item) {
+        if (info == 31) {
+            while (static_cast<std::uint8_t>(data_.at(pos_)) != BREAK) {
+                read_item();
+            }
+            ++pos_;
+            return;
+        }
+        for (auto size = Argument(info); size > 0; --size) {
+            read_item();
+        }
+    }
+
+    boost::json::value ReadSimple(std::uint8_t info) {
+        switch (info) {
+            case 20:
+                return false;
+            case 21:
+                return true;
+            case 22:
+                return nullptr;
+            case 26: {
+                const auto bits = static_cast<std::uint32_t>(BigEndian(4));
+                float value;
+                std::memcpy(&value, &bits, sizeof(value));
+                return static_cast<double>(value);
+            }
+            case 27: {
+                const auto bits = BigEndian(8);
+                double value;
+                std::memcpy(&value, &bits, sizeof(value));
+                return value;
+            }
+        }
+        throw std::runtime_error("Unexpected simple value");
+    }
+
+    const std::string& data_;
+    size_t pos_ = 0;
+};
+
+// The document CBOR carries, in JSON text so it compares with the DOM
+std::string Decode(const std::string& cbor) {
+    CborReader reader{cbor};
+    auto value = reader.Read();
+    CHECK(reader.IsAtEnd());
+    return boost::json::serialize(value);
+}
+
+}  // namespace
+
+SCENARIO("CBOR writer") {
+    GIVEN("a game state with players and lost objects") {
+        model::Item key{.id = model::Item::Id{7u},
+                        .type = 1,
+                        .position = {1.0, 2.5},
+                        .value = 10};
+        GameState state{
+            .player_coord_infos = {{.id = app::Player::Id{0u},
+                                    .position = {0.1, 1e-7},
+                                    .velocity = {-3.0, 0.0},
+                                    .direction = model::Direction::WEST,
+                                    .items = {key, key},
+                                    .score = 30},
+                                   {.id = app::Player::Id{3u},
+                                    .position = {123456.789, 2.0},
+                                    .velocity = {0.0, 0.0},
+                                    .direction = model::Direction::NONE,
+                                    .items = {},
+                                    .score = 0}},
+            .lost_objects = {key, {.type = 0, .position = {-0.5, 3.0}}},
+            .out_of_view = OutOfViewSummary{.players = 2, .lost_objects = 5}};
+
+        THEN("it carries the same document as the JSON writer") {
+            const auto cbor = json_converter::Serialize<utils::CborWriter>(
+                json_converter::WriteGameState, state);
+            const auto json = json_converter::Serialize(
+                json_converter::WriteGameState, state);
+            CHECK(Decode(cbor) == json);
+            CHECK(cbor.size() < json.size());
+        }
+    }
+
+    GIVEN("players and records") {
+        std::vector<PlayerInfo> players{
+            {.id = app::Player::Id{0u}, .name = "\"Rex\""},
+            {.id = app::Player::Id{1u}, .name = "Бобик"}};
+        std::vector<GameRecord> records{{"Rex", 12, 61.25},
+                                        {std::string(300, 'a'), 0, 0.0}};
+        GameRecordsPage page{.records = records, .next_cursor = "abc"};
+
+        THEN("each carries the same document as the JSON writer") {
+            CHECK(Decode(json_converter::Serialize<utils::CborWriter>(
+                      json_converter::WritePlayerInfos, players)) ==
+                  json_converter::Serialize(json_converter::WritePlayerInfos,
+                                            players));
+            CHECK(Decode(json_converter::Serialize<utils::CborWriter>(
+                      json_converter::WriteGameRecords, records)) ==
+                  json_converter::Serialize(json_converter::WriteGameRecords,
+                                            records));
+            CHECK(Decode(json_converter::Serialize<utils::CborWriter>(
+                      json_converter::WriteGameRecordsPage, page)) ==
+                  json_converter::Serialize(
+                      json_converter::WriteGameRecordsPage, page));
+        }
+    }
+
+    GIVEN("a DOM with every kind of value") {
+        boost::json::array flags{true, false};
+        flags.push_back(boost::json::value{});
+        boost::json::value dom = boost::json::object{
+            {"id", "map1"},
+            {"flags", flags},
+            {"numbers",
+             boost::json::array{0, 23, 24, 255, 256, 65536, -1, -25,
+                                4294967296ull, 0.5, 1e300, -2.25}}};
+
+        THEN("it carries the same document") {
+            std::string cbor;
+            utils::CborWriter{cbor}.Value(dom);
+            CHECK(Decode(cbor) == boost::json::serialize(dom));
+        }
+    }
+
+    GIVEN("numbers at the boundaries of their encodings") {
+        const auto encode = [](auto number) {
+            std::string cbor;
+            utils::CborWriter{cbor}.Number(number);
+            return cbor;
+        };
+
+        THEN("each takes the shortest head") {
+            CHECK(encode(23) == "\x17");
+            CHECK(encode(24) == std::string("\x18\x18", 2));
+            CHECK(encode(-1) == "\x20");
+            CHECK(encode(256u) == std::string("\x19\x01\x00", 3));
+            CHECK(encode(INT64_MIN).size() == 9);
+            CHECK(encode(1.5).size() == 5);
+            CHECK(encode(0.1).size() == 9);
+        }
+    }
+}
+
+SCENARIO("Response encoding negotiation") {
+    using request_handler::encoding::Encoding;
+    using request_handler::encoding::Negotiate;
+
+    THEN("JSON stays the default") {
+        CHECK(Negotiate("") == Encoding::JSON);
+        CHECK(Negotiate("*/*") == Encoding::JSON);
+        CHECK(Negotiate("application/json") == Encoding::JSON);
+        CHECK(Negotiate("text/html, application/xml;q=0.9") ==
+              Encoding::JSON);
+    }
+
+    THEN("CBOR is chosen when the client weighs it at least as much") {
+        CHECK(Negotiate("application/cbor") == Encoding::CBOR);
+        CHECK(Negotiate("Application/CBOR") == Encoding::CBOR);
+        CHECK(Negotiate("application/json;q=0.5, application/cbor") ==
+              Encoding::CBOR);
+        CHECK(Negotiate("application/cbor, */*") == Encoding::CBOR);
+    }
+
+    THEN("CBOR weighed less or refused gives JSON") {
+        CHECK(Negotiate("application/cbor;q=0.5, application/json") ==
+              Encoding::JSON);
+        CHECK(Negotiate("application/cbor;q=0") == Encoding::JSON);
+        CHECK(Negotiate("application/cbor;q=abc") == Encoding::JSON);
+    }
+}
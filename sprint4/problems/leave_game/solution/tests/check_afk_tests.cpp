@@ -0,0 +1,157 @@
+#include <catch2/catch_test_macros.hpp>
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <memory>
+#include <ranges>
+#include <string>
+#include <vector>
+
+#include "app/game/game.h"
+#include "app/player/players.h"
+#include "app/use_cases/tick_use_case/check_afk_provider.h"
+#include "../tools/counting_unit_of_work.h"
+#include "model/map.h"
+
+using namespace std::literals;
+
+namespace {
+
+// Keeps the handlers instead of running them, as a pool waiting for a
+// connection would
+class DeferredUnitOfWorkFactory : public tools::CountingUnitOfWorkFactory {
+   public:
+    void AsyncCreateUnitOfWork(UnitOfWorkHandler handler) override {
+        pending_.push_back(std::move(handler));
+    }
+
+    void RunPending() {
+        for (auto& handler : pending_) {
+            handler(nullptr, CreateUnitOfWork());
+        }
+        pending_.clear();
+    }
+
+    size_t GetPendingCount() const noexcept { return pending_.size(); }
+
+   private:
+    std::vector<UnitOfWorkHandler> pending_;
+};
+
+}  // namespace
+
+SCENARIO("CheckAFKProvider") {
+    model::Map::Roads roads{std::make_shared<model::Road>(
+        model::Road::HORIZONTAL, model::Point{0, 0}, 1000)};
+    auto map = std::make_shared<model::Map>(
+        model::Map::Id{"map"}, "map", roads, model::Map::Buildings{},
+        model::Map::Offices{}, 1.0, 10);
+    auto game = std::make_shared<app::Game>(
+        app::Game::Maps{map}, 1.0, std::make_shared<app::GameSessionHandler>(),
+        1000ms);
+    auto session = game->CreateGameSession(map->GetId());
+    auto players = std::make_shared<app::Players>();
+
+    CheckAFKProvider provider(game, players, nullptr);
+    provider.SetWriteRetired(false);
+
+    const auto tick = [&](std::chrono::milliseconds delta_time) {
+        for (auto& player : players->GetPlayers()) {
+            player.Move(delta_time);
+        }
+        return provider.CheckAFKPlayers(delta_time);
+    };
+
+    GIVEN("a player standing still and a player walking") {
+        auto [idle_id, idle_token] =
+            players->Add(session, session->AddDog({0.0, 0.0}, "idle", 1.0));
+        auto [walking_id, walking_token] =
+            players->Add(session, session->AddDog({0.0, 0.0}, "walker", 1.0));
+        players->Find(walking_token)->SetDirection(model::Direction::EAST);
+
+        THEN("the idle one retires on the tick its idle time is reached") {
+            for (int i = 0; i < 9; ++i) {
+                CHECK(tick(100ms) == 0);
+            }
+            CHECK(tick(100ms) == 1);
+            CHECK_FALSE(players->Find(idle_token));
+            CHECK_FALSE(players->Find(
+                app::PlayerSession{idle_id, session->GetMapHandle()}));
+            CHECK_FALSE(players->FindToken(idle_id).has_value());
+            CHECK(std::ranges::distance(players->GetPlayers()) == 1);
+            CHECK(players->Find(walking_token));
+            CHECK(session->GetDogs().size() == 1);
+            CHECK(players->Find(walking_token)->GetDog()->GetName() ==
+                  "walker");
+
+            AND_THEN("the walker retires once it has stood still as long") {
+                players->Find(walking_token)
+                    ->SetDirection(model::Direction::NONE);
+                CHECK(tick(999ms) == 0);
+                CHECK(tick(1ms) == 1);
+                CHECK_FALSE(players->Find(walking_token));
+            }
+        }
+
+        THEN("one long tick retires the idle one at once") {
+            CHECK(tick(5s) == 1);
+        }
+    }
+
+    GIVEN("a walking player and a table of the names in use") {
+        const auto walking_token =
+            players->Add(session,
+                         session->AddDog({0.0, 0.0}, "check_afk_walker", 1.0))
+                .second;
+        players->Find(walking_token)->SetDirection(model::Direction::EAST);
+        const auto names = model::Dog::GetNames().GetSize();
+
+        WHEN("players with names no one else has join and retire in turn") {
+            constexpr int ROUNDS = 100;
+            constexpr int PER_ROUND = 10;
+            size_t max_names = 0;
+            for (int round = 0; round < ROUNDS; ++round) {
+                for (int i = 0; i < PER_ROUND; ++i) {
+                    players->Add(session,
+                                 session->AddDog(
+                                     {0.0, 0.0},
+                                     "check_afk_" +
+                                         std::to_string(round * PER_ROUND + i),
+                                     1.0));
+                }
+                max_names =
+                    std::max(max_names, model::Dog::GetNames().GetSize());
+                CHECK(tick(1000ms) == PER_ROUND);
+            }
+
+            THEN("the table holds only the names of the players in the game") {
+                CHECK(max_names == names + PER_ROUND);
+                CHECK(model::Dog::GetNames().GetSize() == names);
+                CHECK(session->GetDogs().size() == 1);
+                CHECK(players->Find(walking_token)->GetDog()->GetName() ==
+                      "check_afk_walker");
+            }
+        }
+    }
+
+    GIVEN("a provider that writes retired players") {
+        auto factory = std::make_shared<DeferredUnitOfWorkFactory>();
+        CheckAFKProvider writing_provider(game, players, factory);
+        players->Add(session, session->AddDog({0.0, 0.0}, "idle", 1.0));
+
+        WHEN("a player retires while no connection is available") {
+            for (auto& player : players->GetPlayers()) {
+                player.Move(5s);
+            }
+            CHECK(writing_provider.CheckAFKPlayers(5s) == 1);
+
+            THEN("the tick returns before the write is done") {
+                CHECK(factory->GetPendingCount() == 1);
+                CHECK(factory->GetRetiredCount() == 0);
+
+                factory->RunPending();
+                CHECK(factory->GetRetiredCount() == 1);
+            }
+        }
+    }
+}
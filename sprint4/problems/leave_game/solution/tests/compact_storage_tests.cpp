@@ -0,0 +1,213 @@
+#include <catch2/catch_test_macros.hpp>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "app/game/game.h"
+#include "app/player/players.h"
+#include "app/token.h"
+#include "app/use_cases/get_memory_report_use_case.h"
+#include "model/bag.h"
+#include "model/dog.h"
+#include "model/map.h"
+
+namespace {
+
+model::Item MakeItem(std::uint32_t id, int value) {
+    return {.id = model::Item::Id{id},
+            .type = static_cast<int>(id % 3),
+            .position = {1.0, 2.0},
+            .value = value};
+}
+
+}  // namespace
+
+SCENARIO("Bag") {
+    GIVEN("an empty bag") {
+        model::Bag bag;
+
+        WHEN("it holds no more items than fit inline") {
+            for (std::uint32_t i = 0; i < model::Bag::INLINE_CAPACITY; ++i) {
+                bag.Add(MakeItem(i, 10));
+            }
+
+            THEN("nothing is on the heap") {
+                CHECK(bag.GetSize() == model::Bag::INLINE_CAPACITY);
+                CHECK(bag.GetHeapBytes() == 0);
+                CHECK(bag.GetValue() == 30);
+            }
+        }
+
+        WHEN("it holds more items than fit inline") {
+            for (std::uint32_t i = 0; i < 7; ++i) {
+                bag.Add(MakeItem(i, i));
+            }
+
+            THEN("items spill to the heap in order") {
+                CHECK(bag.GetSize() == 7);
+                CHECK(bag.GetHeapBytes() > 0);
+                std::uint32_t id = 0;
+                for (const auto& entry : bag) {
+                    CHECK(*entry.id == id++);
+                }
+            }
+
+            THEN("copies and moves keep the items") {
+                model::Bag copy = bag;
+                CHECK(copy == bag);
+                model::Bag moved = std::move(copy);
+                CHECK(moved == bag);
+                CHECK(copy.IsEmpty());
+            }
+
+            THEN("emptying keeps the heap buffer for the next items") {
+                const auto heap_bytes = bag.GetHeapBytes();
+                bag.Clear();
+                bag.Add(MakeItem(0, 1));
+                CHECK(bag.GetSize() == 1);
+                CHECK(bag.GetHeapBytes() == heap_bytes);
+            }
+        }
+
+        WHEN("items are taken out of it") {
+            bag.Add(MakeItem(5, 20));
+            const auto items = bag.ToItems();
+
+            THEN("they keep id, type and value but not the position") {
+                REQUIRE(items.size() == 1);
+                CHECK(*items[0].id == 5);
+                CHECK(items[0].type == 2);
+                CHECK(items[0].value == 20);
+                CHECK(items[0].position == model::Coordinate{0.0, 0.0});
+            }
+        }
+    }
+}
+
+SCENARIO("Dog names and bags") {
+    GIVEN("two dogs of the same name") {
+        model::Dog first(0, "compact_storage_dog", 1.0, {0.0, 0.0});
+        const auto names = model::Dog::GetNames().GetSize();
+        model::Dog second(1, "compact_storage_dog", 1.0, {0.0, 0.0});
+
+        THEN("they share the interned name") {
+            CHECK(first.GetName() == "compact_storage_dog");
+            CHECK(second.GetName() == "compact_storage_dog");
+            CHECK(model::Dog::GetNames().GetSize() == names);
+        }
+
+        WHEN("a dog hands its bag in") {
+            first.AddItem(MakeItem(0, 10));
+            first.AddItem(MakeItem(1, 15));
+            first.DropAllItems();
+
+            THEN("the items count to the score and the bag is empty") {
+                CHECK(first.GetScore() == 25);
+                CHECK(first.GetItemCount() == 0);
+            }
+        }
+    }
+}
+
+SCENARIO("Token keys") {
+    GIVEN("a token as the server prints it") {
+        const app::Token token{"0123456789abcdef00000000000000ff"};
+
+        THEN("it round-trips through its key") {
+            const auto key = app::token::ParseKey(*token);
+            REQUIRE(key.has_value());
+            CHECK(key->high == 0x0123456789abcdefull);
+            CHECK(key->low == 0xffull);
+            CHECK(app::token::ToToken(*key) == token);
+        }
+
+        THEN("other spellings are not the same token") {
+            CHECK_FALSE(app::token::ParseKey("0123456789ABCDEF00000000000000ff")
+                            .has_value());
+            CHECK_FALSE(app::token::ParseKey("0123456789abcdef").has_value());
+            CHECK_FALSE(app::token::ParseKey("0123456789abcdef00000000000000fg")
+                            .has_value());
+        }
+    }
+
+    GIVEN("players") {
+        auto map = std::make_shared<model::Map>(
+            model::Map::Id{"map"}, "map", model::Map::Roads{},
+            model::Map::Buildings{}, model::Map::Offices{}, 1.0, 10);
+        auto session = std::make_shared<app::GameSession>(map);
+        app::Players players;
+        const auto [id, token] =
+            players.Add(session, session->AddDog({0.0, 0.0}, "dog", 1.0));
+
+        THEN("a player is found by the token and by its key") {
+            REQUIRE(players.Find(token) != nullptr);
+            CHECK(players.Find(token)->GetId() == id);
+            CHECK(players.Find(*app::token::ParseKey(*token)) ==
+                  players.Find(token));
+            CHECK(players.Find(app::Token{std::string(32, 'x')}) == nullptr);
+        }
+
+        THEN("the player refers to the session without owning it") {
+            CHECK(players.Find(token)->GetSession() == session.get());
+            CHECK(session.use_count() == 1);
+        }
+
+        WHEN("the player leaves") {
+            const auto key = *app::token::ParseKey(*token);
+            players.Remove(id);
+
+            THEN("its token is freed") {
+                CHECK(players.Find(key) == nullptr);
+                CHECK_FALSE(players.FindToken(id).has_value());
+                CHECK(players.GetTokensMemory().count == 0);
+            }
+        }
+    }
+}
+
+SCENARIO("Memory report") {
+    GIVEN("a game with players on a map") {
+        model::Map::Roads roads{std::make_shared<model::Road>(
+            model::Road::HORIZONTAL, model::Point{0, 0}, 100)};
+        auto map = std::make_shared<model::Map>(
+            model::Map::Id{"map"}, "map", roads, model::Map::Buildings{},
+            model::Map::Offices{}, 1.0, 10);
+        auto game = std::make_shared<app::Game>(
+            app::Game::Maps{map}, 1.0,
+            std::make_shared<app::GameSessionHandler>());
+        auto session = game->CreateGameSession(map->GetId());
+        auto players = std::make_shared<app::Players>();
+        for (int i = 0; i < 10; ++i) {
+            players->Add(session, session->AddDog({0.0, 0.0},
+                                                  "dog" + std::to_string(i),
+                                                  1.0));
+        }
+        session->AddLoot(0, {1.0, 0.0}, 10);
+
+        const auto report = GetMemoryReportUseCase(game, players).GetReport();
+
+        THEN("every entity is counted") {
+            REQUIRE(report.maps.size() == 1);
+            CHECK(report.maps[0].id == map->GetId());
+            CHECK(report.maps[0].bytes >= sizeof(model::Map));
+            REQUIRE(report.sessions.size() == 1);
+            CHECK(report.sessions[0].dogs.count == 10);
+            CHECK(report.sessions[0].loot.count == 1);
+            CHECK(report.dogs.count == 10);
+            CHECK(report.players.count == 10);
+            CHECK(report.tokens.count == 10);
+        }
+
+        THEN("the totals add up") {
+            CHECK(report.dogs.bytes >= 10 * sizeof(model::Dog));
+            CHECK(report.total_bytes ==
+                  report.maps[0].bytes + report.sessions[0].bytes +
+                      report.players.bytes + report.tokens.bytes +
+                      report.names.bytes);
+            CHECK(report.bytes_per_player ==
+                  (report.dogs.bytes + report.players.bytes +
+                   report.tokens.bytes) /
+                      10);
+        }
+    }
+}
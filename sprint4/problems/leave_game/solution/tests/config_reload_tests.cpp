@@ -0,0 +1,96 @@
+#include <catch2/catch_test_macros.hpp>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "app/game/game.h"
+#include "app/game/game_session_handler.h"
+#include "app/player/players.h"
+#include "app/use_cases/join_game_use_case.h"
+#include "app/use_cases/reload_config_use_case.h"
+
+using namespace std::literals;
+
+namespace {
+
+model::Map::Pointer MakeMap(const std::string& id, model::Map::Roads roads,
+                            int number_loot_types = 1) {
+    return std::make_shared<model::Map>(
+        model::Map::Id{id}, id, std::move(roads), model::Map::Buildings{},
+        model::Map::Offices{}, std::nullopt, number_loot_types);
+}
+
+model::Road::Pointer HorizontalRoad(int y, int x0, int x1) {
+    return std::make_shared<model::Road>(model::Road::HORIZONTAL,
+                                         model::Point{x0, y}, x1);
+}
+
+}  // namespace
+
+SCENARIO("Config reload") {
+    GIVEN("a game with sessions on three maps") {
+        auto game = std::make_shared<app::Game>(
+            app::Game::Maps{MakeMap("kept", {HorizontalRoad(0, 0, 10)}),
+                            MakeMap("moved", {HorizontalRoad(0, 0, 10)}),
+                            MakeMap("removed", {HorizontalRoad(0, 0, 10)})},
+            1.0, std::make_shared<app::GameSessionHandler>());
+        auto kept = game->CreateGameSession(model::Map::Id{"kept"s});
+        auto moved = game->CreateGameSession(model::Map::Id{"moved"s});
+        auto removed = game->CreateGameSession(model::Map::Id{"removed"s});
+        const auto kept_map = kept->GetMap();
+        moved->AddDog({8.0, 0.0}, "Rex", 1.0);
+        moved->AddLoot(0, {2.0, 0.0}, 10);
+        moved->AddLoot(1, {3.0, 0.0}, 20);
+
+        auto loot_handler = std::make_shared<LootHandler>(
+            LootHandler::LootTypeByMap{}, LootHandler::LootTypeScoreByMap{});
+        auto loot_number_map_handler = std::make_shared<LootNumberMapHandler>(
+            LootNumberMapHandler::LootNumberByMap{}, 3);
+        app::ReloadConfigUseCase use_case(game, loot_handler,
+                                          loot_number_map_handler);
+
+        WHEN("a config with a moved road and without a map is applied") {
+            auto result = use_case.Reload(
+                app::Game::Maps{
+                    MakeMap("kept", {HorizontalRoad(0, 0, 10)}),
+                    MakeMap("moved", {HorizontalRoad(5, 0, 4)}, 0),
+                    MakeMap("added", {HorizontalRoad(0, 0, 10)})},
+                LootHandler{{}, {{model::Map::Id{"moved"s}, {7}}}},
+                LootNumberMapHandler{{}, 5});
+
+            THEN("the maps are diffed") {
+                CHECK(result.added == 1);
+                CHECK(result.changed == 1);
+                CHECK(result.removed == 1);
+                CHECK(result.migrated_sessions == 1);
+                CHECK(kept->GetMap() == kept_map);
+                CHECK(game->FindMap(model::Map::Id{"added"s}));
+                CHECK_FALSE(game->FindMap(model::Map::Id{"removed"s}));
+            }
+
+            THEN("dogs and loot of changed maps are clamped to the new roads") {
+                REQUIRE(moved->GetDogs().size() == 1);
+                CHECK(moved->GetDogs().front().GetPosition() ==
+                      model::Coordinate{4.4, 4.6});
+                REQUIRE(moved->GetLootPositionsInfo().size() == 1);
+                CHECK(moved->GetLootPositionsInfo().front().position ==
+                      model::Coordinate{2.0, 4.6});
+            }
+
+            THEN("shared loot handlers see the new config") {
+                CHECK(loot_handler->FindValueByLootType(
+                          model::Map::Id{"moved"s}, 0) == 7);
+                CHECK(loot_number_map_handler->GetMaxLootNumber(
+                          model::Map::Id{"kept"s}) == 5);
+            }
+
+            THEN("sessions of removed maps are closed for new players") {
+                app::JoinGameUseCase join(
+                    game, std::make_shared<app::Players>(), false);
+                CHECK_THROWS_AS(join.Join(model::Map::Id{"removed"s}, "Bob"),
+                                JoinGameError);
+                CHECK(removed->GetMap());
+            }
+        }
+    }
+}
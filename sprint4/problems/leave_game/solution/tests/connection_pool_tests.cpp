@@ -0,0 +1,194 @@
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+#include <boost/asio/io_context.hpp>
+
+#include "postgres/connection_pool.h"
+
+using namespace std::literals;
+
+namespace {
+
+struct StubConnection {
+    bool is_open() const noexcept { return is_alive; }
+
+    bool is_alive = true;
+};
+
+using StubPool = BasicConnectionPool<StubConnection>;
+
+}  // namespace
+
+SCENARIO("Connection pool") {
+    int opened = 0;
+    auto factory = [&opened] {
+        ++opened;
+        return std::make_shared<StubConnection>();
+    };
+
+    GIVEN("a pool with one eager and up to two lazy connections") {
+        StubPool pool{{.min_size = 1, .max_size = 3, .acquire_timeout = 10ms},
+                      factory};
+        CHECK(opened == 1);
+
+        WHEN("all connections are taken") {
+            auto first = pool.GetConnection();
+            auto second = pool.GetConnection();
+            auto third = pool.GetConnection();
+
+            THEN("the pool grows to its max size") {
+                CHECK(opened == 3);
+                CHECK(pool.GetMetrics().in_use == 3);
+            }
+
+            THEN("the next acquire times out") {
+                CHECK_THROWS_AS(pool.GetConnection(),
+                                ConnectionPoolTimeoutError);
+                CHECK(pool.GetMetrics().timeouts == 1);
+            }
+        }
+
+        WHEN("a broken connection is returned") {
+            {
+                auto conn = pool.GetConnection();
+                conn->is_alive = false;
+            }
+
+            THEN("it is replaced by a new one on the next acquire") {
+                auto metrics = pool.GetMetrics();
+                CHECK(metrics.size == 0);
+                CHECK(metrics.dropped_broken == 1);
+
+                auto conn = pool.GetConnection();
+                CHECK(conn->is_open());
+                CHECK(opened == 2);
+            }
+        }
+    }
+
+    GIVEN("a pool with one connection that is already taken") {
+        StubPool pool{{.min_size = 1, .max_size = 1, .acquire_timeout = 5s},
+                      factory};
+        std::optional<StubPool::ConnectionWrapper> taken{pool.GetConnection()};
+
+        WHEN("two callers wait for it one after the other") {
+            std::mutex mutex;
+            std::vector<int> served;
+            auto wait_for_connection = [&](int caller) {
+                return std::thread([&, caller] {
+                    auto conn = pool.GetConnection();
+                    std::lock_guard lock{mutex};
+                    served.push_back(caller);
+                });
+            };
+            const auto wait_until_waiting = [&pool](size_t count) {
+                while (pool.GetMetrics().waiting < count) {
+                    std::this_thread::yield();
+                }
+            };
+
+            auto first = wait_for_connection(1);
+            wait_until_waiting(1);
+            auto second = wait_for_connection(2);
+            wait_until_waiting(2);
+            taken.reset();
+            first.join();
+            second.join();
+
+            THEN("they get it in the order they came") {
+                CHECK(served == std::vector<int>{1, 2});
+                CHECK(pool.GetMetrics().waiting == 0);
+                CHECK(opened == 1);
+            }
+        }
+    }
+
+    GIVEN("a pool whose only connection is taken, and an io_context") {
+        StubPool pool{{.min_size = 1, .max_size = 1, .acquire_timeout = 5s},
+                      factory};
+        std::optional<StubPool::ConnectionWrapper> taken{pool.GetConnection()};
+        boost::asio::io_context ioc;
+
+        WHEN("a connection is acquired asynchronously") {
+            bool is_completed = false;
+            pool.AsyncGetConnection(
+                ioc.get_executor(),
+                [&is_completed](std::exception_ptr error,
+                                StubPool::ConnectionWrapper conn) {
+                    is_completed = !error && static_cast<bool>(conn);
+                });
+
+            THEN("it completes on the executor after the connection returns") {
+                ioc.poll();
+                CHECK(!is_completed);
+                CHECK(pool.GetMetrics().waiting == 1);
+
+                taken.reset();
+                CHECK(!is_completed);
+                ioc.poll();
+                CHECK(is_completed);
+                CHECK(pool.GetMetrics().in_use == 0);
+            }
+        }
+
+        WHEN("an asynchronous caller waits before a blocking one") {
+            std::mutex mutex;
+            std::vector<int> served;
+            pool.AsyncGetConnection(
+                ioc.get_executor(),
+                [&](std::exception_ptr, StubPool::ConnectionWrapper conn) {
+                    REQUIRE(conn);
+                    std::lock_guard lock{mutex};
+                    served.push_back(1);
+                });
+            std::thread blocking([&] {
+                auto conn = pool.GetConnection();
+                std::lock_guard lock{mutex};
+                served.push_back(2);
+            });
+            while (pool.GetMetrics().waiting < 2) {
+                std::this_thread::yield();
+            }
+            taken.reset();
+            ioc.run();
+            blocking.join();
+
+            THEN("the asynchronous caller is served first") {
+                CHECK(served == std::vector<int>{1, 2});
+                CHECK(pool.GetMetrics().waiting == 0);
+                CHECK(opened == 1);
+            }
+        }
+    }
+
+    GIVEN("an exhausted pool with a short timeout") {
+        StubPool pool{{.min_size = 1, .max_size = 1, .acquire_timeout = 10ms},
+                      factory};
+        auto taken = pool.GetConnection();
+        boost::asio::io_context ioc;
+
+        WHEN("an asynchronous acquire waits too long") {
+            std::exception_ptr result;
+            pool.AsyncGetConnection(ioc.get_executor(),
+                                    [&result](std::exception_ptr error,
+                                              StubPool::ConnectionWrapper) {
+                                        result = error;
+                                    });
+            ioc.run();
+
+            THEN("it fails with a timeout") {
+                REQUIRE(result);
+                CHECK_THROWS_AS(std::rethrow_exception(result),
+                                ConnectionPoolTimeoutError);
+                CHECK(pool.GetMetrics().waiting == 0);
+                CHECK(pool.GetMetrics().timeouts == 1);
+            }
+        }
+    }
+}
@@ -24,6 +24,9 @@ class GameWithOneMap : public app::Game {
     GameSessionPointer FindGameSession(const Map::Id& map_id) override {
         return game_session_;
     }
+    GameSessionPointer FindGameSession(Map::Handle map) override {
+        return game_session_;
+    }
     const Maps& GetMaps() const noexcept override { return maps_; }
 
     const Map::Pointer GetCorrectMap() const noexcept { return map_; }
@@ -1,7 +1,7 @@
 #pragma once
 
-#include <deque>
 #include <memory>
+#include <vector>
 
 #include "app/game/game_session.h"
 #include "app/player/players.h"
@@ -17,7 +17,9 @@ class EmptyPlayers : public app::PlayersCollection {
         return nullptr;
     }
 
-    std::deque<app::Player> GetPlayers() override { return {}; }
+    PlayersView GetPlayers() override { return {}; }
+
+    std::vector<app::TokenKey> TakeNewPlayers() override { return {}; }
 };
 
 class OnePlayerPlayers : public app::PlayersCollection {
@@ -44,6 +46,6 @@ class OnePlayerPlayers : public app::PlayersCollection {
         std::make_shared<app::GameSession>(map_);
     model::Dog::Pointer dog_ = session_->AddDog(model::Coordinate{0.0, 0.0},
                                                 "dog"s, *map_->GetMaxSpeed());
-    app::Player::Pointer player_ = new app::Player(session_, dog_);
+    app::Player::Pointer player_ = new app::Player(session_.get(), dog_);
 };
 }  // namespace test_players
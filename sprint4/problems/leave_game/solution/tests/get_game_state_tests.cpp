@@ -97,5 +97,47 @@ SCENARIO("Get game state") {
                 }
             }
         }
+
+        AND_GIVEN("loot near the player and far from it") {
+            auto session = players->GetSession();
+            session->AddLoot(1, model::Coordinate{1.0, 0.0}, 0);
+            session->AddLoot(1, model::Coordinate{100.0, 0.0}, 0);
+
+            WHEN("state is asked for a radius around the player") {
+                auto game_state = use_case.GetGameState(
+                    app::Token{""}, GameStateFilter{.radius = 5.0});
+                THEN("only nearby loot is returned") {
+                    REQUIRE(game_state.lost_objects.size() == 1);
+                    CHECK(game_state.lost_objects[0].position.x == 1.0);
+                    CHECK(game_state.player_coord_infos.size() == 1);
+                }
+
+                AND_THEN("the rest is counted") {
+                    REQUIRE(game_state.out_of_view);
+                    CHECK(game_state.out_of_view->players == 0);
+                    CHECK(game_state.out_of_view->lost_objects == 1);
+                }
+            }
+
+            WHEN("state is asked for a viewport") {
+                auto game_state = use_case.GetGameState(
+                    app::Token{""},
+                    GameStateFilter{.viewport = app::AreaOfInterest::Viewport(
+                                        {50.0, -1.0}, {150.0, 1.0})});
+                THEN("only what is inside it is returned") {
+                    CHECK(game_state.player_coord_infos.empty());
+                    REQUIRE(game_state.lost_objects.size() == 1);
+                    CHECK(game_state.lost_objects[0].position.x == 100.0);
+                }
+            }
+
+            WHEN("state is asked without an area") {
+                auto game_state = use_case.GetGameState(app::Token{""});
+                THEN("everything is returned and nothing counted") {
+                    CHECK(game_state.lost_objects.size() == 2);
+                    CHECK_FALSE(game_state.out_of_view);
+                }
+            }
+        }
     }
 }
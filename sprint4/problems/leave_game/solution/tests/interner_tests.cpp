@@ -0,0 +1,78 @@
+#include <catch2/catch_test_macros.hpp>
+#include <optional>
+#include <string>
+
+#include "model/map.h"
+#include "utils/interner.h"
+
+SCENARIO("Interner") {
+    GIVEN("an interner") {
+        utils::Interner interner;
+
+        WHEN("strings are interned") {
+            const auto town = interner.Intern("town");
+            const auto map1 = interner.Intern("map1");
+
+            THEN("handles are dense in first-seen order") {
+                CHECK(town == 0);
+                CHECK(map1 == 1);
+                CHECK(interner.GetSize() == 2);
+            }
+
+            THEN("interning a string again gives its handle back") {
+                CHECK(interner.Intern(std::string("town")) == town);
+                CHECK(interner.GetSize() == 2);
+            }
+
+            THEN("find does not add unknown strings") {
+                CHECK(interner.Find("map1") == map1);
+                CHECK_FALSE(interner.Find("unknown").has_value());
+                CHECK(interner.GetSize() == 2);
+            }
+        }
+    }
+
+    GIVEN("a reference-counted interner") {
+        utils::RefCountedInterner interner;
+
+        WHEN("a string is interned twice") {
+            auto first = interner.Intern("rex");
+            std::optional<utils::RefCountedInterner::Ref> second =
+                interner.Intern(std::string("rex"));
+
+            THEN("both refs share one entry") {
+                CHECK(first.GetKey() == "rex");
+                CHECK(second->GetKey() == "rex");
+                CHECK(first.GetKey().data() == second->GetKey().data());
+                CHECK(interner.GetSize() == 1);
+            }
+
+            THEN("the entry stays until the last ref is gone") {
+                auto copy = first;
+                first = {};
+                second.reset();
+                CHECK(interner.GetSize() == 1);
+                CHECK(copy.GetKey() == "rex");
+                copy = {};
+                CHECK(interner.GetSize() == 0);
+            }
+        }
+    }
+
+    GIVEN("two maps with the same id") {
+        using namespace model;
+        const Map first{Map::Id{"interner_test_map"}, "First", {}, {}, {},
+                        std::nullopt, 1};
+        const Map second{Map::Id{"interner_test_map"}, "Second", {}, {}, {},
+                         std::nullopt, 1};
+
+        THEN("they share a handle that can be found by the id") {
+            CHECK(*first.GetHandle() == *second.GetHandle());
+            const auto found = Map::FindHandle(first.GetId());
+            REQUIRE(found.has_value());
+            CHECK(**found == *first.GetHandle());
+            CHECK_FALSE(
+                Map::FindHandle(Map::Id{"interner_test_missing"}).has_value());
+        }
+    }
+}
@@ -0,0 +1,138 @@
+#include <catch2/catch_test_macros.hpp>
+#include <filesystem>
+#include <string>
+
+#include "../src/json_loader.h"
+#include "../src/serialization/config_cache.h"
+
+using namespace std::literals;
+
+namespace {
+
+const std::string VALID_CONFIG = R"({
+  "defaultDogSpeed": 3,
+  "dogRetirementTime": 15.0,
+  "lootGeneratorConfig": {"period": 5.0, "probability": 0.5},
+  "rateLimits": {"perToken": {"rate": 20, "burst": 40}, "maxApiQueue": 500},
+  "maps": [{
+    "id": "map1", "name": "Map 1",
+    "lootTypes": [{"name": "key", "value": 10}],
+    "roads": [{"x0": 0, "y0": 0, "x1": 40}, {"x0": 40, "y0": 0, "y1": 30}],
+    "buildings": [{"x": 5, "y": 5, "w": 30, "h": 20}],
+    "offices": [{"id": "o0", "x": 40, "y": 30, "offsetX": 5, "offsetY": 0}]
+  }, {
+    "id": "map2", "name": "Map 2", "dogSpeed": 4.0, "bagCapacity": 5,
+    "lootTypes": [{"value": 1}, {"value": 2}],
+    "roads": [{"x0": 0, "y0": 0, "y1": 10}],
+    "buildings": [],
+    "offices": []
+  }]
+})";
+
+std::string ErrorLocation(const std::string& text) {
+    try {
+        json_loader::ParseConfig(text);
+    } catch (const json_loader::ConfigError& error) {
+        return error.GetLocation();
+    }
+    return {};
+}
+
+std::string Replace(std::string text, const std::string& from,
+                    const std::string& to) {
+    text.replace(text.find(from), from.size(), to);
+    return text;
+}
+
+}  // namespace
+
+SCENARIO("Config loading") {
+    GIVEN("a valid config") {
+        WHEN("it is parsed") {
+            const auto config = json_loader::ParseConfig(VALID_CONFIG);
+
+            THEN("every object is built from the same document") {
+                const auto& maps = config.game->GetMaps();
+                REQUIRE(maps.size() == 2);
+                CHECK(*maps[0]->GetId() == "map1");
+                CHECK_FALSE(maps[0]->GetMaxSpeed().has_value());
+                CHECK(maps[1]->GetMaxSpeed() == 4.0);
+                CHECK(maps[1]->GetNumberOfLootTypes() == 1);
+                CHECK(config.game->GetDefaultDogSpeed() == 3.0);
+                CHECK(config.game->GetDogRetirementTime() == 15s);
+                CHECK(config.loot_handler->FindValueByLootType(
+                          model::Map::Id{"map2"s}, 1) == 2);
+                CHECK(config.loot_number_map_handler->GetMaxLootNumber(
+                          model::Map::Id{"map2"s}) == 5);
+                CHECK(config.loot_number_map_handler->GetMaxLootNumber(
+                          model::Map::Id{"map1"s}) == 3);
+                REQUIRE(config.rate_limits.per_token.has_value());
+                CHECK(config.rate_limits.per_token->rate == 20.0);
+                CHECK(config.rate_limits.per_token->burst == 40.0);
+                CHECK_FALSE(config.rate_limits.per_ip.has_value());
+                CHECK(config.rate_limits.max_api_queue == 500);
+            }
+        }
+
+        WHEN("it goes through the config cache") {
+            const auto cache_file = std::filesystem::temp_directory_path() /
+                                    "json_loader_tests.cache";
+            const auto hash = json_loader::HashConfig(VALID_CONFIG);
+            serialization::SaveConfigCache(
+                cache_file, hash, json_loader::ParseConfig(VALID_CONFIG));
+
+            THEN("the cache is only reused for the same config") {
+                CHECK_FALSE(
+                    serialization::LoadConfigCache(cache_file, hash + 1));
+
+                const auto config =
+                    serialization::LoadConfigCache(cache_file, hash);
+                REQUIRE(config.has_value());
+                const auto& maps = config->game->GetMaps();
+                REQUIRE(maps.size() == 2);
+                CHECK(maps[1]->GetRoads().size() == 1);
+                CHECK(maps[1]->GetMaxSpeed() == 4.0);
+                CHECK_FALSE(maps[0]->GetMaxSpeed().has_value());
+                CHECK(config->game->GetDogRetirementTime() == 15s);
+                CHECK(config->loot_handler->FindValueByLootType(
+                          model::Map::Id{"map1"s}, 0) == 10);
+                REQUIRE(config->rate_limits.per_token.has_value());
+                CHECK(config->rate_limits.per_token->burst == 40.0);
+                CHECK_FALSE(config->rate_limits.per_ip.has_value());
+                CHECK(config->rate_limits.max_api_queue == 500);
+            }
+            std::filesystem::remove(cache_file);
+        }
+    }
+
+    GIVEN("configs with mistakes") {
+        THEN("syntax errors point at the line and column") {
+            CHECK(ErrorLocation("{\n  \"maps\": [,]\n}") == "2:12");
+            CHECK(ErrorLocation("{} x") == "1:4");
+        }
+
+        THEN("schema errors point at the offending value") {
+            CHECK(ErrorLocation(Replace(VALID_CONFIG, R"("x0": 40, )", "")) ==
+                  "$.maps[0].roads[1]");
+            CHECK(ErrorLocation(Replace(VALID_CONFIG, R"("y1": 10)",
+                                        R"("y1": 10, "x1": 3)")) ==
+                  "$.maps[1].roads[0]");
+            CHECK(ErrorLocation(Replace(VALID_CONFIG, R"("w": 30)",
+                                        R"("w": 30.5)")) ==
+                  "$.maps[0].buildings[0].w");
+            CHECK(ErrorLocation(Replace(VALID_CONFIG, R"("probability": 0.5)",
+                                        R"("probability": 2)")) ==
+                  "$.lootGeneratorConfig.probability");
+            CHECK(ErrorLocation(Replace(VALID_CONFIG, R"("burst": 40)",
+                                        R"("burst": 0)")) ==
+                  "$.rateLimits.perToken.burst");
+            CHECK(ErrorLocation(Replace(VALID_CONFIG, R"("map2")",
+                                        R"("map1")")) == "$.maps[1].id");
+            CHECK(ErrorLocation(Replace(VALID_CONFIG,
+                                        R"("lootTypes": [{"value": 1}, )"
+                                        R"({"value": 2}])",
+                                        R"("lootTypes": [])")) ==
+                  "$.maps[1].lootTypes");
+        }
+    }
+}
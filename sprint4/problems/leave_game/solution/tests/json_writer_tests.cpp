@@ -0,0 +1,81 @@
+#include <catch2/catch_test_macros.hpp>
+#include <string>
+#include <vector>
+
+#include <boost/json.hpp>
+
+#include "json_converter.h"
+
+SCENARIO("Streaming JSON writer") {
+    GIVEN("a game state with players and lost objects") {
+        model::Item key{.id = model::Item::Id{7u},
+                        .type = 1,
+                        .position = {1.0, 2.5},
+                        .value = 10};
+        GameState state{
+            .player_coord_infos = {{.id = app::Player::Id{0u},
+                                    .position = {0.1, 1e-7},
+                                    .velocity = {-3.0, 0.0},
+                                    .direction = model::Direction::WEST,
+                                    .items = {key, key},
+                                    .score = 30},
+                                   {.id = app::Player::Id{3u},
+                                    .position = {123456.789, 2.0},
+                                    .velocity = {0.0, 0.0},
+                                    .direction = model::Direction::NONE,
+                                    .items = {},
+                                    .score = 0}},
+            .lost_objects = {key, {.type = 0, .position = {-0.5, 3.0}}}};
+
+        THEN("the output matches the serialized DOM byte for byte") {
+            CHECK(json_converter::Serialize(json_converter::WriteGameState,
+                                            state) ==
+                  boost::json::serialize(
+                      json_converter::GameStateToJson(state)));
+        }
+
+        AND_GIVEN("an empty game state") {
+            THEN("the output matches too") {
+                CHECK(json_converter::Serialize(json_converter::WriteGameState,
+                                                GameState{}) ==
+                      boost::json::serialize(
+                          json_converter::GameStateToJson(GameState{})));
+            }
+        }
+    }
+
+    GIVEN("player names that need escaping") {
+        const std::string quoted = "\"Rex\" \\ the\tdog\n";
+        std::vector<PlayerInfo> players{
+            {.id = app::Player::Id{0u}, .name = quoted},
+            {.id = app::Player::Id{1u}, .name = "Бобик"}};
+
+        THEN("the player list matches the serialized DOM") {
+            boost::json::array expected;
+            for (const auto& player : players) {
+                expected.push_back(json_converter::PlayerInfoToJson(player));
+            }
+            CHECK(json_converter::Serialize(json_converter::WritePlayerInfos,
+                                            players) ==
+                  boost::json::serialize(expected));
+        }
+
+        THEN("records match the serialized DOM") {
+            std::vector<GameRecord> records{{quoted, 12, 61.25},
+                                            {"Бобик", 0, 0.0}};
+            boost::json::array expected;
+            for (const auto& record : records) {
+                expected.push_back(json_converter::GameRecordToJson(record));
+            }
+            CHECK(json_converter::Serialize(json_converter::WriteGameRecords,
+                                            records) ==
+                  boost::json::serialize(expected));
+
+            GameRecordsPage page{.records = records, .next_cursor = "abc"};
+            CHECK(json_converter::Serialize(
+                      json_converter::WriteGameRecordsPage, page) ==
+                  boost::json::serialize(
+                      json_converter::GameRecordsPageToJson(page)));
+        }
+    }
+}
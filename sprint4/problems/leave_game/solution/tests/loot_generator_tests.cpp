@@ -76,4 +76,53 @@ SCENARIO("Loot generation") {
             }
         }
     }
+
+    GIVEN("loot generators with an inlined random policy") {
+        struct HalfRandom {
+            double operator()() const noexcept { return 0.5; }
+        };
+        loot_gen::BasicLootGenerator<HalfRandom> first{1s, 0.5, 0ms};
+        loot_gen::BasicLootGenerator<HalfRandom> second{1s, 0.5, 0ms};
+
+        WHEN("only one of them generates loot") {
+            const auto time_interval = std::chrono::duration_cast<TimeInterval>(
+                std::chrono::duration<double>{
+                    1.0 / (std::log(1 - 0.5) / std::log(1.0 - 0.25))});
+            CHECK(first.Generate(time_interval, 0, 4) == 0);
+            CHECK(first.Generate(time_interval, 0, 4) == 1);
+
+            THEN("the other keeps its own time without loot") {
+                CHECK(first.GetTimeWithoutLoot() == 0ms);
+                CHECK(second.GetTimeWithoutLoot() == 0ms);
+                CHECK(second.Generate(time_interval, 0, 4) == 0);
+                CHECK(second.GetTimeWithoutLoot() == time_interval);
+            }
+        }
+    }
+
+    GIVEN("session random sources") {
+        WHEN("the range is a single value") {
+            loot_gen::EngineRandom constant{1, 0.25, 0.25};
+            THEN("that value is returned") {
+                CHECK(constant() == 0.25);
+                CHECK(loot_gen::EngineRandom{}() == 1.0);
+            }
+        }
+
+        WHEN("the range is [0, 1]") {
+            loot_gen::EngineRandom first{1, 0.0, 1.0};
+            loot_gen::EngineRandom same{1, 0.0, 1.0};
+            loot_gen::EngineRandom other{2, 0.0, 1.0};
+            THEN("values stay in range and depend on the seed only") {
+                bool differs = false;
+                for (int i = 0; i < 100; ++i) {
+                    const double value = first();
+                    CHECK((0.0 <= value && value <= 1.0));
+                    CHECK(same() == value);
+                    differs = differs || other() != value;
+                }
+                CHECK(differs);
+            }
+        }
+    }
 }
@@ -0,0 +1,104 @@
+#include <catch2/catch_test_macros.hpp>
+#include <cstddef>
+#include <memory>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/strand.hpp>
+
+#include "utils/mpsc_queue.h"
+#include "utils/strand_inbox.h"
+
+namespace {
+
+constexpr int PRODUCERS = 4;
+constexpr int PER_PRODUCER = 10000;
+
+}  // namespace
+
+SCENARIO("MpscQueue") {
+    GIVEN("an empty queue") {
+        utils::MpscQueue<std::unique_ptr<int>> queue;
+
+        THEN("nothing is popped") {
+            CHECK_FALSE(queue.Pop());
+        }
+
+        WHEN("values are pushed") {
+            queue.Push(std::make_unique<int>(1));
+            queue.Push(std::make_unique<int>(2));
+
+            THEN("they are popped in order") {
+                auto first = queue.Pop();
+                auto second = queue.Pop();
+                REQUIRE(first);
+                REQUIRE(second);
+                CHECK(**first == 1);
+                CHECK(**second == 2);
+                CHECK_FALSE(queue.Pop());
+            }
+        }
+    }
+
+    GIVEN("several producer threads") {
+        utils::MpscQueue<std::pair<int, int>> queue;
+        {
+            std::vector<std::jthread> producers;
+            for (int producer = 0; producer < PRODUCERS; ++producer) {
+                producers.emplace_back([&queue, producer] {
+                    for (int i = 0; i < PER_PRODUCER; ++i) {
+                        queue.Push({producer, i});
+                    }
+                });
+            }
+        }
+
+        THEN("every value is popped once, in per producer order") {
+            std::vector<int> next(PRODUCERS, 0);
+            size_t popped = 0;
+            while (auto value = queue.Pop()) {
+                auto [producer, i] = *value;
+                CHECK(i == next[producer]);
+                next[producer] = i + 1;
+                ++popped;
+            }
+            CHECK(popped == PRODUCERS * PER_PRODUCER);
+        }
+    }
+}
+
+SCENARIO("StrandInbox") {
+    GIVEN("an inbox fed from several threads") {
+        boost::asio::io_context ioc;
+        auto strand = boost::asio::make_strand(ioc);
+        auto inbox = std::make_shared<
+            utils::StrandInbox<decltype(strand)>>(strand);
+
+        int ran = 0;
+        bool is_on_strand = true;
+        {
+            std::vector<std::jthread> producers;
+            for (int producer = 0; producer < PRODUCERS; ++producer) {
+                producers.emplace_back([&] {
+                    for (int i = 0; i < PER_PRODUCER; ++i) {
+                        inbox->Push([&] {
+                            is_on_strand = is_on_strand &&
+                                           strand.running_in_this_thread();
+                            ++ran;
+                        });
+                    }
+                });
+            }
+            std::jthread consumer([&ioc] { ioc.run(); });
+        }
+        ioc.restart();
+        ioc.run();
+
+        THEN("every task runs on the strand") {
+            CHECK(ran == PRODUCERS * PER_PRODUCER);
+            CHECK(is_on_strand);
+        }
+    }
+}
@@ -0,0 +1,73 @@
+#include <catch2/catch_test_macros.hpp>
+#include <algorithm>
+#include <vector>
+
+#include "app/collision_detector.h"
+#include "model/office_index.h"
+
+namespace {
+
+class GatherersOnly : public collision_detector::ItemGathererProvider {
+   public:
+    explicit GatherersOnly(std::vector<collision_detector::Gatherer> gatherers)
+        : gatherers_(std::move(gatherers)) {}
+
+    size_t ItemsCount() const override { return 0; }
+    collision_detector::Item GetItem(size_t /*idx*/) const override {
+        return {};
+    }
+    size_t GatherersCount() const override { return gatherers_.size(); }
+    collision_detector::Gatherer GetGatherer(size_t idx) const override {
+        return gatherers_.at(idx);
+    }
+
+   private:
+    std::vector<collision_detector::Gatherer> gatherers_;
+};
+
+model::Office MakeOffice(model::Coord x, model::Coord y) {
+    return model::Office{model::Office::Id{"o"}, {x, y}, {0, 0}};
+}
+
+}  // namespace
+
+SCENARIO("OfficeIndex") {
+    GIVEN("offices spread over a map") {
+        const model::OfficeIndex index({MakeOffice(0, 0), MakeOffice(5, 0),
+                                        MakeOffice(100, 100),
+                                        MakeOffice(1000, 3)});
+
+        THEN("a short segment sees only the offices near it") {
+            std::vector<model::OfficeIndex::Id> candidates;
+            index.ForEachCandidate(
+                {1.0, 0.0}, {4.0, 0.0}, 0.5,
+                [&](model::OfficeIndex::Id id) { candidates.push_back(id); });
+            std::sort(candidates.begin(), candidates.end());
+            CHECK(candidates == std::vector<model::OfficeIndex::Id>{0, 1});
+        }
+
+        THEN("gatherers hit offices on their way, in time order") {
+            const GatherersOnly provider({{{-1.0, 0.0}, {6.0, 0.0}, 0.3},
+                                          {{100.0, 90.0}, {100.0, 101.0}, 0.3},
+                                          {{500.0, 0.0}, {501.0, 0.0}, 0.3}});
+            const auto events =
+                collision_detector::FindOfficeEvents(provider, index, 0.25);
+            REQUIRE(events.size() == 3);
+            CHECK(events[0].item_id == 0);
+            CHECK(events[0].gatherer_id == 0);
+            CHECK(events[1].item_id == 1);
+            CHECK(events[2].item_id == 2);
+            CHECK(events[2].gatherer_id == 1);
+        }
+    }
+
+    GIVEN("a map without offices") {
+        const model::OfficeIndex index({});
+
+        THEN("nothing is found") {
+            const GatherersOnly provider({{{0.0, 0.0}, {10.0, 0.0}, 0.3}});
+            CHECK(collision_detector::FindOfficeEvents(provider, index, 0.25)
+                      .empty());
+        }
+    }
+}
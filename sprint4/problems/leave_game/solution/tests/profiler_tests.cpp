@@ -0,0 +1,74 @@
+#include <catch2/catch_test_macros.hpp>
+#include <sstream>
+
+#include "../src/utils/profiler.h"
+
+using namespace std::literals;
+
+SCENARIO("Profiler export") {
+    using namespace utils::profiler;
+
+    GIVEN("events of nested scopes recorded on one thread") {
+        const Clock::time_point origin{};
+        // Children are recorded before their parents, as ScopedTimer does
+        std::vector<ThreadEvents> threads{
+            {.thread_id = 0,
+             .events = {{"MovePlayers", origin + 1ms, 3ms, 1},
+                        {"GenerateLoot", origin + 5ms, 2ms, 1},
+                        {"Tick", origin, 10ms, 0}}}};
+
+        WHEN("collapsed stacks are written") {
+            std::stringstream out;
+            WriteCollapsedStacks(threads, out);
+
+            THEN("each stack gets its self time in microseconds") {
+                CHECK(out.str() ==
+                      "Tick 5000\n"
+                      "Tick;GenerateLoot 2000\n"
+                      "Tick;MovePlayers 3000\n");
+            }
+        }
+
+        WHEN("a chrome trace is written") {
+            std::stringstream out;
+            WriteChromeTrace(threads, out);
+
+            THEN("every event becomes a complete event") {
+                const auto trace = out.str();
+                CHECK(trace.find(R"({"name":"Tick","ph":"X","pid":1,)"
+                                 R"("tid":0,"ts":0,"dur":10000})") !=
+                      std::string::npos);
+                CHECK(trace.find(R"("name":"MovePlayers","ph":"X","pid":1,)"
+                                 R"("tid":0,"ts":1000,"dur":3000})") !=
+                      std::string::npos);
+            }
+        }
+    }
+
+    GIVEN("a running profiler") {
+        auto& profiler = Profiler::Instance();
+        profiler.Start();
+
+        WHEN("scoped timers are nested") {
+            {
+                ScopedTimer outer{"outer"};
+                ScopedTimer inner{"inner"};
+            }
+            profiler.Stop();
+            {
+                ScopedTimer ignored{"ignored"};
+            }
+
+            THEN("only scopes inside the capture are recorded") {
+                auto threads = profiler.Collect();
+                REQUIRE(threads.size() == 1);
+                const auto& events = threads.front().events;
+                REQUIRE(events.size() == 2);
+                CHECK(events[0].name == "inner");
+                CHECK(events[0].depth == 1);
+                CHECK(events[1].name == "outer");
+                CHECK(events[1].depth == 0);
+            }
+        }
+    }
+}
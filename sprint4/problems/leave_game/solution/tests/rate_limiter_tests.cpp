@@ -0,0 +1,52 @@
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <string>
+
+#include "utils/rate_limiter.h"
+
+using namespace std::literals;
+
+SCENARIO("RateLimiter") {
+    using Clock = utils::RateLimiter::Clock;
+    const auto start = Clock::now();
+
+    GIVEN("a limiter of 10 requests per second with bursts of 5") {
+        utils::RateLimiter limiter({.rate = 10.0, .burst = 5.0}, start);
+
+        THEN("a burst drains the bucket") {
+            for (int i = 0; i < 5; ++i) {
+                CHECK(limiter.TryAcquire("token", start));
+            }
+            CHECK_FALSE(limiter.TryAcquire("token", start));
+
+            AND_THEN("it refills at the configured rate") {
+                CHECK_FALSE(limiter.TryAcquire("token", start + 50ms));
+                CHECK(limiter.TryAcquire("token", start + 100ms));
+                CHECK_FALSE(limiter.TryAcquire("token", start + 100ms));
+                for (int i = 0; i < 5; ++i) {
+                    CHECK(limiter.TryAcquire("token", start + 10s));
+                }
+                CHECK_FALSE(limiter.TryAcquire("token", start + 10s));
+            }
+
+            AND_THEN("other keys keep their own buckets") {
+                CHECK(limiter.TryAcquire("other", start));
+            }
+        }
+    }
+
+    GIVEN("more keys than the table holds") {
+        utils::RateLimiter limiter({.rate = 1.0, .burst = 1.0}, start);
+        const size_t keys = utils::RateLimiter::SHARDS *
+                            utils::RateLimiter::SLOTS_PER_SHARD * 2;
+        for (size_t i = 0; i < keys; ++i) {
+            limiter.TryAcquire(std::to_string(i), start);
+        }
+
+        THEN("keys left alone long enough give their slots away") {
+            const auto later = start + 2s;
+            CHECK(limiter.TryAcquire("new", later));
+            CHECK_FALSE(limiter.TryAcquire("new", later));
+        }
+    }
+}
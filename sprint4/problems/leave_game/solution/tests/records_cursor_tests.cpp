@@ -0,0 +1,44 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "../src/app/records_cursor.h"
+
+using namespace std::literals;
+
+SCENARIO("Records cursor") {
+    GIVEN("a record key with a separator in the name") {
+        const postgres::RecordKey key{
+            .score = 42,
+            .time_in_game = "12.345",
+            .name = "Rex:the:dog",
+            .id = "3f2504e0-4f89-41d3-9a0c-0305e82c3301"};
+
+        WHEN("the key is encoded") {
+            const auto cursor = app::EncodeRecordsCursor(key);
+
+            THEN("the cursor is safe in a query string") {
+                CHECK(cursor.find_first_not_of(
+                          "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz"
+                          "0123456789-_") == std::string::npos);
+            }
+
+            THEN("decoding restores the key") {
+                auto decoded = app::DecodeRecordsCursor(cursor);
+                REQUIRE(decoded.has_value());
+                CHECK(decoded->score == key.score);
+                CHECK(decoded->time_in_game == key.time_in_game);
+                CHECK(decoded->name == key.name);
+                CHECK(decoded->id == key.id);
+            }
+        }
+    }
+
+    GIVEN("cursors a client could have forged") {
+        THEN("they are rejected") {
+            CHECK_FALSE(app::DecodeRecordsCursor("not a cursor").has_value());
+            CHECK_FALSE(app::DecodeRecordsCursor("AAAA").has_value());
+            // "1:x:id:name" passes base64 but not the key checks
+            CHECK_FALSE(
+                app::DecodeRecordsCursor("MTp4OmlkOm5hbWU").has_value());
+        }
+    }
+}
@@ -0,0 +1,101 @@
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "serialization/request_recording.h"
+
+using namespace std::literals;
+using serialization::RecordedRequest;
+using serialization::RecordedRoute;
+
+namespace {
+
+std::vector<RecordedRequest> ReadAll(const std::filesystem::path& path) {
+    serialization::RecordingReader reader(path);
+    std::vector<RecordedRequest> requests;
+    while (auto request = reader.Next()) {
+        requests.push_back(std::move(*request));
+    }
+    return requests;
+}
+
+}  // namespace
+
+SCENARIO("Request recording") {
+    GIVEN("a recording of a short session") {
+        const auto recording = std::filesystem::temp_directory_path() /
+                               "request_recording_tests.rec";
+        const app::Token rex{std::string(32, 'a')};
+        const app::Token bob{std::string(32, 'b')};
+        const app::Token stranger{std::string(32, 'c')};
+        {
+            serialization::RequestRecorder recorder(recording);
+            recorder.ListMaps();
+            recorder.GetMap(model::Map::Id{"map1"s});
+            recorder.Join(model::Map::Id{"map1"s}, rex);
+            recorder.Join(model::Map::Id{"nope"s}, std::nullopt);
+            recorder.Join(model::Map::Id{"map1"s}, bob);
+            recorder.Move(bob, model::Direction::WEST);
+            recorder.GetState(stranger);
+            recorder.ListPlayers(rex);
+            recorder.Tick(1500ms);
+            recorder.GetRecords(0, 20, "cursor"s);
+            recorder.GetRecords(10, 50, std::nullopt);
+        }
+
+        WHEN("it is read back") {
+            const auto requests = ReadAll(recording);
+
+            THEN("every request is restored with tokens pseudonymised") {
+                REQUIRE(requests.size() == 11);
+                CHECK(requests[0].route == RecordedRoute::Maps);
+                CHECK(requests[1].map_id == "map1");
+                CHECK(requests[2].player == 1);
+                CHECK(requests[3].player == RecordedRequest::NO_PLAYER);
+                CHECK(requests[3].map_id == "nope");
+                CHECK(requests[4].player == 2);
+                CHECK(requests[5].route == RecordedRoute::Action);
+                CHECK(requests[5].player == 2);
+                CHECK(requests[5].direction == model::Direction::WEST);
+                CHECK(requests[6].player == 3);
+                CHECK(requests[7].route == RecordedRoute::Players);
+                CHECK(requests[7].player == 1);
+                CHECK(requests[8].delta == 1500ms);
+                CHECK(requests[9].cursor == "cursor");
+                CHECK(requests[9].max_items == 20);
+                CHECK(requests[10].start == 10);
+                CHECK(requests[10].max_items == 50);
+                CHECK_FALSE(requests[10].cursor.has_value());
+            }
+
+            THEN("timestamps never go back") {
+                for (size_t i = 1; i < requests.size(); ++i) {
+                    CHECK(requests[i].time >= requests[i - 1].time);
+                }
+            }
+
+            THEN("tokens are not stored") {
+                std::ifstream input(recording, std::ios::binary);
+                const std::string data{std::istreambuf_iterator<char>(input),
+                                       std::istreambuf_iterator<char>()};
+                CHECK(data.find(*rex) == std::string::npos);
+            }
+        }
+
+        WHEN("the last record is cut off") {
+            std::filesystem::resize_file(
+                recording, std::filesystem::file_size(recording) - 1);
+
+            THEN("the records before it are still read") {
+                CHECK(ReadAll(recording).size() == 10);
+            }
+        }
+
+        std::filesystem::remove(recording);
+    }
+}
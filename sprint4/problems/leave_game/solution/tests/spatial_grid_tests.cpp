@@ -0,0 +1,70 @@
+#include <catch2/catch_test_macros.hpp>
+#include <vector>
+
+#include "app/game/spatial_grid.h"
+
+SCENARIO("SpatialGrid") {
+    using app::AreaOfInterest;
+    using app::SpatialGrid;
+    const auto identity = [](model::Coordinate point) { return point; };
+
+    GIVEN("points spread over a map") {
+        const std::vector<model::Coordinate> points = {
+            {0.0, 0.0}, {3.0, 4.0}, {50.0, 50.0}, {-20.0, 7.5}, {5.0, 0.0}};
+        SpatialGrid grid(4.0);
+        grid.Build(points, identity);
+
+        THEN("a radius query finds the points within it, in order") {
+            CHECK(grid.Query(AreaOfInterest::Around({0.0, 0.0}, 5.0)) ==
+                  std::vector<SpatialGrid::Index>{0, 1, 4});
+        }
+
+        THEN("the corners of the bounding square are outside a radius") {
+            CHECK(grid.Query(AreaOfInterest::Around({1.0, 1.0}, 3.5)) ==
+                  std::vector<SpatialGrid::Index>{0});
+        }
+
+        THEN("a viewport query takes its corners in any order") {
+            CHECK(grid.Query(AreaOfInterest::Viewport({60.0, 60.0},
+                                                      {-20.0, 5.0})) ==
+                  std::vector<SpatialGrid::Index>{2, 3});
+        }
+
+        THEN("an area off the points finds nothing") {
+            CHECK(grid.Query(AreaOfInterest::Around({500.0, 500.0}, 10.0))
+                      .empty());
+        }
+
+        WHEN("it is built again from other points") {
+            grid.Build(std::vector<model::Coordinate>{{100.0, 100.0}},
+                       identity);
+
+            THEN("only the new points are found") {
+                CHECK(grid.Query(AreaOfInterest::Around({0.0, 0.0}, 1e6)) ==
+                      std::vector<SpatialGrid::Index>{0});
+            }
+        }
+    }
+
+    GIVEN("points farther apart than the cell limit allows") {
+        const std::vector<model::Coordinate> points = {{0.0, 0.0},
+                                                       {1e7, 1e7}};
+        SpatialGrid grid(1.0);
+        grid.Build(points, identity);
+
+        THEN("cells grow and queries still find them") {
+            CHECK(grid.Query(AreaOfInterest::Around({1e7, 1e7}, 1.0)) ==
+                  std::vector<SpatialGrid::Index>{1});
+        }
+    }
+
+    GIVEN("no points") {
+        SpatialGrid grid;
+        grid.Build(std::vector<model::Coordinate>{}, identity);
+
+        THEN("queries find nothing") {
+            CHECK(grid.Query(AreaOfInterest::Around({0.0, 0.0}, 10.0))
+                      .empty());
+        }
+    }
+}
@@ -15,6 +15,37 @@ class MapWithOneRoad : public model::Map {
                      Buildings{}, Offices{}, 0.0, 0) {}
 };
 
+class MapWithTwoRoads : public model::Map {
+   public:
+    MapWithTwoRoads()
+        : model::Map(Id{""}, "",
+                     Roads{std::make_shared<model::Road>(
+                               model::Road::HORIZONTAL, model::Point{10, 0}, 0),
+                           std::make_shared<model::Road>(
+                               model::Road::VERTICAL, model::Point{0, 0}, 4)},
+                     Buildings{}, Offices{}, 0.0, 0) {}
+};
+
+SCENARIO("road points") {
+    GIVEN("map with reversed horizontal and vertical roads") {
+        MapWithTwoRoads map;
+
+        THEN("every integer point of every road is counted") {
+            CHECK(map.GetRoadPointsCount() == 16);
+        }
+
+        THEN("indices are mapped along the roads from their starts") {
+            CHECK(map.GetRoadPoint(0).x == 10);
+            CHECK(map.GetRoadPoint(3).x == 7);
+            CHECK(map.GetRoadPoint(10).x == 0);
+            CHECK(map.GetRoadPoint(10).y == 0);
+            CHECK(map.GetRoadPoint(11).x == 0);
+            CHECK(map.GetRoadPoint(11).y == 0);
+            CHECK(map.GetRoadPoint(15).y == 4);
+        }
+    }
+}
+
 SCENARIO("spawnpoint tests") {
     GIVEN("random spawnpoint generator") {
         SpawnPointGenerator generator;
@@ -50,6 +81,27 @@ SCENARIO("spawnpoint tests") {
         }
     }
 
+    GIVEN("random spawnpoint generators with the same seed") {
+        SpawnPointGenerator generator(true, 42);
+        SpawnPointGenerator same_generator(true, 42);
+        MapWithTwoRoads map;
+
+        WHEN("a batch of points is generated") {
+            std::vector<model::Coordinate> points;
+            generator.Generate(map, 100, points);
+
+            THEN("points lie on roads and repeat for the same seed") {
+                REQUIRE(points.size() == 100);
+                for (const auto& point : points) {
+                    auto same_point = same_generator.Generate(map);
+                    CHECK(point.x == same_point.x);
+                    CHECK(point.y == same_point.y);
+                    CHECK(!map.FindRoads(point).empty());
+                }
+            }
+        }
+    }
+
     GIVEN("fixed spawnpoint generator") {
         SpawnPointGenerator generator(false);
 
@@ -3,6 +3,7 @@
 #include <catch2/matchers/catch_matchers_vector.hpp>
 #include <deque>
 #include <memory>
+#include <ranges>
 #include <sstream>
 
 #include <boost/archive/text_iarchive.hpp>
@@ -71,8 +72,7 @@ void CheckDogEquality(const model::Dog& actual, const model::Dog& expected) {
     CHECK(actual.GetVelocity() == expected.GetVelocity());
     CHECK(actual.GetItemCount() == expected.GetItemCount());
 
-    REQUIRE_THAT(actual.GetItems(),
-                 Catch::Matchers::Equals(expected.GetItems()));
+    REQUIRE(actual.GetItems() == expected.GetItems());
 }
 
 void CheckDogsEqualityDeque(const std::deque<model::Dog>& actual,
@@ -124,11 +124,11 @@ void CheckPlayerEquality(const app::Player& actual,
     CheckGameSessionEquality(*actual.GetSession(), *expected.GetSession());
 }
 
-void CheckPlayersDequeEquality(const std::deque<app::Player>& actual,
-                               const std::deque<app::Player>& expected) {
-    CHECK(actual.size() == expected.size());
-    for (size_t i = 0; i < actual.size(); i++) {
-        CheckPlayerEquality(actual[i], expected[i]);
+void CheckPlayersEquality(app::PlayersCollection::PlayersView actual,
+                          app::PlayersCollection::PlayersView expected) {
+    REQUIRE(std::ranges::distance(actual) == std::ranges::distance(expected));
+    for (auto it = expected.begin(); const auto& player : actual) {
+        CheckPlayerEquality(player, *it++);
     }
 }
 
@@ -584,9 +584,8 @@ SCENARIO_METHOD(Fixture, "Players serialization") {
                             return game_session;
                         });
 
-                CheckPlayersDequeEquality(
-                    deserialized_players_ptr->GetPlayers(),
-                    players.GetPlayers());
+                CheckPlayersEquality(deserialized_players_ptr->GetPlayers(),
+                                     players.GetPlayers());
                 CheckPlayerEquality(*deserialized_players_ptr->Find(token),
                                     *players.Find(token));
                 CheckPlayerEquality(
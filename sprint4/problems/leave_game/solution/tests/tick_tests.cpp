@@ -1,15 +1,21 @@
 #include <catch2/catch_test_macros.hpp>
 #include <chrono>
+#include <cstdint>
+#include <functional>
 #include <memory>
 #include <ratio>
+#include <vector>
 
+#include "app/game/game.h"
 #include "app/player/player.h"
 #include "app/player/players.h"
 #include "app/use_cases/game_tick_use_case.h"
 #include "data/test_games_data.h"
 #include "data/test_players_data.h"
 #include "loots/loot_generator.h"
+#include "loots/loot_handler.h"
 #include "loots/loot_number_map_handler.h"
+#include "model/map.h"
 #include "utils/logger.h"
 
 SCENARIO("Tick tests") {
@@ -60,3 +66,86 @@ SCENARIO("Tick tests") {
         }
     }
 }
+
+SCENARIO("Loot generation uses the configured random source") {
+    using namespace std::literals;
+
+    auto map = std::make_shared<model::Map>(
+        model::Map::Id{"map"}, "map",
+        model::Map::Roads{std::make_shared<model::Road>(
+            model::Road::HORIZONTAL, model::Point{0, 0}, 40)},
+        model::Map::Buildings{}, model::Map::Offices{}, 1.0, 3);
+    auto game = std::make_shared<app::Game>(
+        app::Game::Maps{map}, 1.0, std::make_shared<app::GameSessionHandler>());
+    auto session = game->CreateGameSession(map->GetId());
+    auto players = std::make_shared<app::Players>();
+    for (int i = 0; i < 4; ++i) {
+        players->Add(session, session->AddDog({0.0, 0.0}, "dog", 1.0));
+    }
+    // The use case owns a memory resource and can't be moved
+    const auto make_use_case = [&](loot_gen::SessionRandomFactory random) {
+        auto use_case = std::make_unique<GameTickUseCase>(
+            game, players,
+            std::make_shared<loot_gen::LootGenerator>(1s, 1.0, 0ms),
+            std::make_shared<LootHandler>(
+                LootHandler::LootTypeByMap{},
+                LootHandler::LootTypeScoreByMap{{map->GetId(), {1, 2, 3}}}),
+            std::make_shared<LootNumberMapHandler>(
+                LootNumberMapHandler::LootNumberByMap{}, 3),
+            nullptr, true, 42, std::move(random));
+        use_case->SetWriteRetired(false);
+        return use_case;
+    };
+    const auto constant = [](double value) {
+        return [value](std::uint64_t seed) {
+            return loot_gen::EngineRandom{seed, value, value};
+        };
+    };
+
+    GIVEN("a source that always returns zero") {
+        auto use_case = make_use_case(constant(0.0));
+
+        THEN("no loot appears") {
+            use_case->Tick(1s);
+            CHECK(session->GetLootNumber() == 0);
+        }
+    }
+
+    GIVEN("a source that returns a half") {
+        auto use_case = make_use_case(constant(0.5));
+
+        THEN("half of the missing loot appears") {
+            use_case->Tick(1s);
+            CHECK(session->GetLootNumber() == 2);
+        }
+    }
+
+    GIVEN("two sessions on the same map") {
+        game->CreateGameSession(map->GetId());
+        std::vector<std::uint64_t> seeds;
+        const auto record_seeds = [&seeds](std::uint64_t seed) {
+            seeds.push_back(seed);
+            return loot_gen::EngineRandom{seed, 0.0, 1.0};
+        };
+        auto use_case = make_use_case(record_seeds);
+        use_case->Tick(1ms);
+
+        THEN("each session gets its own random stream") {
+            REQUIRE(seeds.size() == 2);
+            CHECK(seeds[0] != seeds[1]);
+        }
+
+        AND_WHEN("the random state is reset with the same seed twice") {
+            const auto timers = use_case->GetLootTimers();
+            seeds.clear();
+            use_case->ResetRandomState(7, timers);
+            const auto first = seeds;
+            seeds.clear();
+            use_case->ResetRandomState(7, timers);
+
+            THEN("the sessions get the same streams again") {
+                CHECK(seeds == first);
+            }
+        }
+    }
+}
@@ -0,0 +1,109 @@
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <boost/asio/io_context.hpp>
+
+#include "utils/ticker.h"
+
+using namespace std::literals;
+
+namespace {
+
+constexpr auto PERIOD = 10ms;
+
+// Runs a ticker until the handler was called calls times. The first tick
+// overruns by sleeping for several periods.
+struct TickerRun {
+    std::vector<std::chrono::milliseconds> deltas;
+    utils::TickerStats stats;
+};
+
+TickerRun RunTicker(utils::CatchUpPolicy policy, size_t calls,
+                    bool is_throwing = false) {
+    boost::asio::io_context ioc;
+    TickerRun run;
+    std::shared_ptr<utils::Ticker> ticker;
+    ticker = std::make_shared<utils::Ticker>(
+        boost::asio::make_strand(ioc), PERIOD,
+        [&](std::chrono::milliseconds delta) {
+            run.deltas.push_back(delta);
+            if (run.deltas.size() == calls) {
+                ticker->Stop();
+            }
+            if (run.deltas.size() == 1) {
+                std::this_thread::sleep_for(PERIOD * 3.5);
+            }
+            if (is_throwing) {
+                throw std::runtime_error("tick failed");
+            }
+        },
+        policy);
+    ticker->Start();
+    ioc.run();
+    run.stats = ticker->GetStats();
+    return run;
+}
+
+}  // namespace
+
+SCENARIO("Ticker") {
+    GIVEN("a tick that overruns several periods") {
+        WHEN("missed periods are merged") {
+            auto run = RunTicker(utils::CatchUpPolicy::Merge, 4);
+
+            THEN("the next tick covers them") {
+                REQUIRE(run.deltas.size() == 4);
+                CHECK(run.deltas[0] == PERIOD);
+                CHECK(run.deltas[1] >= PERIOD * 3);
+                for (auto delta : run.deltas) {
+                    CHECK(delta.count() % PERIOD.count() == 0);
+                }
+                CHECK(run.stats.ticks == 4);
+                CHECK(run.stats.overruns >= 1);
+                CHECK(run.stats.late_periods >= 2);
+                CHECK(run.stats.dropped_periods == 0);
+                CHECK(run.stats.handler_duration.Count() == 4);
+            }
+        }
+
+        WHEN("missed periods are skipped") {
+            auto run = RunTicker(utils::CatchUpPolicy::Skip, 4);
+
+            THEN("every tick is one period and the rest is dropped") {
+                REQUIRE(run.deltas.size() == 4);
+                for (auto delta : run.deltas) {
+                    CHECK(delta == PERIOD);
+                }
+                CHECK(run.stats.dropped_periods >= 2);
+            }
+        }
+
+        WHEN("missed periods are sub-stepped") {
+            auto run = RunTicker(utils::CatchUpPolicy::SubStep, 4);
+
+            THEN("each of them gets a tick of its own") {
+                REQUIRE(run.deltas.size() == 4);
+                for (auto delta : run.deltas) {
+                    CHECK(delta == PERIOD);
+                }
+                CHECK(run.stats.ticks == 4);
+                CHECK(run.stats.dropped_periods == 0);
+                CHECK(run.stats.handler_duration.Count() <
+                      run.stats.ticks);
+            }
+        }
+    }
+
+    GIVEN("a handler that throws") {
+        auto run = RunTicker(utils::CatchUpPolicy::Merge, 3, true);
+
+        THEN("failures are counted and ticking goes on") {
+            CHECK(run.deltas.size() == 3);
+            CHECK(run.stats.failures == 3);
+        }
+    }
+}
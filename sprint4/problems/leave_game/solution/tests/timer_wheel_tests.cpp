@@ -0,0 +1,66 @@
+#include <catch2/catch_test_macros.hpp>
+#include <vector>
+
+#include "utils/timer_wheel.h"
+
+SCENARIO("TimerWheel") {
+    using Wheel = utils::TimerWheel<int>;
+
+    GIVEN("a wheel with entries on several levels") {
+        Wheel wheel;
+        const std::vector<Wheel::Time> deadlines = {
+            1, 63, 64, 65, 4095, 4096, 300000, 1ull << 40};
+        for (size_t i = 0; i < deadlines.size(); ++i) {
+            wheel.Schedule(deadlines[i], static_cast<int>(i));
+        }
+
+        THEN("each entry fires on the advance that reaches its deadline") {
+            std::vector<int> fired;
+            const auto collect = [&fired](int value) {
+                fired.push_back(value);
+            };
+            for (size_t i = 0; i < deadlines.size(); ++i) {
+                wheel.Advance(deadlines[i] - 1, collect);
+                CHECK(fired.size() == i);
+                wheel.Advance(deadlines[i], collect);
+                REQUIRE(fired.size() == i + 1);
+                CHECK(fired.back() == static_cast<int>(i));
+            }
+            CHECK(wheel.GetSize() == 0);
+        }
+    }
+
+    GIVEN("an entry that reschedules itself when it fires") {
+        Wheel wheel;
+        wheel.Schedule(10, 0);
+        std::vector<Wheel::Time> fire_times;
+
+        WHEN("the clock jumps far ahead in big steps") {
+            for (Wheel::Time now = 1000; now <= 5000; now += 1000) {
+                wheel.Advance(now, [&](int value) {
+                    fire_times.push_back(wheel.GetTime());
+                    wheel.Schedule(wheel.GetTime() + 700, value);
+                });
+            }
+
+            THEN("it fires at every deadline on the way") {
+                CHECK(fire_times ==
+                      std::vector<Wheel::Time>{10, 710, 1410, 2110, 2810,
+                                               3510, 4210, 4910});
+                CHECK(wheel.GetSize() == 1);
+            }
+        }
+    }
+
+    GIVEN("an entry scheduled in the past") {
+        Wheel wheel(100);
+        wheel.Schedule(50, 7);
+
+        THEN("it fires on the next advance without moving the clock") {
+            int fired = 0;
+            wheel.Advance(100, [&fired](int value) { fired = value; });
+            CHECK(fired == 7);
+            CHECK(wheel.GetTime() == 100);
+        }
+    }
+}
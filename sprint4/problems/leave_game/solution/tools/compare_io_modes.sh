@@ -0,0 +1,33 @@
+#!/usr/bin/env bash
+# Runs loadgen against game_server with a shared io_context and then with
+# --io-per-core, printing one loadgen report per mode.
+#
+# Usage: tools/compare_io_modes.sh <build dir> [loadgen options...]
+# THREADS, CONNECTIONS, RATE and DURATION override the load, 16 loadgen
+# threads, 256 connections, 20000 requests/s for 20 s by default. The
+# server needs GAME_DB_URL like any other run.
+
+set -euo pipefail
+
+build_dir=${1:?usage: $0 <build dir> [loadgen options...]}
+shift
+root=$(cd "$(dirname "$0")/.." && pwd)
+
+run_mode() {
+    local mode=$1
+    shift
+    "$build_dir/game_server" --config-file "$root/data/config.json" \
+        --www-root "$root/static" --tick-period 50 "$@" >/dev/null &
+    local server=$!
+    sleep 2
+    echo "$mode:"
+    "$build_dir/loadgen" --threads "${THREADS:-16}" \
+        --connections "${CONNECTIONS:-256}" --rate "${RATE:-20000}" \
+        --duration "${DURATION:-20}" "${loadgen_args[@]}"
+    kill -INT "$server"
+    wait "$server" || true
+}
+
+loadgen_args=("$@")
+run_mode shared
+run_mode per-core --io-per-core
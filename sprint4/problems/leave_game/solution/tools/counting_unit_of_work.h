@@ -0,0 +1,71 @@
+#pragma once
+
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "postgres/unit_of_work.h"
+
+namespace tools {
+
+// Retired players are only counted, tools must not touch a database
+class CountingPlayerRepository : public postgres::PlayerRepository {
+   public:
+    explicit CountingPlayerRepository(size_t& written) : written_(written) {}
+
+    void Write([[maybe_unused]] const postgres::PlayerInfo& player)
+        const override {
+        ++written_;
+    }
+
+    void WriteAll(
+        const std::vector<postgres::PlayerInfo>& players) const override {
+        written_ += players.size();
+    }
+
+    std::vector<postgres::PlayerInfo> Read(
+        [[maybe_unused]] int count,
+        [[maybe_unused]] int max_items) const override {
+        return {};
+    }
+
+    postgres::RecordsPage ReadAfter(
+        [[maybe_unused]] const std::optional<postgres::RecordKey>& after,
+        [[maybe_unused]] int max_items) const override {
+        return {};
+    }
+
+   private:
+    size_t& written_;
+};
+
+class CountingUnitOfWork : public postgres::UnitOfWork {
+   public:
+    explicit CountingUnitOfWork(size_t& written) : players_(written) {}
+
+    void Commit() override {}
+    postgres::PlayerRepository& GetPlayers() override { return players_; }
+
+   private:
+    CountingPlayerRepository players_;
+};
+
+class CountingUnitOfWorkFactory : public postgres::UnitOfWorkFactory {
+   public:
+    std::unique_ptr<postgres::UnitOfWork> CreateUnitOfWork() override {
+        return std::make_unique<CountingUnitOfWork>(retired_);
+    }
+
+    // Tools run single-threaded, so the handler is called right away and
+    // the count is up to date when the tick returns
+    void AsyncCreateUnitOfWork(UnitOfWorkHandler handler) override {
+        handler(nullptr, CreateUnitOfWork());
+    }
+
+    size_t GetRetiredCount() const noexcept { return retired_; }
+
+   private:
+    size_t retired_ = 0;
+};
+
+}  // namespace tools
@@ -0,0 +1,260 @@
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <optional>
+#include <pqxx/pqxx>
+#include <string>
+#include <vector>
+
+#include <boost/json.hpp>
+#include <boost/program_options.hpp>
+#include <boost/uuid/random_generator.hpp>
+#include <boost/uuid/uuid_io.hpp>
+
+#include "postgres/repository_impl.h"
+#include "postgres/unit_of_work_impl.h"
+
+// Measures retired player inserts per second against the database from
+// GAME_DB_URL, then checks that a records page deep inside a group of equal
+// scores reads only about a page of rows. Rows written by the bench are
+// deleted afterwards.
+
+namespace {
+
+using namespace std::literals;
+using pqxx::operator"" _zv;
+using Clock = std::chrono::steady_clock;
+
+constexpr auto NAME_PREFIX = "db_insert_bench_"sv;
+
+struct BenchArgs {
+    int inserts_count = 10000;
+    int batch_size = 16;
+    int tie_group_size = 100000;
+    int page_size = 100;
+};
+
+std::optional<BenchArgs> ParseBenchArgs(int argc, const char* argv[]) {
+    namespace po = boost::program_options;
+
+    BenchArgs args;
+    po::options_description desc("All options");
+    desc.add_options()("help,h", "produce help message")(
+        "inserts,n", po::value(&args.inserts_count)->default_value(10000),
+        "number of rows inserted by every mode")(
+        "batch,b", po::value(&args.batch_size)->default_value(16),
+        "rows per transaction in the pipelined mode")(
+        "tie-group,t", po::value(&args.tie_group_size)->default_value(100000),
+        "rows sharing one score in the records page check")(
+        "page,p", po::value(&args.page_size)->default_value(100),
+        "records page size in the records page check");
+
+    po::variables_map vm;
+    po::store(po::parse_command_line(argc, argv, desc), vm);
+    po::notify(vm);
+
+    if (vm.count("help")) {
+        std::cout << desc << std::endl;
+        return std::nullopt;
+    }
+
+    if (args.inserts_count <= 0 || args.batch_size <= 0 ||
+        args.page_size <= 0 || args.tie_group_size <= args.page_size) {
+        throw std::invalid_argument("Bench sizes must be positive"s);
+    }
+
+    return args;
+}
+
+postgres::PlayerInfo MakePlayerInfo(int index) {
+    return {.name = std::string(NAME_PREFIX) + std::to_string(index),
+            .score = index % 100,
+            .time_in_game = index * 0.5};
+}
+
+// The repository as it was before statements were prepared: every insert
+// parses its query and seeds a new uuid generator
+void RunBaseline(pqxx::connection& conn, int count) {
+    for (int i = 0; i < count; ++i) {
+        auto info = MakePlayerInfo(i);
+        pqxx::work work{conn};
+        work.exec_params(
+            "INSERT INTO retired_players (id, name, score, time_in_game) "
+            "VALUES ($1, $2, $3, $4);"_zv,
+            to_string(boost::uuids::random_generator()()), info.name,
+            info.score, info.time_in_game);
+        work.commit();
+    }
+}
+
+void RunPrepared(pqxx::connection& conn, int count) {
+    for (int i = 0; i < count; ++i) {
+        pqxx::work work{conn};
+        postgres::PlayerRepositoryImpl{work}.Write(MakePlayerInfo(i));
+        work.commit();
+    }
+}
+
+void RunPipelined(pqxx::connection& conn, int count, int batch_size) {
+    std::vector<postgres::PlayerInfo> batch;
+    batch.reserve(batch_size);
+    for (int i = 0; i < count;) {
+        batch.clear();
+        for (; i < count && static_cast<int>(batch.size()) < batch_size;
+             ++i) {
+            batch.push_back(MakePlayerInfo(i));
+        }
+        pqxx::work work{conn};
+        postgres::PlayerRepositoryImpl{work}.WriteAll(batch);
+        work.commit();
+    }
+}
+
+void Cleanup(pqxx::connection& conn) {
+    pqxx::work work{conn};
+    work.exec_params("DELETE FROM retired_players WHERE name LIKE $1;"_zv,
+                     std::string(NAME_PREFIX) + "%");
+    work.commit();
+}
+
+// Rows read by the scans of an EXPLAIN ANALYZE plan, the ones filtered out
+// after being read included
+double CountScannedRows(const boost::json::object& plan) {
+    double rows = 0;
+    if (plan.at("Node Type").as_string().ends_with("Scan")) {
+        rows += plan.at("Actual Rows").to_number<double>() *
+                plan.at("Actual Loops").to_number<double>();
+        if (const auto* removed = plan.if_contains("Rows Removed by Filter")) {
+            rows += removed->to_number<double>();
+        }
+    }
+    if (const auto* children = plan.if_contains("Plans")) {
+        for (const auto& child : children->as_array()) {
+            rows += CountScannedRows(child.as_object());
+        }
+    }
+    return rows;
+}
+
+// Every row of the group has score 0 and the same time in game, the most
+// common case of retired players. The page starts one page before the end
+// of the group, where a scan starting at the first row of the score would
+// read the whole group.
+boost::json::object CheckTieGroupPage(pqxx::connection& conn, int group_size,
+                                      int page_size) {
+    std::vector<postgres::PlayerInfo> batch;
+    batch.reserve(group_size);
+    for (int i = 0; i < group_size; ++i) {
+        batch.push_back({.name = std::string(NAME_PREFIX) + std::to_string(i),
+                         .score = 0,
+                         .time_in_game = 0.0});
+    }
+    {
+        pqxx::work work{conn};
+        postgres::PlayerRepositoryImpl{work}.WriteAll(batch);
+        work.commit();
+    }
+
+    pqxx::work work{conn};
+    work.exec("ANALYZE retired_players;"_zv);
+    const auto cursor = work.exec_params1(
+        "SELECT id, name, time_in_game FROM retired_players "
+        "WHERE score = 0 AND name LIKE $1 "
+        "ORDER BY time_in_game, name, id OFFSET $2 LIMIT 1;"_zv,
+        std::string(NAME_PREFIX) + "%", group_size - page_size - 1);
+    const postgres::RecordKey after{.score = 0,
+                                    .time_in_game = cursor[2].c_str(),
+                                    .name = cursor[1].as<std::string>(),
+                                    .id = cursor[0].as<std::string>()};
+
+    const auto start = Clock::now();
+    const auto page =
+        postgres::PlayerRepositoryImpl{work}.ReadAfter(after, page_size);
+    const auto seconds =
+        std::chrono::duration<double>(Clock::now() - start).count();
+
+    // The statement prepared by PlayerRepositoryImpl for pages after a
+    // cursor, run with the page size plus the row that tells about a next
+    // page
+    const auto explain = work.exec1(
+        "EXPLAIN (ANALYZE, FORMAT JSON) EXECUTE "
+        "select_retired_players_after(" +
+        work.quote(after.score) + ", " + work.quote(after.time_in_game) +
+        ", " + work.quote(after.name) + ", " + work.quote(after.id) + ", " +
+        work.quote(page_size + 1) + ");");
+    const auto plan = boost::json::parse(explain[0].c_str())
+                          .as_array()
+                          .at(0)
+                          .as_object()
+                          .at("Plan")
+                          .as_object();
+    const double scanned = CountScannedRows(plan);
+    work.abort();
+    Cleanup(conn);
+
+    // Each branch of the query reads at most one page and the extra row
+    if (scanned > 2.0 * (page_size + 1)) {
+        throw std::runtime_error(
+            "Records page inside a tie group read " +
+            std::to_string(static_cast<long long>(scanned)) +
+            " rows, the keyset query does not seek to the cursor");
+    }
+    return {{"groupSize", group_size},
+            {"pageSize", page_size},
+            {"pageRows", page.players.size()},
+            {"seconds", seconds},
+            {"scannedRows", scanned}};
+}
+
+template <typename Fn>
+boost::json::object Measure(pqxx::connection& conn, int count, Fn&& fn) {
+    const auto start = Clock::now();
+    fn();
+    const auto seconds =
+        std::chrono::duration<double>(Clock::now() - start).count();
+    Cleanup(conn);
+    return {{"inserts", count},
+            {"seconds", seconds},
+            {"insertsPerSecond", seconds > 0 ? count / seconds : 0.0}};
+}
+
+boost::json::object RunBench(const BenchArgs& args) {
+    const auto* url = std::getenv("GAME_DB_URL");
+    if (!url) {
+        throw std::runtime_error("Missing GAME_DB_URL environment variable");
+    }
+
+    pqxx::connection conn{url};
+    postgres::MigrateSchema(conn);
+    postgres::PlayerRepositoryImpl::PrepareStatements(conn);
+    Cleanup(conn);
+
+    const int count = args.inserts_count;
+    return boost::json::object{
+        {"batchSize", args.batch_size},
+        {"baseline",
+         Measure(conn, count, [&] { RunBaseline(conn, count); })},
+        {"prepared",
+         Measure(conn, count, [&] { RunPrepared(conn, count); })},
+        {"pipelined", Measure(conn, count, [&] {
+             RunPipelined(conn, count, args.batch_size);
+         })},
+        {"tieGroupPage",
+         CheckTieGroupPage(conn, args.tie_group_size, args.page_size)}};
+}
+
+}  // namespace
+
+int main(int argc, const char* argv[]) {
+    try {
+        auto args = ParseBenchArgs(argc, argv);
+        if (!args) {
+            return EXIT_SUCCESS;
+        }
+        std::cout << boost::json::serialize(RunBench(*args)) << std::endl;
+    } catch (const std::exception& ex) {
+        std::cerr << ex.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
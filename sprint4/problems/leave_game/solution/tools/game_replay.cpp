@@ -0,0 +1,246 @@
+#include <array>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <boost/json.hpp>
+#include <boost/program_options.hpp>
+
+#include "app/application.h"
+#include "counting_unit_of_work.h"
+#include "json_loader.h"
+#include "serialization/request_recording.h"
+#include "utils/latency_histogram.h"
+
+namespace {
+
+using namespace std::literals;
+using Clock = std::chrono::steady_clock;
+using serialization::RecordedRequest;
+using serialization::RecordedRoute;
+
+struct ReplayArgs {
+    std::string config_file;
+    std::string recording;
+    bool as_fast_as_possible = false;
+    bool is_random_spawn_point = false;
+    std::uint64_t seed = 42;
+};
+
+std::optional<ReplayArgs> ParseReplayArgs(int argc, const char* argv[]) {
+    namespace po = boost::program_options;
+
+    ReplayArgs args;
+    po::options_description desc("All options");
+    desc.add_options()("help,h", "produce help message")(
+        "config-file,c", po::value(&args.config_file)->value_name("file"s),
+        "config the recording was made with")(
+        "recording,r", po::value(&args.recording)->value_name("file"s),
+        "file written by game_server --record")(
+        "fast", po::bool_switch(&args.as_fast_as_possible),
+        "replay as fast as possible instead of at the recorded speed")(
+        "randomize-spawn-points", po::bool_switch(&args.is_random_spawn_point),
+        "spawn dogs at random positions")(
+        "seed", po::value(&args.seed)->default_value(args.seed),
+        "seed for spawn points and loot generation");
+
+    po::variables_map vm;
+    po::store(po::parse_command_line(argc, argv, desc), vm);
+    po::notify(vm);
+
+    if (vm.count("help")) {
+        std::cout << desc << std::endl;
+        return std::nullopt;
+    }
+
+    if (!vm.count("config-file") || !vm.count("recording")) {
+        throw std::invalid_argument("Config file and recording must be set"s);
+    }
+
+    return args;
+}
+
+constexpr size_t ROUTES_COUNT =
+    static_cast<size_t>(RecordedRoute::Records) + 1;
+
+struct RouteStats {
+    // Time spent in the application
+    utils::LatencyHistogram service;
+    // Measured from the recorded arrival time, so it includes the wait
+    // behind slower earlier requests. Only kept at the recorded speed.
+    utils::LatencyHistogram corrected;
+    std::uint64_t errors = 0;
+};
+
+boost::json::object HistogramToJson(const utils::LatencyHistogram& histogram) {
+    auto ms = [](utils::LatencyHistogram::Duration value) {
+        return std::chrono::duration<double, std::milli>(value).count();
+    };
+    return boost::json::object{
+        {"count", histogram.Count()},
+        {"mean", ms(histogram.Mean())},
+        {"p50", ms(histogram.ValueAtPercentile(50))},
+        {"p90", ms(histogram.ValueAtPercentile(90))},
+        {"p99", ms(histogram.ValueAtPercentile(99))},
+        {"p99.9", ms(histogram.ValueAtPercentile(99.9))},
+        {"max", ms(histogram.Max())}};
+}
+
+// Drives the application with recorded requests, the way ApiHandler would
+// have called it
+class Replayer {
+   public:
+    explicit Replayer(app::Application& app) : app_(app) {}
+
+    // Returns false when the application rejected the request
+    bool Apply(const RecordedRequest& request) {
+        try {
+            switch (request.route) {
+                case RecordedRoute::Maps:
+                    app_.ListMaps();
+                    break;
+                case RecordedRoute::Map:
+                    app_.GetMap(model::Map::Id{request.map_id});
+                    break;
+                case RecordedRoute::Join:
+                    Join(request);
+                    break;
+                case RecordedRoute::Players:
+                    app_.ListPlayers(GetToken(request.player));
+                    break;
+                case RecordedRoute::State:
+                    app_.GetGameState(GetToken(request.player));
+                    break;
+                case RecordedRoute::Action:
+                    app_.MovePlayer(GetToken(request.player),
+                                    request.direction);
+                    break;
+                case RecordedRoute::Tick:
+                    app_.Tick(request.delta);
+                    break;
+                case RecordedRoute::Records:
+                    if (request.cursor) {
+                        app_.GetGameRecordsPage(*request.cursor,
+                                                request.max_items);
+                    } else {
+                        app_.GetGameRecords(request.start, request.max_items);
+                    }
+                    break;
+            }
+        } catch (const UseCaseError&) {
+            return false;
+        }
+        return true;
+    }
+
+   private:
+    void Join(const RecordedRequest& request) {
+        auto result =
+            app_.JoinGame(model::Map::Id{request.map_id},
+                          "player_" + std::to_string(request.player));
+        if (request.player == RecordedRequest::NO_PLAYER) {
+            return;
+        }
+        if (tokens_.size() <= request.player) {
+            tokens_.resize(request.player + 1, UNKNOWN_TOKEN);
+        }
+        tokens_[request.player] = result.token;
+    }
+
+    // Players that never joined in the recording used invalid tokens
+    const app::Token& GetToken(std::uint32_t player) const {
+        return player < tokens_.size() ? tokens_[player] : UNKNOWN_TOKEN;
+    }
+
+    inline static const app::Token UNKNOWN_TOKEN{
+        std::string(app::token::SIZE, '0')};
+
+    app::Application& app_;
+    std::vector<app::Token> tokens_;
+};
+
+boost::json::object RunReplay(const ReplayArgs& args) {
+    auto config = json_loader::LoadConfig(args.config_file);
+    auto factory = std::make_shared<tools::CountingUnitOfWorkFactory>();
+    app::Application app(std::make_shared<app::Players>(),
+                         std::move(config.game),
+                         std::move(config.loot_generator),
+                         std::move(config.loot_handler),
+                         std::move(config.loot_number_map_handler),
+                         args.is_random_spawn_point, factory);
+    app.MakeCheckpoint(args.seed);
+
+    serialization::RecordingReader reader(args.recording);
+    Replayer replayer(app);
+    std::array<RouteStats, ROUTES_COUNT> stats;
+    std::uint64_t requests = 0;
+
+    const auto start = Clock::now();
+    while (auto request = reader.Next()) {
+        const auto due = start + request->time;
+        if (!args.as_fast_as_possible) {
+            std::this_thread::sleep_until(due);
+        }
+
+        const auto begin = Clock::now();
+        const bool is_ok = replayer.Apply(*request);
+        const auto end = Clock::now();
+
+        auto& route_stats = stats[static_cast<size_t>(request->route)];
+        route_stats.service.Record(end - begin);
+        if (!args.as_fast_as_possible) {
+            route_stats.corrected.Record(end - due);
+        }
+        route_stats.errors += is_ok ? 0 : 1;
+        ++requests;
+    }
+    const auto elapsed =
+        std::chrono::duration<double>(Clock::now() - start).count();
+
+    boost::json::object routes;
+    for (size_t i = 0; i < stats.size(); ++i) {
+        if (stats[i].service.Count() == 0) {
+            continue;
+        }
+        boost::json::object route{
+            {"errors", stats[i].errors},
+            {"serviceMs", HistogramToJson(stats[i].service)}};
+        if (!args.as_fast_as_possible) {
+            route["correctedMs"] = HistogramToJson(stats[i].corrected);
+        }
+        const std::string name{
+            serialization::RouteName(static_cast<RecordedRoute>(i))};
+        routes[name] = std::move(route);
+    }
+
+    return boost::json::object{
+        {"config",
+         {{"configFile", args.config_file},
+          {"recording", args.recording},
+          {"fast", args.as_fast_as_possible},
+          {"seed", args.seed}}},
+        {"requests", requests},
+        {"elapsedSeconds", elapsed},
+        {"retired", factory->GetRetiredCount()},
+        {"routes", routes}};
+}
+
+}  // namespace
+
+int main(int argc, const char* argv[]) {
+    try {
+        auto args = ParseReplayArgs(argc, argv);
+        if (!args) {
+            return EXIT_SUCCESS;
+        }
+        std::cout << boost::json::serialize(RunReplay(*args)) << std::endl;
+    } catch (const std::exception& ex) {
+        std::cerr << ex.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,295 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <boost/json.hpp>
+#include <boost/program_options.hpp>
+
+#include "app/game/game.h"
+#include "app/game/game_session_handler.h"
+#include "app/player/players.h"
+#include "app/use_cases/game_tick_use_case.h"
+#include "app/use_cases/join_game_use_case.h"
+#include "app/use_cases/move_player.h"
+#include "counting_unit_of_work.h"
+#include "json_loader.h"
+
+namespace {
+
+std::atomic<size_t> allocations_count{0};
+
+}  // namespace
+
+void* operator new(std::size_t size) {
+    allocations_count.fetch_add(1, std::memory_order_relaxed);
+    if (void* ptr = std::malloc(size == 0 ? 1 : size)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+
+void operator delete(void* ptr, [[maybe_unused]] std::size_t size) noexcept {
+    std::free(ptr);
+}
+
+namespace {
+
+using namespace std::literals;
+
+struct BenchArgs {
+    std::string config_file;
+    int maps_count = 1;
+    int dogs_count = 100;
+    int ticks_count = 1000;
+    int tick_period = 50;
+    int turn_period = 20;
+    std::uint64_t seed = 42;
+};
+
+std::optional<BenchArgs> ParseBenchArgs(int argc, const char* argv[]) {
+    namespace po = boost::program_options;
+
+    BenchArgs args;
+    po::options_description desc("All options");
+    desc.add_options()("help,h", "produce help message")(
+        "config-file,c", po::value(&args.config_file)->value_name("file"s),
+        "set config file path")(
+        "maps,k", po::value(&args.maps_count)->default_value(1),
+        "number of maps, config maps are cloned when needed")(
+        "dogs,n", po::value(&args.dogs_count)->default_value(100),
+        "number of dogs joined round-robin across maps")(
+        "ticks,m", po::value(&args.ticks_count)->default_value(1000),
+        "number of simulated ticks")(
+        "tick-period,t",
+        po::value(&args.tick_period)->default_value(50)->value_name(
+            "milliseconds"s),
+        "simulated tick period")(
+        "turn-period", po::value(&args.turn_period)->default_value(20),
+        "number of ticks between scripted direction changes")(
+        "seed", po::value(&args.seed)->default_value(42),
+        "seed for scripted directions and loot generation");
+
+    po::variables_map vm;
+    po::store(po::parse_command_line(argc, argv, desc), vm);
+    po::notify(vm);
+
+    if (vm.count("help")) {
+        std::cout << desc << std::endl;
+        return std::nullopt;
+    }
+
+    if (!vm.count("config-file")) {
+        throw std::invalid_argument("Config file path is not set"s);
+    }
+
+    if (args.maps_count <= 0 || args.dogs_count < 0 || args.ticks_count <= 0 ||
+        args.tick_period <= 0 || args.turn_period <= 0) {
+        throw std::invalid_argument("Bench sizes must be positive"s);
+    }
+
+    return args;
+}
+
+struct BenchWorld {
+    app::Game::Pointer game;
+    LootHandler::Pointer loot_handler;
+};
+
+// Builds a game with exactly maps_count maps. Maps from the config are used
+// first, the rest are clones of them with suffixed ids.
+BenchWorld MakeWorld(const BenchArgs& args,
+                     const json_loader::Config& config) {
+    const auto& config_game = config.game;
+    const auto& config_loot_handler = config.loot_handler;
+    const auto& config_maps = config_game->GetMaps();
+    if (config_maps.empty()) {
+        throw std::invalid_argument("Config does not contain maps"s);
+    }
+
+    app::Game::Maps maps;
+    LootHandler::LootTypeByMap loot_types;
+    LootHandler::LootTypeScoreByMap loot_scores;
+    for (int i = 0; i < args.maps_count; ++i) {
+        const auto& base = config_maps[i % config_maps.size()];
+        model::Map::Id id = base->GetId();
+        if (static_cast<size_t>(i) >= config_maps.size()) {
+            id = model::Map::Id{*base->GetId() + "_" + std::to_string(i)};
+        }
+
+        maps.push_back(std::make_shared<model::Map>(
+            id, base->GetName(), base->GetRoads(), base->GetBuildings(),
+            base->GetOffices(), base->GetMaxSpeed(),
+            base->GetNumberOfLootTypes()));
+
+        loot_types.emplace(id, config_loot_handler->FindLootType(base->GetId())
+                                   .value_or(boost::json::array{}));
+        auto& scores = loot_scores[id];
+        for (int type = 0; type <= base->GetNumberOfLootTypes(); ++type) {
+            scores.push_back(
+                config_loot_handler->FindValueByLootType(base->GetId(), type));
+        }
+    }
+
+    return {.game = std::make_shared<app::Game>(
+                std::move(maps), config_game->GetDefaultDogSpeed(),
+                std::make_shared<app::GameSessionHandler>(),
+                config_game->GetDogRetirementTime()),
+            .loot_handler = std::make_shared<LootHandler>(
+                std::move(loot_types), std::move(loot_scores))};
+}
+
+struct PhaseTimings {
+    std::vector<double> total, move_players, generate_loot, check_afk;
+
+    void Reserve(size_t count) {
+        total.reserve(count);
+        move_players.reserve(count);
+        generate_loot.reserve(count);
+        check_afk.reserve(count);
+    }
+};
+
+double ToMilliseconds(std::chrono::nanoseconds duration) {
+    return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+boost::json::object Summarize(std::vector<double> samples) {
+    std::sort(samples.begin(), samples.end());
+    auto percentile = [&samples](double p) {
+        auto idx = static_cast<size_t>(p * (samples.size() - 1));
+        return samples[idx];
+    };
+    double sum = 0.0;
+    for (double sample : samples) {
+        sum += sample;
+    }
+    return boost::json::object{{"mean", sum / samples.size()},
+                               {"p50", percentile(0.5)},
+                               {"p90", percentile(0.9)},
+                               {"p99", percentile(0.99)},
+                               {"max", samples.back()}};
+}
+
+boost::json::object RunBench(const BenchArgs& args) {
+    const auto config = json_loader::LoadConfig(args.config_file);
+    auto world = MakeWorld(args, config);
+    auto players = std::make_shared<app::Players>();
+    auto factory = std::make_shared<tools::CountingUnitOfWorkFactory>();
+
+    std::mt19937_64 random_engine{args.seed};
+
+    app::JoinGameUseCase join_use_case(world.game, players, true);
+    MovePlayerUseCase move_use_case(players);
+    GameTickUseCase tick_use_case(
+        world.game, players, config.loot_generator, world.loot_handler,
+        config.loot_number_map_handler, factory, true, args.seed);
+
+    std::vector<app::Token> tokens;
+    tokens.reserve(args.dogs_count);
+    const auto& maps = world.game->GetMaps();
+    for (int i = 0; i < args.dogs_count; ++i) {
+        tokens.push_back(
+            join_use_case
+                .Join(maps[i % maps.size()]->GetId(),
+                      "bench_dog_" + std::to_string(i))
+                .token);
+    }
+
+    static constexpr model::Direction DIRECTIONS[] = {
+        model::Direction::NORTH, model::Direction::SOUTH,
+        model::Direction::WEST, model::Direction::EAST, model::Direction::NONE};
+    std::uniform_int_distribution<size_t> direction_distribution(
+        0, std::size(DIRECTIONS) - 1);
+
+    PhaseTimings timings;
+    timings.Reserve(args.ticks_count);
+    size_t gather_events = 0;
+    size_t generated_loot = 0;
+    size_t tick_allocations = 0;
+    const std::chrono::milliseconds tick_period{args.tick_period};
+
+    for (int tick = 0; tick < args.ticks_count; ++tick) {
+        if (tick % args.turn_period == 0) {
+            for (const auto& token : tokens) {
+                if (players->Find(token)) {
+                    auto direction =
+                        DIRECTIONS[direction_distribution(random_engine)];
+                    move_use_case.MovePlayer(token, direction);
+                }
+            }
+        }
+
+        auto allocations_before =
+            allocations_count.load(std::memory_order_relaxed);
+        auto start = std::chrono::steady_clock::now();
+        tick_use_case.Tick(tick_period);
+        auto finish = std::chrono::steady_clock::now();
+        tick_allocations +=
+            allocations_count.load(std::memory_order_relaxed) -
+            allocations_before;
+
+        const auto& stats = tick_use_case.GetLastTickStats();
+        timings.total.push_back(ToMilliseconds(finish - start));
+        timings.move_players.push_back(ToMilliseconds(stats.move_players));
+        timings.generate_loot.push_back(ToMilliseconds(stats.generate_loot));
+        timings.check_afk.push_back(ToMilliseconds(stats.check_afk));
+        gather_events += stats.gather_events;
+        generated_loot += stats.generated_loot;
+    }
+
+    double total_seconds = 0.0;
+    for (double tick_ms : timings.total) {
+        total_seconds += tick_ms / 1000.0;
+    }
+    const size_t events =
+        gather_events + generated_loot + factory->GetRetiredCount();
+
+    return boost::json::object{
+        {"config",
+         {{"configFile", args.config_file},
+          {"maps", args.maps_count},
+          {"dogs", args.dogs_count},
+          {"ticks", args.ticks_count},
+          {"tickPeriod", args.tick_period},
+          {"turnPeriod", args.turn_period},
+          {"seed", args.seed}}},
+        {"tickMs", Summarize(timings.total)},
+        {"phasesMs",
+         {{"movePlayers", Summarize(timings.move_players)},
+          {"generateLoot", Summarize(timings.generate_loot)},
+          {"checkAfk", Summarize(timings.check_afk)}}},
+        {"allocationsPerTick",
+         static_cast<double>(tick_allocations) / args.ticks_count},
+        {"events",
+         {{"gather", gather_events},
+          {"generatedLoot", generated_loot},
+          {"retired", factory->GetRetiredCount()}}},
+        {"eventsPerSecond", total_seconds > 0 ? events / total_seconds : 0.0},
+        {"ticksPerSecond",
+         total_seconds > 0 ? args.ticks_count / total_seconds : 0.0}};
+}
+
+}  // namespace
+
+int main(int argc, const char* argv[]) {
+    try {
+        auto args = ParseBenchArgs(argc, argv);
+        if (!args) {
+            return EXIT_SUCCESS;
+        }
+        std::cout << boost::json::serialize(RunBench(*args)) << std::endl;
+    } catch (const std::exception& ex) {
+        std::cerr << ex.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
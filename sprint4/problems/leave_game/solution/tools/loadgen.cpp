@@ -0,0 +1,427 @@
+#include <array>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <boost/asio/strand.hpp>
+#include <boost/beast/core.hpp>
+#include <boost/beast/http.hpp>
+#include <boost/json.hpp>
+#include <boost/program_options.hpp>
+
+#include "utils/latency_histogram.h"
+
+namespace {
+
+namespace net = boost::asio;
+namespace beast = boost::beast;
+namespace http = beast::http;
+namespace sys = boost::system;
+using tcp = net::ip::tcp;
+using Clock = std::chrono::steady_clock;
+using namespace std::literals;
+
+struct LoadArgs {
+    std::string host = "127.0.0.1";
+    std::string port = "8080";
+    std::string map_id = "map1";
+    int connections = 16;
+    int threads = 1;
+    double rate = 1000.0;
+    int duration = 10;
+    int records_every = 50;
+    std::uint64_t seed = 42;
+    // Accept header of state, players and records requests
+    std::string accept;
+};
+
+std::optional<LoadArgs> ParseLoadArgs(int argc, const char* argv[]) {
+    namespace po = boost::program_options;
+
+    LoadArgs args;
+    po::options_description desc("All options");
+    desc.add_options()("help,h", "produce help message")(
+        "host", po::value(&args.host)->default_value(args.host),
+        "server address")("port,p",
+                          po::value(&args.port)->default_value(args.port),
+                          "server port")(
+        "map", po::value(&args.map_id)->default_value(args.map_id),
+        "map id used to join the game")(
+        "connections,c",
+        po::value(&args.connections)->default_value(args.connections),
+        "number of keep-alive connections, one player per connection")(
+        "threads,t", po::value(&args.threads)->default_value(args.threads),
+        "number of io threads")(
+        "rate,r", po::value(&args.rate)->default_value(args.rate),
+        "total request rate per second (open loop)")(
+        "duration,d", po::value(&args.duration)->default_value(args.duration),
+        "test duration in seconds")(
+        "records-every",
+        po::value(&args.records_every)->default_value(args.records_every),
+        "read records once per N action/state/players cycles, 0 disables")(
+        "seed", po::value(&args.seed)->default_value(args.seed),
+        "seed for scripted player directions")(
+        "accept", po::value(&args.accept)->value_name("media-type"s),
+        "Accept header of read requests, e.g. application/cbor");
+
+    po::variables_map vm;
+    po::store(po::parse_command_line(argc, argv, desc), vm);
+    po::notify(vm);
+
+    if (vm.count("help")) {
+        std::cout << desc << std::endl;
+        return std::nullopt;
+    }
+
+    if (args.connections <= 0 || args.threads <= 0 || args.rate <= 0 ||
+        args.duration <= 0 || args.records_every < 0) {
+        throw std::invalid_argument("Load parameters must be positive"s);
+    }
+
+    return args;
+}
+
+enum class Route { Join, Action, State, Players, Records, Count };
+
+constexpr std::array<const char*, static_cast<size_t>(Route::Count)>
+    ROUTE_NAMES = {"join", "action", "state", "players", "records"};
+
+struct RouteStats {
+    // Latency measured from the moment the request was actually written
+    utils::LatencyHistogram service;
+    // Latency measured from the moment the request was scheduled to be sent,
+    // which includes the time it waited behind earlier slow responses
+    // (coordinated omission correction for the open-loop schedule)
+    utils::LatencyHistogram corrected;
+    std::uint64_t errors = 0;
+
+    void Merge(const RouteStats& other) {
+        service.Merge(other.service);
+        corrected.Merge(other.corrected);
+        errors += other.errors;
+    }
+};
+
+using Stats = std::array<RouteStats, static_cast<size_t>(Route::Count)>;
+
+// One player driven over one keep-alive connection. Requests follow a fixed
+// open-loop schedule: request k of connection i is due at
+// start + (i + k * connections) / rate, independently of server responses.
+class Client : public std::enable_shared_from_this<Client> {
+   public:
+    Client(net::io_context& ioc, const tcp::resolver::results_type& endpoints,
+           const LoadArgs& args, int index, Clock::time_point start,
+           Clock::time_point finish)
+        : stream_(net::make_strand(ioc)),
+          timer_(stream_.get_executor()),
+          endpoints_(endpoints),
+          args_(args),
+          index_(index),
+          start_(start),
+          finish_(finish),
+          interval_(std::chrono::duration_cast<Clock::duration>(
+              std::chrono::duration<double>(args.connections / args.rate))),
+          random_engine_(args.seed + index) {}
+
+    void Run() { Connect(); }
+
+    const Stats& GetStats() const noexcept { return stats_; }
+
+   private:
+    beast::tcp_stream stream_;
+    net::steady_timer timer_;
+    tcp::resolver::results_type endpoints_;
+    const LoadArgs& args_;
+    int index_;
+    Clock::time_point start_;
+    Clock::time_point finish_;
+    Clock::duration interval_;
+    std::mt19937_64 random_engine_;
+
+    beast::flat_buffer buffer_;
+    http::request<http::string_body> request_;
+    http::response<http::string_body> response_;
+
+    std::uint64_t sequence_ = 0;
+    std::uint64_t cycle_step_ = 0;
+    std::optional<std::string> token_;
+    Route route_ = Route::Join;
+    Clock::time_point intended_;
+    Clock::time_point sent_;
+    Stats stats_;
+
+    Clock::time_point NextIntendedTime() const {
+        auto offset = std::chrono::duration_cast<Clock::duration>(
+            std::chrono::duration<double>(index_ / args_.rate));
+        return start_ + offset + interval_ * sequence_;
+    }
+
+    void Connect() {
+        stream_.async_connect(
+            endpoints_,
+            [self = shared_from_this()](
+                sys::error_code ec,
+                [[maybe_unused]] const tcp::endpoint& endpoint) {
+                if (ec) {
+                    std::cerr << "connect: " << ec.message() << std::endl;
+                    return;
+                }
+                self->ScheduleNext();
+            });
+    }
+
+    void ScheduleNext() {
+        intended_ = NextIntendedTime();
+        if (intended_ >= finish_) {
+            beast::error_code ec;
+            stream_.socket().shutdown(tcp::socket::shutdown_both, ec);
+            return;
+        }
+        ++sequence_;
+        timer_.expires_at(intended_);
+        timer_.async_wait([self = shared_from_this()](sys::error_code ec) {
+            if (!ec) {
+                self->Send();
+            }
+        });
+    }
+
+    Route NextRoute() {
+        if (!token_) {
+            return Route::Join;
+        }
+        static constexpr std::array CYCLE = {Route::Action, Route::State,
+                                             Route::Players};
+        const auto cycle_length = CYCLE.size() + (args_.records_every ? 1 : 0);
+        const auto cycle = cycle_step_ / cycle_length;
+        const auto step = cycle_step_ % cycle_length;
+        ++cycle_step_;
+        if (step == CYCLE.size()) {
+            return cycle % args_.records_every == 0 ? Route::Records
+                                                    : CYCLE.front();
+        }
+        return CYCLE[step];
+    }
+
+    void PrepareRequest(Route route) {
+        static constexpr std::array DIRECTIONS = {"U", "D", "L", "R", ""};
+
+        request_ = {};
+        request_.version(11);
+        request_.keep_alive(true);
+        request_.set(http::field::host, args_.host);
+        if (token_) {
+            request_.set(http::field::authorization, "Bearer " + *token_);
+        }
+        if (!args_.accept.empty() && route != Route::Join &&
+            route != Route::Action) {
+            request_.set(http::field::accept, args_.accept);
+        }
+
+        switch (route) {
+            case Route::Join:
+                request_.method(http::verb::post);
+                request_.target("/api/v1/game/join");
+                request_.set(http::field::content_type, "application/json");
+                request_.body() = boost::json::serialize(boost::json::object{
+                    {"userName", "loadgen_" + std::to_string(index_)},
+                    {"mapId", args_.map_id}});
+                break;
+            case Route::Action: {
+                std::uniform_int_distribution<size_t> distribution(
+                    0, DIRECTIONS.size() - 1);
+                request_.method(http::verb::post);
+                request_.target("/api/v1/game/player/action");
+                request_.set(http::field::content_type, "application/json");
+                request_.body() = boost::json::serialize(boost::json::object{
+                    {"move", DIRECTIONS[distribution(random_engine_)]}});
+                break;
+            }
+            case Route::State:
+                request_.method(http::verb::get);
+                request_.target("/api/v1/game/state");
+                break;
+            case Route::Players:
+                request_.method(http::verb::get);
+                request_.target("/api/v1/game/players");
+                break;
+            case Route::Records:
+                request_.method(http::verb::get);
+                request_.target("/api/v1/game/records?start=0&maxItems=100");
+                break;
+            case Route::Count:
+                break;
+        }
+        request_.prepare_payload();
+    }
+
+    void Send() {
+        route_ = NextRoute();
+        PrepareRequest(route_);
+        sent_ = Clock::now();
+        http::async_write(
+            stream_, request_,
+            [self = shared_from_this()](
+                beast::error_code ec,
+                [[maybe_unused]] std::size_t bytes_written) {
+                if (ec) {
+                    return self->OnFailure(ec);
+                }
+                self->Read();
+            });
+    }
+
+    void Read() {
+        response_ = {};
+        http::async_read(
+            stream_, buffer_, response_,
+            [self = shared_from_this()](
+                beast::error_code ec, [[maybe_unused]] std::size_t bytes_read) {
+                if (ec) {
+                    return self->OnFailure(ec);
+                }
+                self->OnResponse();
+            });
+    }
+
+    void OnResponse() {
+        auto now = Clock::now();
+        auto& stats = stats_[static_cast<size_t>(route_)];
+        stats.service.Record(now - sent_);
+        stats.corrected.Record(now - intended_);
+
+        if (response_.result() != http::status::ok) {
+            ++stats.errors;
+        } else if (route_ == Route::Join) {
+            boost::system::error_code ec;
+            auto answer = boost::json::parse(response_.body(), ec);
+            if (!ec && answer.is_object()) {
+                if (auto token = answer.as_object().if_contains("authToken")) {
+                    token_ = std::string(token->as_string().c_str());
+                }
+            }
+        }
+
+        if (!response_.keep_alive()) {
+            return Reconnect();
+        }
+        ScheduleNext();
+    }
+
+    void OnFailure(beast::error_code ec) {
+        ++stats_[static_cast<size_t>(route_)].errors;
+        if (ec == net::error::operation_aborted) {
+            return;
+        }
+        Reconnect();
+    }
+
+    void Reconnect() {
+        beast::error_code ec;
+        stream_.socket().close(ec);
+        buffer_.clear();
+        Connect();
+    }
+};
+
+boost::json::object HistogramToJson(const utils::LatencyHistogram& histogram) {
+    auto ms = [](utils::LatencyHistogram::Duration value) {
+        return std::chrono::duration<double, std::milli>(value).count();
+    };
+    return boost::json::object{
+        {"count", histogram.Count()},
+        {"mean", ms(histogram.Mean())},
+        {"p50", ms(histogram.ValueAtPercentile(50))},
+        {"p90", ms(histogram.ValueAtPercentile(90))},
+        {"p99", ms(histogram.ValueAtPercentile(99))},
+        {"p99.9", ms(histogram.ValueAtPercentile(99.9))},
+        {"p99.99", ms(histogram.ValueAtPercentile(99.99))},
+        {"max", ms(histogram.Max())}};
+}
+
+boost::json::object RouteStatsToJson(const RouteStats& stats) {
+    return boost::json::object{{"errors", stats.errors},
+                               {"serviceMs", HistogramToJson(stats.service)},
+                               {"correctedMs",
+                                HistogramToJson(stats.corrected)}};
+}
+
+boost::json::object RunLoad(const LoadArgs& args) {
+    net::io_context ioc(args.threads);
+    tcp::resolver resolver(ioc);
+    auto endpoints = resolver.resolve(args.host, args.port);
+
+    auto start = Clock::now() + 100ms;
+    auto finish = start + std::chrono::seconds(args.duration);
+
+    std::vector<std::shared_ptr<Client>> clients;
+    clients.reserve(args.connections);
+    for (int i = 0; i < args.connections; ++i) {
+        clients.push_back(
+            std::make_shared<Client>(ioc, endpoints, args, i, start, finish));
+        clients.back()->Run();
+    }
+
+    std::vector<std::jthread> workers;
+    workers.reserve(args.threads - 1);
+    for (int i = 1; i < args.threads; ++i) {
+        workers.emplace_back([&ioc] { ioc.run(); });
+    }
+    ioc.run();
+    workers.clear();
+    auto elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+
+    Stats stats;
+    for (const auto& client : clients) {
+        for (size_t i = 0; i < stats.size(); ++i) {
+            stats[i].Merge(client->GetStats()[i]);
+        }
+    }
+
+    RouteStats total;
+    boost::json::object routes;
+    for (size_t i = 0; i < stats.size(); ++i) {
+        total.Merge(stats[i]);
+        routes[ROUTE_NAMES[i]] = RouteStatsToJson(stats[i]);
+    }
+
+    return boost::json::object{
+        {"config",
+         {{"host", args.host},
+          {"port", args.port},
+          {"map", args.map_id},
+          {"connections", args.connections},
+          {"threads", args.threads},
+          {"rate", args.rate},
+          {"duration", args.duration},
+          {"recordsEvery", args.records_every}}},
+        {"requests", total.service.Count()},
+        {"achievedRate", total.service.Count() / elapsed},
+        {"total", RouteStatsToJson(total)},
+        {"routes", routes}};
+}
+
+}  // namespace
+
+int main(int argc, const char* argv[]) {
+    try {
+        auto args = ParseLoadArgs(argc, argv);
+        if (!args) {
+            return EXIT_SUCCESS;
+        }
+        std::cout << boost::json::serialize(RunLoad(*args)) << std::endl;
+    } catch (const std::exception& ex) {
+        std::cerr << ex.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}